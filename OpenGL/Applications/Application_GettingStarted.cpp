@@ -3,61 +3,28 @@
 //-------------------------------------------------------------------
 
 #include <glad/glad.h>
-#include <stb/stb_image.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cmath>
 #include <iostream>
 
-#include "wtypes.h"
+#include "../Graphics/GpuProfiler.hpp"
+
 using namespace std;
 
 //-------------------------------------------------------------------
 
 namespace Applications
 {
-	Application_GettingStarted::Application_GettingStarted()
-		: boxTexture(0), faceTexture(0)
+	Application_GettingStarted::Application_GettingStarted(const Utils::WindowBackend backend)
 	{
-		RECT desktop;
-		// Get a handle to the desktop window
-		const auto hDesktop = GetDesktopWindow();
-		// Get the size of screen to the variable desktop
-		GetWindowRect(hDesktop, &desktop);
-		// The top left corner will have coordinates (0,0)
-		// and the bottom right corner will have coordinates
-		// (horizontal, vertical)
-		auto horizontal = desktop.right;
-		auto vertical = desktop.bottom;
-
-		window = std::make_unique<Utils::Window>("LearnOpenGL", horizontal, vertical);
-	}
-
-	//-------------------------------------------------------------------
-
-	void Application_GettingStarted::Run()
-	{
-		Initialize();
-		LoadContent();
-
-		auto lastFrame = 0.0f; // Time of last frame
-
-		// Render loop, each iteration is a frame
-		while (!window->GetShouldClose())
-		{
-			const auto currentFrame = window->GetElapsedTime();
-			const auto deltaTime = currentFrame - lastFrame; // Time between frames
-			lastFrame = currentFrame;
+		// Fill the whole primary display
+		const auto desktopSize = Utils::Window::GetDesktopSize(backend);
 
-			Update(deltaTime);
-			Render();
-
-			window->SwapBuffers();
-			window->PollEvents();
-		}
-
-		UnloadContent();
+		window = Utils::Window::Create(backend, "LearnOpenGL", desktopSize.x, desktopSize.y);
 	}
 
 	//-------------------------------------------------------------------
@@ -66,8 +33,8 @@ namespace Applications
 	{
 		window->ActivateInputFor(this);
 		camera = std::make_unique<Utils::Camera3D>(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 1.0f, 0.0f), 45.0f);
-
-		stbi_set_flip_vertically_on_load(true);
+		threadPool = std::make_unique<Utils::ThreadPool>();
+		commandQueue = std::make_unique<Graphics::CommandQueue>();
 
 		glEnable(GL_DEPTH_TEST);
 	}
@@ -80,62 +47,13 @@ namespace Applications
 		// Textures
 		//
 
-		glGenTextures(1, &boxTexture);
-		glBindTexture(GL_TEXTURE_2D, boxTexture);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		int width, height, channels;
-		std::string texturePath = "Content/Textures/container.jpg";
-
-		auto data = stbi_load(texturePath.c_str(), &width, &height, &channels, 0);
-
-		if (data)
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-			glGenerateMipmap(GL_TEXTURE_2D);
-			glBindTexture(GL_TEXTURE_2D, 0);
-		}
-		else
-		{
-			std::string errorMessage = "Failed to load texture: ";
-			errorMessage.append(texturePath);
-
-			throw std::exception(errorMessage.c_str());
-		}
-
-		stbi_image_free(data);
-
-		glGenTextures(1, &faceTexture);
-		glBindTexture(GL_TEXTURE_2D, faceTexture);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		texturePath = "Content/Textures/awesomeface.png";
-
-		auto facedata = stbi_load(texturePath.c_str(), &width, &height, &channels, 0);
-
-		if (facedata)
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, facedata);
-			glGenerateMipmap(GL_TEXTURE_2D);
-			glBindTexture(GL_TEXTURE_2D, 0);
-		}
-		else
-		{
-			std::string errorMessage = "Failed to load texture: ";
-			errorMessage.append(texturePath);
-
-			throw std::exception(errorMessage.c_str());
-		}
+		const auto textures = textureCache.Load({
+			{ "Content/Textures/container.jpg", {} },
+			{ "Content/Textures/awesomeface.png", {} }
+		}, *threadPool);
 
-		stbi_image_free(facedata);
+		boxTexture = textures[0];
+		faceTexture = textures[1];
 
 		//
 		// Buffers
@@ -203,8 +121,8 @@ namespace Applications
 		//	1, 2, 3    // second triangle
 		//};
 
-		va = std::make_unique<Graphics::VertexArray>();
-		auto vb = std::make_unique<Graphics::VertexBuffer>(vertices, sizeof(vertices));
+		va = std::make_unique<Graphics::VertexArray>("cube");
+		auto vb = std::make_unique<Graphics::VertexBuffer>(vertices, sizeof(vertices), "cube vertices");
 
 		vb->SetAttributes({
 			{"aPos", Graphics::VertexAttributeType::VEC3F},
@@ -234,12 +152,13 @@ namespace Applications
 
 	void Application_GettingStarted::UnloadContent()
 	{
-		glDeleteTextures(1, &boxTexture);
-		glDeleteTextures(1, &faceTexture);
+		boxTexture = nullptr;
+		faceTexture = nullptr;
 
 		va = nullptr;
 		shader = nullptr;
-		window = nullptr;
+		commandQueue = nullptr;
+		threadPool = nullptr;
 	}
 
 	//-------------------------------------------------------------------
@@ -267,21 +186,8 @@ namespace Applications
 
 	//-------------------------------------------------------------------
 
-	void Application_GettingStarted::Render() const
+	void Application_GettingStarted::BuildFramePacket(Utils::FramePacket& packet) const
 	{
-		glClearColor(0.393f, 0.585f, 0.930f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		//Begin draw
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, boxTexture);
-
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, faceTexture);
-
-		va->Bind();
-		shader->Use();
-
 		constexpr glm::vec3 cubePositions[] =
 		{
 			glm::vec3(0.0f, 0.0f, 0.0f),
@@ -296,26 +202,68 @@ namespace Applications
 			glm::vec3(-1.3f, 1.0f, -1.5f)
 		};
 
-		auto view = camera->GetViewMatrix();
-
 		const auto windowSize = window->GetSize();
 
-		const auto projection = glm::perspective(
-			glm::radians(camera->GetZoom()), windowSize.x / windowSize.y, 0.1f, 100.0f);
+		packet.view = camera->GetInterpolatedViewMatrix(packet.interpolation);
+		packet.projection = glm::perspective(
+			glm::radians(camera->GetInterpolatedZoom(packet.interpolation)), windowSize.x / windowSize.y, 0.1f, 100.0f);
+		packet.viewPosition = camera->GetInterpolatedPosition(packet.interpolation);
 
-		shader->SetMat4f("view", view);
-		shader->SetMat4f("projection", projection);
-
-		for (auto i = 0; i < 10; i++)
+		for (const auto& cubePosition : cubePositions)
 		{
 			auto model = glm::mat4(1.0f);
-			model = glm::translate(model, cubePositions[i]);
-			
-			model = glm::rotate(model, window->GetElapsedTime() * glm::radians(20.0f * cubePositions[i].z), glm::vec3(1.0f, 0.3f, 0.5f));
+			model = glm::translate(model, cubePosition);
+
+			// Wrapped in double precision so the angle stays exact however long the session runs
+			const auto angle = std::fmod(packet.elapsedTime * glm::radians(20.0 * cubePosition.z), glm::two_pi<double>());
+
+			model = glm::rotate(model, static_cast<float>(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+
+			packet.transforms.push_back(model);
+		}
+	}
+
+	//-------------------------------------------------------------------
 
-			shader->SetMat4f("model", model);
+	void Application_GettingStarted::Render(const Utils::FramePacket& packet) const
+	{
+		glClearColor(0.393f, 0.585f, 0.930f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		//Begin draw
+
+		// Shared state is replayed first (key 0), the cubes are recorded on the
+		// thread pool and replayed after it in chunk order
+		Graphics::CommandList setup;
+
+		setup.UseProgram(*shader);
+		setup.BindVertexArray(*va);
+		setup.BindTexture(0, *boxTexture);
+		setup.BindTexture(1, *faceTexture);
+		setup.SetMat4f(*shader, "view", packet.view);
+		setup.SetMat4f(*shader, "projection", packet.projection);
+
+		commandQueue->Submit(0, std::move(setup));
+
+		const auto modelLocation = shader->GetUniformLocation("model");
+
+		threadPool->ParallelFor(packet.transforms.size(), [&](const size_t chunk, const size_t begin, const size_t end)
+		{
+			Graphics::CommandList cubes;
+
+			for (auto i = begin; i < end; i++)
+			{
+				cubes.SetMat4f(modelLocation, packet.transforms[i]);
+				cubes.DrawArrays(GL_TRIANGLES, 0, 36);
+			}
+
+			commandQueue->Submit(static_cast<unsigned>(chunk) + 1, std::move(cubes));
+		});
+
+		{
+			const Graphics::GpuZone zone("cubes");
 
-			glDrawArrays(GL_TRIANGLES, 0, 36);
+			commandQueue->Execute();
 		}
 
 		//glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
@@ -7,10 +7,11 @@
 //-------------------------------------------------------------------
 
 #include "IApplication.hpp"
-#include "../Utils/Window.hpp"
+#include "../Graphics/CommandQueue.hpp"
 #include "../Graphics/ShaderProgram.hpp"
+#include "../Graphics/Texture.hpp"
 #include "../Graphics/VertexArray.hpp"
-#include "../Utils/Camera3D.hpp"
+#include "../Utils/ThreadPool.hpp"
 
 //-------------------------------------------------------------------
 
@@ -18,32 +19,24 @@ namespace Applications
 {
 	class Application_GettingStarted : public IApplication
 	{
-		unsigned int boxTexture;
-		unsigned int faceTexture;
+		std::shared_ptr<Graphics::Texture> boxTexture;
+		std::shared_ptr<Graphics::Texture> faceTexture;
 
 	protected:
-		Input::InputManager inputManager;
-
-		std::unique_ptr<Utils::Window> window;
-		std::unique_ptr<Utils::Camera3D> camera;
 		std::unique_ptr<Graphics::ShaderProgram> shader;
 		std::unique_ptr<Graphics::VertexArray> va;
+		std::unique_ptr<Utils::ThreadPool> threadPool;
+		std::unique_ptr<Graphics::CommandQueue> commandQueue;
 
-		void Initialize();
-		void LoadContent();
-		void UnloadContent();
-		void Update(float deltaTime);
-		void Render() const;
+		void Initialize() override;
+		void LoadContent() override;
+		void UnloadContent() override;
+		void Update(float deltaTime) override;
+		void BuildFramePacket(Utils::FramePacket& packet) const override;
+		void Render(const Utils::FramePacket& packet) const override;
 
 	public:
-		Application_GettingStarted();
-
-		void Run();
-
-		Input::InputManager& GetInputManager() override
-		{
-			return inputManager;
-		}
+		explicit Application_GettingStarted(Utils::WindowBackend backend = Utils::WindowBackend::GLFW);
 	};
 
 }
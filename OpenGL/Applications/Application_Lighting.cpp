@@ -1,39 +1,32 @@
 #include "Application_Lighting.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include <glad/glad.h>
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <stb/stb_image.h>
+
+#include "../Graphics/GpuProfiler.hpp"
+#include "../Utils/AssetPack.hpp"
 
 namespace Applications
 {
-	Application_Lighting::Application_Lighting()
-		: lightPos(1.2f, 1.0f, 1.0f), boxDiffuseMap(0), boxSpecularMap(0), boxEmissionMap(0)
+	namespace
 	{
-		window = std::make_unique<Utils::Window>("TU.CG.Lab", 800, 600);
+		// Of the sphere around the unit box
+		const float BOX_RADIUS = std::sqrt(3.0f) / 2.0f;
+
+		// Where the pack tool writes the box maps, which share their size and channel count
+		constexpr auto BOX_MAPS_ATLAS = "Content/Textures/Packed/array_rgba_500x500.atlas";
+		constexpr auto BOX_DIFFUSE_MAP = "Content/Textures/container2.png";
+		constexpr auto BOX_SPECULAR_MAP = "Content/Textures/container2_specular.png";
 	}
 
-	void Application_Lighting::Run()
+	Application_Lighting::Application_Lighting(const Utils::WindowBackend backend)
+		: lightPos(1.2f, 1.0f, 1.0f)
 	{
-		auto lastFrame = 0.0f;
-
-		Initialize();
-		LoadContent();
-
-		while (!window->GetShouldClose())
-		{
-			const auto currentFrame = window->GetElapsedTime();
-			const auto deltaTime = currentFrame - lastFrame;
-			lastFrame = currentFrame;
-
-			Update(deltaTime);
-			Render();
-
-			window->SwapBuffers();
-			window->PollEvents();
-		}
-
-		UnloadContent();
+		window = Utils::Window::Create(backend, "TU.CG.Lab", 800, 600);
 	}
 
 	void Application_Lighting::Initialize()
@@ -43,7 +36,7 @@ namespace Applications
 		camera = std::make_unique<Utils::Camera3D>(
 			glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 1.0f, 0.0f), 45.0f);
 
-		stbi_set_flip_vertically_on_load(true);
+		threadPool = std::make_unique<Utils::ThreadPool>();
 
 		glEnable(GL_DEPTH_TEST);
 	}
@@ -54,91 +47,47 @@ namespace Applications
 		// -- Textures
 		//
 
-		glGenTextures(1, &boxDiffuseMap);
-		glBindTexture(GL_TEXTURE_2D, boxDiffuseMap);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		int width, height, channels;
-		std::string texturePath = "Content/Textures/container2.png";
-		auto data = stbi_load(texturePath.c_str(), &width, &height, &channels, 0);
-
-		if (data)
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0,
-				GL_RGBA, GL_UNSIGNED_BYTE, data);
-
-			glGenerateMipmap(GL_TEXTURE_2D);
-			glBindTexture(GL_TEXTURE_2D, 0);
-		}
-		else
+		// Once packed, the diffuse and specular maps share a binding and are looked up through the
+		// atlas entries. The array holds every level, so it is not streamed.
+		if (Utils::AssetPack::Exists(BOX_MAPS_ATLAS))
 		{
-			std::string errorMessage = "Failed to load texture: ";
-			errorMessage.append(texturePath);
-			throw std::exception(errorMessage.c_str());
+			const auto atlas = Graphics::TextureAtlas::Load(BOX_MAPS_ATLAS);
+			const auto diffuseEntry = atlas.Find(BOX_DIFFUSE_MAP);
+			const auto specularEntry = atlas.Find(BOX_SPECULAR_MAP);
+
+			if (diffuseEntry != nullptr && specularEntry != nullptr)
+			{
+				boxMaps = atlas.CreateTextureArray({}, "box maps");
+				boxDiffuseEntry = *diffuseEntry;
+				boxSpecularEntry = *specularEntry;
+			}
 		}
 
-		stbi_image_free(data);
-
-		glGenTextures(1, &boxEmissionMap);
-		glBindTexture(GL_TEXTURE_2D, boxEmissionMap);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		texturePath = "Content/Textures/matrix.jpg";
-		data = stbi_load(texturePath.c_str(), &width, &height, &channels, 0);
-
-		if (data)
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0,
-				GL_RGB, GL_UNSIGNED_BYTE, data);
-
-			glGenerateMipmap(GL_TEXTURE_2D);
-			glBindTexture(GL_TEXTURE_2D, 0);
-		}
-		else
-		{
-			std::string errorMessage = "Failed to load texture: ";
-			errorMessage.append(texturePath);
-			throw std::exception(errorMessage.c_str());
-		}
-
-		stbi_image_free(data);
-
-		glGenTextures(1, &boxSpecularMap);
-		glBindTexture(GL_TEXTURE_2D, boxSpecularMap);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		texturePath = "Content/Textures/container2_specular.png";
-		data = stbi_load(texturePath.c_str(), &width, &height, &channels, 0);
-
-		if (data)
+		// Only their small levels are uploaded here, so the window shows up before the rest is on
+		// the GPU. Render requests the finer ones as the box gets closer.
+		if (boxMaps != nullptr)
 		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0,
-				GL_RGBA, GL_UNSIGNED_BYTE, data);
-
-			glGenerateMipmap(GL_TEXTURE_2D);
-			glBindTexture(GL_TEXTURE_2D, 0);
+			boxEmissionMap = textureCache.Load({
+				{ "Content/Textures/matrix.jpg", {} }
+			}, *threadPool, &GetTextureUploader(), &GetTextureStreamer())[0];
 		}
 		else
 		{
-			std::string errorMessage = "Failed to load texture: ";
-			errorMessage.append(texturePath);
-			throw std::exception(errorMessage.c_str());
+			// Specular intensities are data rather than sRGB color, their mipmaps average them as stored
+			Graphics::TextureSettings specularSettings;
+			specularSettings.isSrgb = false;
+
+			const auto textures = textureCache.Load({
+				{ BOX_DIFFUSE_MAP, {} },
+				{ "Content/Textures/matrix.jpg", {} },
+				{ BOX_SPECULAR_MAP, specularSettings }
+			}, *threadPool, &GetTextureUploader(), &GetTextureStreamer());
+
+			boxDiffuseMap = textures[0];
+			boxEmissionMap = textures[1];
+			boxSpecularMap = textures[2];
 		}
 
-		stbi_image_free(data);
-
 		//
 		// -- Buffers
 		//
@@ -234,10 +183,10 @@ namespace Applications
 			-0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
 		};
 
-		lightVa = std::make_unique<Graphics::VertexArray>();
+		lightVa = std::make_unique<Graphics::VertexArray>("light box");
 
 		auto lightVb = std::make_unique<Graphics::VertexBuffer>(
-			lightVertices, sizeof lightVertices
+			lightVertices, sizeof lightVertices, "light box vertices"
 			);
 
 		lightVb->SetAttributes({
@@ -246,10 +195,10 @@ namespace Applications
 
 		lightVa->SetVertexBuffer(std::move(lightVb));
 
-		objectVa = std::make_unique<Graphics::VertexArray>();
+		objectVa = std::make_unique<Graphics::VertexArray>("box");
 
 		auto objectVb = std::make_unique<Graphics::VertexBuffer>(
-			vertices, sizeof vertices
+			vertices, sizeof vertices, "box vertices"
 		);
 
 		objectVb->SetAttributes({
@@ -268,28 +217,41 @@ namespace Applications
 
 		objectShader = std::make_unique<Graphics::ShaderProgram>(
 			"Content/Shaders/lighting.vert",
-			"Content/Shaders/lighting.frag"
+			boxMaps != nullptr ? "Content/Shaders/lighting_packed.frag" : "Content/Shaders/lighting.frag"
 			);
 
 		objectShader->Use();
 
-		objectShader->SetInt("material.diffuse", 0);
-		objectShader->SetInt("material.specular", 1);
+		if (boxMaps != nullptr)
+		{
+			objectShader->SetInt("material.maps", 0);
+			objectShader->SetFloat("material.diffuse.layer", static_cast<float>(boxDiffuseEntry.layer));
+			objectShader->SetVec2f("material.diffuse.uvScale", boxDiffuseEntry.uvScale);
+			objectShader->SetVec2f("material.diffuse.uvOffset", boxDiffuseEntry.uvOffset);
+			objectShader->SetFloat("material.specular.layer", static_cast<float>(boxSpecularEntry.layer));
+			objectShader->SetVec2f("material.specular.uvScale", boxSpecularEntry.uvScale);
+			objectShader->SetVec2f("material.specular.uvOffset", boxSpecularEntry.uvOffset);
+		}
+		else
+		{
+			objectShader->SetInt("material.diffuse", 0);
+			objectShader->SetInt("material.specular", 1);
+		}
+
 		objectShader->SetInt("material.emission", 2);
 		objectShader->SetFloat("material.shininess", 32.0f);
-		objectShader->SetVec3f("light.position", lightPos);
-		objectShader->SetVec3f("light.ambient", glm::vec3(0.2f));
-		objectShader->SetVec3f("light.diffuse", glm::vec3(0.5f));
-		objectShader->SetVec3f("light.specular", glm::vec3(1.0f));
 
 		objectShader->Unuse();
 	}
 
 	void Application_Lighting::UnloadContent()
 	{
-		glDeleteTextures(1, &boxDiffuseMap);
-		glDeleteTextures(1, &boxSpecularMap);
-		glDeleteTextures(1, &boxEmissionMap);
+		boxDiffuseMap = nullptr;
+		boxSpecularMap = nullptr;
+		boxEmissionMap = nullptr;
+		boxMaps = nullptr;
+
+		threadPool = nullptr;
 
 		objectVa = nullptr;
 		objectShader = nullptr;
@@ -307,60 +269,94 @@ namespace Applications
 		inputManager.ResetState();
 	}
 
-	void Application_Lighting::Render() const
+	void Application_Lighting::BuildFramePacket(Utils::FramePacket& packet) const
 	{
-		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		auto model = glm::mat4(1.0f);
+		const auto windowSize = window->GetSize();
 
-		const auto view = camera->GetViewMatrix();
+		packet.view = camera->GetInterpolatedViewMatrix(packet.interpolation);
+		packet.projection = glm::perspective(
+			glm::radians(camera->GetInterpolatedZoom(packet.interpolation)), windowSize.x / windowSize.y, 0.1f, 100.0f);
+		packet.viewPosition = camera->GetInterpolatedPosition(packet.interpolation);
 
-		const auto windowSize = window->GetSize();
+		auto lightModel = glm::mat4(1.0f);
+		lightModel = glm::translate(lightModel, lightPos);
+		lightModel = glm::scale(lightModel, glm::vec3(0.2f));
 
-		const auto projection = glm::perspective(
-			glm::radians(camera->GetZoom()), windowSize.x / windowSize.y, 0.1f, 100.0f);
+		packet.transforms.push_back(glm::mat4(1.0f));
+		packet.transforms.push_back(lightModel);
 
-		const auto normalMatrix = glm::inverseTranspose(glm::mat3(model));
+		packet.lights.push_back({ lightPos, glm::vec3(0.2f), glm::vec3(0.5f), glm::vec3(1.0f) });
+	}
 
-		objectShader->Use();
-		objectVa->Bind();
+	void Application_Lighting::Render(const Utils::FramePacket& packet) const
+	{
+		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, boxDiffuseMap);
+		const auto& model = packet.transforms[0];
+		const auto& light = packet.lights[0];
 
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, boxSpecularMap);
+		const auto normalMatrix = glm::inverseTranspose(glm::mat3(model));
 
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_2D, boxEmissionMap);
+		// Each face of the unit box maps a whole texture, from its closest point on
+		const auto boxDistance = std::max(glm::length(packet.viewPosition - glm::vec3(model[3])) - BOX_RADIUS, 0.1f);
 
-		objectShader->SetMat4f("model", model);
-		objectShader->SetMat4f("view", view);
-		objectShader->SetMat4f("projection", projection);
-		objectShader->SetMat3f("normal", normalMatrix);
-		objectShader->SetVec3f("viewPos", camera->GetPosition());
+		for (const auto& map : { boxDiffuseMap, boxSpecularMap, boxEmissionMap })
+		{
+			if (map == nullptr)
+				continue;
 
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+			GetTextureStreamer().Request(*map, Graphics::TextureStreamer::ComputeLevel(
+				packet.projection, packet.framebufferSize.y, boxDistance, static_cast<float>(map->GetWidth())));
+		}
 
-		objectVa->Unbind();
-		objectShader->Unuse();
+		{
+			const Graphics::GpuZone zone("objects");
+
+			objectShader->Use();
+			objectVa->Bind();
+
+			if (boxMaps != nullptr)
+				boxMaps->Bind(0);
+			else
+			{
+				boxDiffuseMap->Bind(0);
+				boxSpecularMap->Bind(1);
+			}
+
+			boxEmissionMap->Bind(2);
+
+			objectShader->SetMat4f("model", model);
+			objectShader->SetMat4f("view", packet.view);
+			objectShader->SetMat4f("projection", packet.projection);
+			objectShader->SetMat3f("normal", normalMatrix);
+			objectShader->SetVec3f("viewPos", packet.viewPosition);
+			objectShader->SetVec3f("light.position", light.position);
+			objectShader->SetVec3f("light.ambient", light.ambient);
+			objectShader->SetVec3f("light.diffuse", light.diffuse);
+			objectShader->SetVec3f("light.specular", light.specular);
+
+			glDrawArrays(GL_TRIANGLES, 0, 36);
+
+			objectVa->Unbind();
+			objectShader->Unuse();
+		}
 
-		model = glm::mat4(1.0f);
-		model = glm::translate(model, lightPos);
-		model = glm::scale(model, glm::vec3(0.2f));
+		{
+			const Graphics::GpuZone zone("light-box");
 
-		lightShader->Use();
-		lightVa->Bind();
+			lightShader->Use();
+			lightVa->Bind();
 
-		lightShader->SetMat4f("model", model);
-		lightShader->SetMat4f("view", view);
-		lightShader->SetMat4f("projection", projection);
+			lightShader->SetMat4f("model", packet.transforms[1]);
+			lightShader->SetMat4f("view", packet.view);
+			lightShader->SetMat4f("projection", packet.projection);
 
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+			glDrawArrays(GL_TRIANGLES, 0, 36);
 
-		lightVa->Unbind();
-		lightShader->Unuse();
+			lightVa->Unbind();
+			lightShader->Unuse();
+		}
 
 	}
-}
+}
\ No newline at end of file
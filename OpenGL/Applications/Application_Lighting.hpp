@@ -5,42 +5,39 @@
 
 #include "IApplication.hpp"
 #include "../Graphics/ShaderProgram.hpp"
+#include "../Graphics/Texture.hpp"
+#include "../Graphics/TextureAtlas.hpp"
 #include "../Graphics/VertexArray.hpp"
-#include "../Utils/Camera3D.hpp"
-#include "../Utils/Window.hpp"
+#include "../Utils/ThreadPool.hpp"
 
 namespace Applications
 {
 	class Application_Lighting : public IApplication
 	{
 		glm::vec3 lightPos;
-		unsigned boxDiffuseMap;
-		unsigned boxSpecularMap;
-		unsigned boxEmissionMap;
+		std::unique_ptr<Utils::ThreadPool> threadPool;
+		std::shared_ptr<Graphics::Texture> boxDiffuseMap;
+		std::shared_ptr<Graphics::Texture> boxSpecularMap;
+		std::shared_ptr<Graphics::Texture> boxEmissionMap;
 
-		protected:
-			Input::InputManager inputManager;
+		// Replaces the diffuse and specular maps when the pack tool has put them into one array
+		std::shared_ptr<Graphics::TextureArray> boxMaps;
+		Graphics::TextureAtlasEntry boxDiffuseEntry;
+		Graphics::TextureAtlasEntry boxSpecularEntry;
 
-			std::unique_ptr<Utils::Window> window;
-			std::unique_ptr<Utils::Camera3D> camera;
+		protected:
 			std::unique_ptr<Graphics::ShaderProgram> objectShader;
 			std::unique_ptr<Graphics::ShaderProgram> lightShader;
 			std::unique_ptr<Graphics::VertexArray> objectVa;
 			std::unique_ptr<Graphics::VertexArray> lightVa;
 
-			void Initialize();
-			void LoadContent();
-			void UnloadContent();
-			void Update(float deltaTime);
-			void Render() const;
+			void Initialize() override;
+			void LoadContent() override;
+			void UnloadContent() override;
+			void Update(float deltaTime) override;
+			void BuildFramePacket(Utils::FramePacket& packet) const override;
+			void Render(const Utils::FramePacket& packet) const override;
 		public:
-			Application_Lighting();
-
-			void Run();
-
-		Input::InputManager& GetInputManager() override
-		{
-			return inputManager;
-		}
+			explicit Application_Lighting(Utils::WindowBackend backend = Utils::WindowBackend::GLFW);
 	};
 }
@@ -0,0 +1,469 @@
+#include "IApplication.hpp"
+
+//-------------------------------------------------------------------
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+//-------------------------------------------------------------------
+
+#include "../Graphics/GLDebug.hpp"
+#include "../Graphics/GLStats.hpp"
+#include "../Graphics/GpuMemoryTracker.hpp"
+#include "../Graphics/GpuProfiler.hpp"
+#include "../Graphics/Overlay.hpp"
+#include "../Graphics/SamplerCache.hpp"
+#include "../Utils/Clock.hpp"
+#include "../Utils/CpuProfiler.hpp"
+#include "../Utils/FrameLimiter.hpp"
+#include "../Utils/FramePipeline.hpp"
+#include "../Utils/StartupTimer.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Applications
+{
+	struct IApplication::OverlayState
+	{
+		static constexpr size_t HISTORY_LENGTH = 120;
+
+		Graphics::Overlay overlay;
+
+		std::vector<float> frameTimes = std::vector<float>(HISTORY_LENGTH, 0.0f);
+		std::vector<float> gpuTimes = std::vector<float>(HISTORY_LENGTH, 0.0f);
+		size_t nextSample = 0;
+
+		Utils::Clock frameClock;
+	};
+
+	//-------------------------------------------------------------------
+
+	IApplication::IApplication() = default;
+	IApplication::~IApplication() = default;
+
+	//-------------------------------------------------------------------
+
+	void IApplication::Run()
+	{
+		CPU_THREAD_NAME("Update");
+
+		if (!runSettings.cpuTracePath.empty())
+			Utils::CpuProfiler::BeginCapture();
+
+		InitializeAndLoad();
+
+		const auto isRenderThreadEnabled = runSettings.isRenderThreadEnabled;
+		const auto swapInterval = runSettings.swapInterval;
+
+		// The render thread owns the context for as long as the pipeline runs
+		if (isRenderThreadEnabled)
+			window->ReleaseContext();
+		else
+			window->SetSwapInterval(swapInterval);
+
+		Utils::FramePipeline pipeline(isRenderThreadEnabled, 2,
+			[this, swapInterval]
+			{
+				window->MakeContextCurrent();
+				window->SetSwapInterval(swapInterval);
+			},
+			[this](const Utils::FramePacket& packet) { RenderFramePacket(packet); },
+			[this] { window->ReleaseContext(); });
+
+		Graphics::GpuProfiler::SetIsEnabled(true);
+
+		Utils::FrameLimiter frameLimiter(runSettings.maxFrameRate);
+		Utils::Clock clock;
+
+		const auto fixedTimeStep = runSettings.fixedTimeStep;
+		const auto maxStepsPerFrame = std::max(runSettings.maxStepsPerFrame, 1);
+		const auto isLockStep = inputManager.GetIsReplaying();
+
+		auto previousTime = clock.GetElapsedSeconds();
+		auto accumulator = 0.0;
+		auto simulationTime = 0.0;
+
+		// Update loop, each iteration advances the simulation by whole fixed steps and
+		// produces a frame packet that is rendered while the next iteration is running
+		while (!window->GetShouldClose())
+		{
+			CPU_ZONE("Frame");
+
+			const auto currentTime = clock.GetElapsedSeconds();
+			accumulator += currentTime - previousTime;
+			previousTime = currentTime;
+
+			// Exactly one step per frame, so replays do not depend on how fast frames are produced
+			if (isLockStep)
+				accumulator = fixedTimeStep;
+
+			auto steps = 0;
+			const Utils::Clock updateClock;
+
+			while (accumulator >= fixedTimeStep && steps < maxStepsPerFrame)
+			{
+				CPU_ZONE("Update");
+
+				inputManager.BeginStep();
+
+				if (inputManager.ConsumeKeyPress(OVERLAY_KEY))
+					isOverlayVisible = !isOverlayVisible;
+
+				Update(static_cast<float>(fixedTimeStep));
+
+				simulationTime += fixedTimeStep;
+				accumulator -= fixedTimeStep;
+				steps++;
+			}
+
+			if (steps == maxStepsPerFrame)
+				accumulator = std::min(accumulator, fixedTimeStep);
+
+			if (inputManager.GetIsReplayFinished())
+				window->SetShouldClose(true);
+
+			const auto alpha = accumulator / fixedTimeStep;
+
+			auto& packet = pipeline.BeginFrame();
+
+			// The latest simulated state is one step ahead of what gets displayed
+			PrepareFramePacket(packet, simulationTime - fixedTimeStep * (1.0 - alpha), static_cast<float>(alpha));
+
+			packet.updateMs = static_cast<float>(updateClock.GetElapsedSeconds() * 1000.0);
+			packet.isOverlayVisible = isOverlayVisible;
+
+			pipeline.SubmitFrame();
+
+			window->PollEvents();
+
+			CPU_ZONE("Frame limiter");
+			frameLimiter.Wait();
+		}
+
+		pipeline.Stop();
+
+		if (isRenderThreadEnabled)
+			window->MakeContextCurrent();
+
+		const auto stats = pipeline.GetStats();
+
+		std::cout << "Rendered " << stats.framesRendered << " frames at " << stats.framesPerSecond
+			<< " fps, latency avg " << stats.averageLatencyMs << " ms, max " << stats.maxLatencyMs << " ms" << std::endl;
+
+		for (const auto& zone : Graphics::GpuProfiler::GetZoneStats())
+			std::cout << "GPU " << zone.name << ": " << zone.averageMs << " ms" << std::endl;
+
+		Graphics::GpuProfiler::Release();
+		Graphics::GpuProfiler::SetIsEnabled(false);
+
+		overlayState = nullptr;
+		textureStreamer = nullptr;
+		textureUploader = nullptr;
+
+		StopInputRecordingOrReplay();
+
+		Utils::StartupTimer::PrintReport(std::cout);
+		Graphics::GpuMemoryTracker::PrintReport(std::cout);
+		textureCache.PrintReport(std::cout);
+
+		UnloadContent();
+
+		Graphics::SamplerCache::Release();
+		Graphics::GpuMemoryTracker::PrintLeakReport(std::cout, windowAllocations);
+		Graphics::GLDebug::PrintReport(std::cout);
+		Graphics::GLDebug::Uninstall();
+		Graphics::GLStats::Uninstall();
+
+		if (!runSettings.cpuTracePath.empty())
+		{
+			Utils::CpuProfiler::EndCapture();
+
+			std::ofstream trace(runSettings.cpuTracePath);
+			Utils::CpuProfiler::WriteChromeTrace(trace);
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void IApplication::BeginSession()
+	{
+		InitializeAndLoad();
+
+		sessionTime = 0.0;
+	}
+
+	//-------------------------------------------------------------------
+
+	void IApplication::StepFrame(const float deltaTime)
+	{
+		CPU_ZONE("Frame");
+
+		{
+			CPU_ZONE("Update");
+
+			inputManager.BeginStep();
+			Update(deltaTime);
+		}
+
+		sessionTime += deltaTime;
+
+		PrepareFramePacket(sessionPacket, sessionTime, 1.0f);
+		RenderFramePacket(sessionPacket);
+	}
+
+	//-------------------------------------------------------------------
+
+	void IApplication::EndSession()
+	{
+		overlayState = nullptr;
+		textureStreamer = nullptr;
+		textureUploader = nullptr;
+
+		StopInputRecordingOrReplay();
+
+		UnloadContent();
+
+		Graphics::SamplerCache::Release();
+		Graphics::GpuMemoryTracker::PrintLeakReport(std::cout, windowAllocations);
+		Graphics::GLDebug::PrintReport(std::cout);
+		Graphics::GLDebug::Uninstall();
+		Graphics::GLStats::Uninstall();
+	}
+
+	//-------------------------------------------------------------------
+
+	void IApplication::InitializeAndLoad()
+	{
+		if (runSettings.isGLStatsEnabled)
+			Graphics::GLStats::Install();
+
+		if (Utils::Window::GetIsDebugContextEnabled() && !Graphics::GLDebug::Install())
+			std::cout << "The GL context does not support debug output." << std::endl;
+
+		Graphics::GpuMemoryTracker::SetTotalBudget(runSettings.gpuMemoryBudget);
+		windowAllocations = Graphics::GpuMemoryTracker::GetLiveAllocations();
+
+		textureUploader = std::make_unique<Graphics::TextureUploader>(runSettings.textureUploadBudget);
+		textureStreamer = std::make_unique<Graphics::TextureStreamer>(*textureUploader, runSettings.textureResidencyBudget);
+
+		{
+			CPU_ZONE("Initialize");
+			const Utils::StartupPhase phase("Initialize");
+
+			Initialize();
+		}
+
+		{
+			CPU_ZONE("LoadContent");
+			const Utils::StartupPhase phase("Load content");
+
+			LoadContent();
+		}
+
+		StartInputRecordingOrReplay();
+	}
+
+	//-------------------------------------------------------------------
+
+	void IApplication::StartInputRecordingOrReplay()
+	{
+		if (!runSettings.inputReplayPath.empty())
+		{
+			auto recording = Input::InputRecording::Load(runSettings.inputReplayPath);
+
+			// Steps of another size would move the camera by different amounts for the same input
+			runSettings.fixedTimeStep = recording.GetFixedTimeStep();
+
+			std::cout << "Replaying " << recording.GetStepCount() << " steps of input from " << runSettings.inputReplayPath << std::endl;
+
+			inputManager.StartReplay(std::move(recording));
+		}
+		else if (!runSettings.inputRecordPath.empty())
+		{
+			inputManager.StartRecording(runSettings.fixedTimeStep);
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void IApplication::StopInputRecordingOrReplay()
+	{
+		if (inputManager.GetIsRecording())
+		{
+			const auto recording = inputManager.StopRecording();
+			recording.Save(runSettings.inputRecordPath);
+
+			std::cout << "Recorded " << recording.GetStepCount() << " steps of input to " << runSettings.inputRecordPath << std::endl;
+		}
+
+		inputManager.StopReplay();
+	}
+
+	//-------------------------------------------------------------------
+
+	void IApplication::PrepareFramePacket(Utils::FramePacket& packet, const double elapsedTime, const float interpolation) const
+	{
+		CPU_ZONE("BuildFramePacket");
+
+		packet.elapsedTime = elapsedTime;
+		packet.interpolation = interpolation;
+		packet.framebufferSize = window->GetFramebufferSize();
+		packet.isOverlayVisible = false;
+		packet.transforms.clear();
+		packet.lights.clear();
+
+		BuildFramePacket(packet);
+	}
+
+	//-------------------------------------------------------------------
+
+	void IApplication::RenderFramePacket(const Utils::FramePacket& packet) const
+	{
+		// The overlay displays the counters, so showing it opts in
+		if (packet.isOverlayVisible && !Graphics::GLStats::GetIsInstalled())
+			Graphics::GLStats::Install();
+
+		textureUploader->Update();
+
+		glViewport(0, 0, packet.framebufferSize.x, packet.framebufferSize.y);
+
+		{
+			CPU_ZONE("Render");
+			const Graphics::GpuZone zone(FRAME_GPU_ZONE);
+
+			Render(packet);
+		}
+
+		textureStreamer->Update();
+
+		if (packet.isOverlayVisible)
+		{
+			CPU_ZONE("Overlay");
+
+			// The overlay must not show up in the statistics it displays
+			Graphics::GLStats::SetIsPaused(true);
+			DrawOverlay(packet);
+			Graphics::GLStats::SetIsPaused(false);
+		}
+
+		{
+			CPU_ZONE("SwapBuffers");
+			window->SwapBuffers();
+		}
+
+		Utils::StartupTimer::MarkFirstFrame();
+
+		Graphics::GLStats::EndFrame();
+		Graphics::GLDebug::EndFrame();
+		Graphics::GpuProfiler::EndFrame();
+	}
+
+	//-------------------------------------------------------------------
+
+	void IApplication::DrawOverlay(const Utils::FramePacket& packet) const
+	{
+		if (overlayState == nullptr)
+			overlayState = std::make_unique<OverlayState>();
+
+		auto& state = *overlayState;
+		auto& overlay = state.overlay;
+
+		const auto frameMs = static_cast<float>(state.frameClock.GetElapsedSeconds() * 1000.0);
+		state.frameClock.Restart();
+
+		auto gpuMs = 0.0f;
+		const auto zones = Graphics::GpuProfiler::GetZoneStats();
+
+		for (const auto& zone : zones)
+			if (zone.name == FRAME_GPU_ZONE)
+				gpuMs = static_cast<float>(zone.lastMs);
+
+		state.frameTimes[state.nextSample] = frameMs;
+		state.gpuTimes[state.nextSample] = gpuMs;
+		state.nextSample = (state.nextSample + 1) % OverlayState::HISTORY_LENGTH;
+
+		const auto glStats = Graphics::GLStats::GetLastFrame();
+		const auto memory = Graphics::GpuMemoryTracker::GetTotals();
+
+		std::ostringstream text;
+		text << std::fixed << std::setprecision(2)
+			<< "frame " << frameMs << " ms (" << std::setprecision(0) << 1000.0f / std::max(frameMs, 0.001f) << " fps)\n"
+			<< std::setprecision(2) << "update " << packet.updateMs << " ms  gpu " << gpuMs << " ms\n"
+			<< "draws " << glStats.drawCalls << "  states " << glStats.stateChanges << "  uniforms " << glStats.uniformUploads << "\n"
+			<< "uploaded " << glStats.GetBytesUploaded() / 1024 << " KB\n"
+			<< "gpu memory " << static_cast<double>(memory.liveBytes) / (1024.0 * 1024.0) << " MB"
+			<< " (peak " << static_cast<double>(memory.peakBytes) / (1024.0 * 1024.0) << " MB)\n";
+
+		const auto uploads = textureUploader->GetStats();
+
+		if (uploads.pendingTextures > 0)
+			text << "streaming " << uploads.pendingTextures << " textures, " << uploads.pendingBytes / 1024 << " KB left\n";
+
+		const auto residency = textureStreamer->GetStats();
+
+		if (residency.textures > 0)
+		{
+			text << "mips resident " << residency.residentBytes / 1024 << " KB of " << residency.budget / 1024 << " KB";
+
+			if (residency.missingBytes > 0)
+				text << ", " << residency.missingBytes / 1024 << " KB over";
+
+			text << "\n";
+		}
+
+		if (Graphics::GLDebug::GetIsInstalled())
+		{
+			const auto debugFrame = Graphics::GLDebug::GetLastFrame();
+			const auto debugTotals = Graphics::GLDebug::GetTotals();
+
+			text << "gl errors " << debugFrame.GetCount(Graphics::GLDebugCategory::API_ERROR)
+				<< "  perf warnings " << debugFrame.GetCount(Graphics::GLDebugCategory::PERFORMANCE)
+				<< " (" << debugTotals.GetCount(Graphics::GLDebugCategory::PERFORMANCE) << " total)\n";
+		}
+
+		for (const auto& zone : zones)
+			text << "  " << zone.name << " " << std::setprecision(3) << zone.averageMs << " ms\n";
+
+		const auto lines = text.str();
+		const auto lineCount = static_cast<float>(std::count(lines.begin(), lines.end(), '\n'));
+
+		size_t longestLine = 0;
+
+		for (size_t begin = 0, end; (end = lines.find('\n', begin)) != std::string::npos; begin = end + 1)
+			longestLine = std::max(longestLine, end - begin);
+
+		const glm::vec2 origin(8.0f, 8.0f);
+		const glm::vec2 graphSize(2.0f * OverlayState::HISTORY_LENGTH, 60.0f);
+		const auto panelHeight = Graphics::Overlay::LINE_HEIGHT * lineCount + graphSize.y + 16.0f;
+
+		const auto panelWidth = std::max(graphSize.x, Graphics::Overlay::CHARACTER_WIDTH * static_cast<float>(longestLine));
+
+		overlay.AddRectangle(origin - 4.0f, { panelWidth + 8.0f, panelHeight + 8.0f }, { 0.0f, 0.0f, 0.0f, 0.6f });
+		overlay.AddText(origin, lines, { 1.0f, 1.0f, 1.0f, 1.0f });
+
+		// Oldest sample on the left, the graph spans 0 to 33 ms with a line at 16.7 ms
+		std::vector<float> frameHistory;
+		std::vector<float> gpuHistory;
+
+		for (size_t i = 0; i < OverlayState::HISTORY_LENGTH; i++)
+		{
+			const auto sample = (state.nextSample + i) % OverlayState::HISTORY_LENGTH;
+			frameHistory.push_back(state.frameTimes[sample]);
+			gpuHistory.push_back(state.gpuTimes[sample]);
+		}
+
+		const glm::vec2 graphPosition(origin.x, origin.y + Graphics::Overlay::LINE_HEIGHT * lineCount + 8.0f);
+		constexpr auto graphRangeMs = 1000.0f / 30.0f;
+
+		overlay.AddGraph(graphPosition, graphSize, frameHistory, graphRangeMs, { 0.3f, 0.8f, 0.3f, 0.9f });
+		overlay.AddGraph(graphPosition, graphSize, gpuHistory, graphRangeMs, { 0.9f, 0.5f, 0.2f, 0.9f });
+		overlay.AddRectangle({ graphPosition.x, graphPosition.y + graphSize.y * 0.5f }, { graphSize.x, 1.0f }, { 1.0f, 1.0f, 1.0f, 0.5f });
+
+		overlay.Draw(packet.framebufferSize);
+	}
+}
@@ -2,24 +2,163 @@
 
 //-------------------------------------------------------------------
 
+#include <cstdint>
+#include <memory>
+#include <string>
+
+//-------------------------------------------------------------------
+
+#include "../Graphics/TextureCache.hpp"
+#include "../Graphics/TextureStreamer.hpp"
+#include "../Graphics/TextureUploader.hpp"
 #include "../Input/InputManager.hpp"
+#include "../Utils/Camera3D.hpp"
+#include "../Utils/FramePacket.hpp"
+#include "../Utils/Window.hpp"
 
 //-------------------------------------------------------------------
 
 namespace Applications
 {
+	struct RunSettings
+	{
+		// Simulation always advances in steps of this size, rendering interpolates between them
+		double fixedTimeStep = 1.0 / 120.0;
+
+		// Simulation steps run before the backlog is dropped, so a long stall cannot snowball
+		int maxStepsPerFrame = 8;
+
+		// 0 leaves the frame rate unlimited
+		double maxFrameRate = 0.0;
+
+		// 0 disables vsync, 1 syncs to every vertical blank
+		int swapInterval = 1;
+
+		bool isRenderThreadEnabled = true;
+
+		// Wraps the GL entry points with Graphics::GLStats counters before anything is loaded.
+		// Otherwise they are only wrapped once the overlay is first shown.
+		bool isGLStatsEnabled = false;
+
+		// Warns when the tracked GPU memory grows past this many bytes, 0 disables the warning
+		uint64_t gpuMemoryBudget = 0;
+
+		// Bytes of texture data streamed to the GPU per frame by the texture uploader
+		uint64_t textureUploadBudget = 4 * 1024 * 1024;
+
+		// Bytes of mip levels the texture streamer keeps on the GPU, 0 keeps every requested level
+		uint64_t textureResidencyBudget = 256 * 1024 * 1024;
+
+		// When set, Run captures CPU zones for its whole duration and writes them there as a Chrome trace
+		std::string cpuTracePath;
+
+		// When set, input is recorded from the end of LoadContent and written there on exit
+		std::string inputRecordPath;
+
+		// When set, live input is ignored and the recording is replayed instead. Run then advances one
+		// fixed step per frame at the recording's timestep and stops when the recording ends.
+		std::string inputReplayPath;
+	};
+
 	class IApplication
 	{
+		struct OverlayState;
+
+		RunSettings runSettings;
+
+		// Only touched on the thread owning the context, created the first time it is shown
+		mutable std::unique_ptr<OverlayState> overlayState;
+		bool isOverlayVisible = false;
+
+		// Only touched on the thread owning the context, pumped before every Render
+		mutable std::unique_ptr<Graphics::TextureUploader> textureUploader;
+
+		// Same, updated after every Render with the levels it requested
+		mutable std::unique_ptr<Graphics::TextureStreamer> textureStreamer;
+
+		Utils::FramePacket sessionPacket;
+		double sessionTime = 0.0;
+
+		// Allocations made before the session, such as the headless framebuffer, outlive it with the window
+		std::vector<Graphics::GpuAllocationInfo> windowAllocations;
+
+		void InitializeAndLoad();
+		void StartInputRecordingOrReplay();
+		void StopInputRecordingOrReplay();
+		void PrepareFramePacket(Utils::FramePacket& packet, double elapsedTime, float interpolation) const;
+		void RenderFramePacket(const Utils::FramePacket& packet) const;
+		void DrawOverlay(const Utils::FramePacket& packet) const;
+
 	protected:
-		IApplication() = default;
+		Input::InputManager inputManager;
+		Graphics::TextureCache textureCache;
+
+		// Owns the context, it must outlive UnloadContent so the shared GL objects can be released after it
+		std::unique_ptr<Utils::Window> window;
+		std::unique_ptr<Utils::Camera3D> camera;
+
+		IApplication();
+
+		// Only valid from Initialize to UnloadContent, on the thread owning the context.
+		Graphics::TextureUploader& GetTextureUploader() const
+		{
+			return *textureUploader;
+		}
+
+		// Same.
+		Graphics::TextureStreamer& GetTextureStreamer() const
+		{
+			return *textureStreamer;
+		}
+
+		virtual void Initialize() = 0;
+		virtual void LoadContent() = 0;
+		virtual void UnloadContent() = 0;
+		virtual void Update(float deltaTime) = 0;
+
+		// Called on the update thread, must capture everything Render needs.
+		virtual void BuildFramePacket(Utils::FramePacket& packet) const = 0;
+
+		// Called on the thread owning the GL context, may only read the packet and GPU resources.
+		virtual void Render(const Utils::FramePacket& packet) const = 0;
 
 	public:
-		virtual ~IApplication() = default;
+		// GPU profiler zone enclosing everything rendered in a frame
+		static constexpr const char* FRAME_GPU_ZONE = "frame";
+
+		// Toggles the performance overlay
+		static constexpr auto OVERLAY_KEY = Input::Keys::F3;
+
+		virtual ~IApplication();
 		IApplication(const IApplication& other) = delete;
 		IApplication& operator=(const IApplication& other) = delete;
 		IApplication(IApplication&& other) = delete;
 		IApplication& operator=(IApplication&& other) = delete;
 
-		virtual Input::InputManager& GetInputManager() = 0;
+		void Run();
+
+		// Lets tools drive the application one frame at a time on the calling thread instead of Run.
+		// Recorded or replayed input only matches when every step uses GetRunSettings().fixedTimeStep.
+		void BeginSession();
+		void StepFrame(float deltaTime);
+		void EndSession();
+
+		void SetRunSettings(const RunSettings& value) { runSettings = value; }
+		[[nodiscard]] const RunSettings& GetRunSettings() const { return runSettings; }
+
+		Input::InputManager& GetInputManager()
+		{
+			return inputManager;
+		}
+
+		Utils::Camera3D& GetCamera()
+		{
+			return *camera;
+		}
+
+		Utils::Window& GetWindow()
+		{
+			return *window;
+		}
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,70 @@
+#version 330 core
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+// Where the pack tool put a map, see Graphics::TextureAtlasEntry
+struct PackedMap
+{
+	float layer;
+	vec2 uvScale;
+	vec2 uvOffset;
+};
+
+struct Material
+{
+	// Holds both the diffuse and the specular map
+	sampler2DArray maps;
+	PackedMap diffuse;
+	PackedMap specular;
+	sampler2D emission;
+	float shininess;
+};
+
+struct Light
+{
+	vec3 position;
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+};
+
+uniform Material material;
+uniform Light light;
+uniform vec3 viewPos;
+
+vec3 SamplePacked(PackedMap map)
+{
+	return vec3(texture(material.maps, vec3(TexCoords * map.uvScale + map.uvOffset, map.layer)));
+}
+
+void main()
+{
+	vec3 diffuseMapColor = SamplePacked(material.diffuse);
+	vec3 specularMapColor = SamplePacked(material.specular);
+	vec3 emissiveMapColor = vec3(texture(material.emission, TexCoords));
+
+	vec3 ambient =  light.ambient * diffuseMapColor;
+
+	vec3 norm = normalize(Normal);
+	vec3 lightDir = normalize(light.position - FragPos);
+
+	float diff = max(dot(norm, lightDir), 0.0f);
+	vec3 diffuse = light.diffuse * diff * diffuseMapColor;
+
+	vec3 viewDir = normalize(viewPos - FragPos);
+	vec3 reflectDir = reflect(-lightDir, norm);
+
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0f), material.shininess);
+	vec3 specular = light.specular * spec * specularMapColor;
+
+	vec3 result = ambient + diffuse + specular;
+
+	if (specularMapColor == vec3(0.0f))
+		result += emissiveMapColor;
+
+	FragColor = vec4(result, 1.0f);
+}
@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec2 TexCoord;
+in vec4 Color;
+
+out vec4 FragColor;
+
+uniform sampler2D glyphAtlas;
+
+void main()
+{
+	FragColor = vec4(Color.rgb, Color.a * texture(glyphAtlas, TexCoord).r);
+}
\ No newline at end of file
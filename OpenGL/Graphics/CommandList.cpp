@@ -0,0 +1,236 @@
+#include "CommandList.hpp"
+
+#include <stdexcept>
+#include <glad/glad.h>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "ShaderProgram.hpp"
+#include "Texture.hpp"
+#include "VertexArray.hpp"
+
+namespace Graphics
+{
+	unsigned CommandList::PushPayload(const float* values, const size_t count)
+	{
+		const auto offset = static_cast<unsigned>(payload.size());
+
+		payload.insert(payload.end(), values, values + count);
+
+		return offset;
+	}
+
+	void CommandList::UseProgram(const ShaderProgram& program)
+	{
+		commands.push_back({ CommandType::USE_PROGRAM, static_cast<int>(program.GetId()), 0, 0, 0 });
+	}
+
+	void CommandList::BindVertexArray(const VertexArray& vertexArray)
+	{
+		commands.push_back({ CommandType::BIND_VERTEX_ARRAY, static_cast<int>(vertexArray.GetId()), 0, 0, 0 });
+	}
+
+	void CommandList::BindTexture(const unsigned unit, const Texture& texture)
+	{
+		if (unit >= CommandExecutionState::MAX_TEXTURE_UNITS)
+			throw std::runtime_error("Texture unit is out of range.");
+
+		commands.push_back({ CommandType::BIND_TEXTURE, static_cast<int>(unit), static_cast<int>(texture.GetId()),
+			static_cast<int>(texture.GetSampler()), 0 });
+	}
+
+	void CommandList::Enable(const unsigned capability)
+	{
+		commands.push_back({ CommandType::ENABLE, static_cast<int>(capability), 0, 0, 0 });
+	}
+
+	void CommandList::Disable(const unsigned capability)
+	{
+		commands.push_back({ CommandType::DISABLE, static_cast<int>(capability), 0, 0, 0 });
+	}
+
+	void CommandList::SetClearColor(const glm::vec4& color)
+	{
+		commands.push_back({ CommandType::CLEAR_COLOR, 0, 0, 0, PushPayload(glm::value_ptr(color), 4) });
+	}
+
+	void CommandList::Clear(const unsigned mask)
+	{
+		commands.push_back({ CommandType::CLEAR, static_cast<int>(mask), 0, 0, 0 });
+	}
+
+	void CommandList::SetInt(const int location, const int value)
+	{
+		commands.push_back({ CommandType::UNIFORM_INT, location, value, 0, 0 });
+	}
+
+	void CommandList::SetFloat(const int location, const float value)
+	{
+		commands.push_back({ CommandType::UNIFORM_FLOAT, location, 0, 0, PushPayload(&value, 1) });
+	}
+
+	void CommandList::SetVec3f(const int location, const glm::vec3& value)
+	{
+		commands.push_back({ CommandType::UNIFORM_VEC3F, location, 0, 0, PushPayload(glm::value_ptr(value), 3) });
+	}
+
+	void CommandList::SetVec4f(const int location, const glm::vec4& value)
+	{
+		commands.push_back({ CommandType::UNIFORM_VEC4F, location, 0, 0, PushPayload(glm::value_ptr(value), 4) });
+	}
+
+	void CommandList::SetMat3f(const int location, const glm::mat3& value)
+	{
+		commands.push_back({ CommandType::UNIFORM_MAT3F, location, 0, 0, PushPayload(glm::value_ptr(value), 9) });
+	}
+
+	void CommandList::SetMat4f(const int location, const glm::mat4& value)
+	{
+		commands.push_back({ CommandType::UNIFORM_MAT4F, location, 0, 0, PushPayload(glm::value_ptr(value), 16) });
+	}
+
+	void CommandList::SetInt(const ShaderProgram& program, const std::string& name, const int value)
+	{
+		SetInt(program.GetUniformLocation(name), value);
+	}
+
+	void CommandList::SetFloat(const ShaderProgram& program, const std::string& name, const float value)
+	{
+		SetFloat(program.GetUniformLocation(name), value);
+	}
+
+	void CommandList::SetVec3f(const ShaderProgram& program, const std::string& name, const glm::vec3& value)
+	{
+		SetVec3f(program.GetUniformLocation(name), value);
+	}
+
+	void CommandList::SetVec4f(const ShaderProgram& program, const std::string& name, const glm::vec4& value)
+	{
+		SetVec4f(program.GetUniformLocation(name), value);
+	}
+
+	void CommandList::SetMat3f(const ShaderProgram& program, const std::string& name, const glm::mat3& value)
+	{
+		SetMat3f(program.GetUniformLocation(name), value);
+	}
+
+	void CommandList::SetMat4f(const ShaderProgram& program, const std::string& name, const glm::mat4& value)
+	{
+		SetMat4f(program.GetUniformLocation(name), value);
+	}
+
+	void CommandList::DrawArrays(const unsigned mode, const int first, const int count)
+	{
+		commands.push_back({ CommandType::DRAW_ARRAYS, static_cast<int>(mode), first, count, 0 });
+	}
+
+	void CommandList::DrawElements(const unsigned mode, const int count, const int indexOffset)
+	{
+		if (indexOffset < 0)
+			throw std::runtime_error("Element buffer offset cannot be negative.");
+
+		commands.push_back({ CommandType::DRAW_ELEMENTS, static_cast<int>(mode), count, indexOffset, 0 });
+	}
+
+	void CommandList::Reset()
+	{
+		commands.clear();
+		payload.clear();
+	}
+
+	void CommandList::Execute(CommandExecutionState& state) const
+	{
+		for (const auto& command : commands)
+		{
+			const auto values = payload.data() + command.payloadOffset;
+
+			switch (command.type)
+			{
+			case CommandType::USE_PROGRAM:
+			{
+				const auto program = static_cast<unsigned>(command.arg0);
+
+				if (state.program != program)
+				{
+					glUseProgram(program);
+					state.program = program;
+				}
+				break;
+			}
+			case CommandType::BIND_VERTEX_ARRAY:
+			{
+				const auto vertexArray = static_cast<unsigned>(command.arg0);
+
+				if (state.vertexArray != vertexArray)
+				{
+					glBindVertexArray(vertexArray);
+					state.vertexArray = vertexArray;
+				}
+				break;
+			}
+			case CommandType::BIND_TEXTURE:
+			{
+				const auto unit = static_cast<unsigned>(command.arg0);
+				const auto texture = static_cast<unsigned>(command.arg1);
+				const auto sampler = static_cast<unsigned>(command.arg2);
+
+				// Sampler bindings do not go through the active unit
+				if (state.samplers[unit] != sampler)
+				{
+					glBindSampler(unit, sampler);
+					state.samplers[unit] = sampler;
+				}
+
+				if (state.textures[unit] == texture)
+					break;
+
+				if (state.activeTextureUnit != unit)
+				{
+					glActiveTexture(GL_TEXTURE0 + unit);
+					state.activeTextureUnit = unit;
+				}
+
+				glBindTexture(GL_TEXTURE_2D, texture);
+				state.textures[unit] = texture;
+				break;
+			}
+			case CommandType::ENABLE:
+				glEnable(static_cast<GLenum>(command.arg0));
+				break;
+			case CommandType::DISABLE:
+				glDisable(static_cast<GLenum>(command.arg0));
+				break;
+			case CommandType::CLEAR_COLOR:
+				glClearColor(values[0], values[1], values[2], values[3]);
+				break;
+			case CommandType::CLEAR:
+				glClear(static_cast<GLbitfield>(command.arg0));
+				break;
+			case CommandType::UNIFORM_INT:
+				glUniform1i(command.arg0, command.arg1);
+				break;
+			case CommandType::UNIFORM_FLOAT:
+				glUniform1f(command.arg0, values[0]);
+				break;
+			case CommandType::UNIFORM_VEC3F:
+				glUniform3fv(command.arg0, 1, values);
+				break;
+			case CommandType::UNIFORM_VEC4F:
+				glUniform4fv(command.arg0, 1, values);
+				break;
+			case CommandType::UNIFORM_MAT3F:
+				glUniformMatrix3fv(command.arg0, 1, GL_FALSE, values);
+				break;
+			case CommandType::UNIFORM_MAT4F:
+				glUniformMatrix4fv(command.arg0, 1, GL_FALSE, values);
+				break;
+			case CommandType::DRAW_ARRAYS:
+				glDrawArrays(static_cast<GLenum>(command.arg0), command.arg1, command.arg2);
+				break;
+			case CommandType::DRAW_ELEMENTS:
+				glDrawElements(static_cast<GLenum>(command.arg0), command.arg1, GL_UNSIGNED_INT,
+					reinterpret_cast<const void*>(static_cast<size_t>(command.arg2)));
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Graphics
+{
+	class ShaderProgram;
+	class Texture;
+	class VertexArray;
+
+	enum class CommandType : unsigned char
+	{
+		USE_PROGRAM,
+		BIND_VERTEX_ARRAY,
+		BIND_TEXTURE,
+		ENABLE,
+		DISABLE,
+		CLEAR_COLOR,
+		CLEAR,
+		UNIFORM_INT,
+		UNIFORM_FLOAT,
+		UNIFORM_VEC3F,
+		UNIFORM_VEC4F,
+		UNIFORM_MAT3F,
+		UNIFORM_MAT4F,
+		DRAW_ARRAYS,
+		DRAW_ELEMENTS
+	};
+
+	struct Command
+	{
+		CommandType type;
+		int arg0;
+		int arg1;
+		int arg2;
+		unsigned payloadOffset;
+	};
+
+	// Bindings last issued while replaying, shared across every list replayed in a frame
+	// so that redundant binds between lists are dropped too. Everything starts out unknown
+	// so the first bind of each kind always reaches GL.
+	struct CommandExecutionState
+	{
+		static constexpr unsigned UNKNOWN = ~0u;
+		static constexpr unsigned MAX_TEXTURE_UNITS = 32;
+
+		unsigned program = UNKNOWN;
+		unsigned vertexArray = UNKNOWN;
+		unsigned activeTextureUnit = UNKNOWN;
+		unsigned textures[MAX_TEXTURE_UNITS];
+		unsigned samplers[MAX_TEXTURE_UNITS];
+
+		CommandExecutionState()
+		{
+			for (auto& texture : textures)
+				texture = UNKNOWN;
+
+			for (auto& sampler : samplers)
+				sampler = UNKNOWN;
+		}
+	};
+
+	// CPU-side recording of GL work. Recording never touches GL, so any thread may fill a list;
+	// only Execute has to run on the thread owning the context.
+	class CommandList
+	{
+		std::vector<Command> commands;
+		std::vector<float> payload;
+
+		unsigned PushPayload(const float* values, size_t count);
+
+	public:
+		CommandList() = default;
+
+		void UseProgram(const ShaderProgram& program);
+		void BindVertexArray(const VertexArray& vertexArray);
+		// Binds the texture's sampler to the unit as well.
+		void BindTexture(unsigned unit, const Texture& texture);
+		void Enable(unsigned capability);
+		void Disable(unsigned capability);
+		void SetClearColor(const glm::vec4& color);
+		void Clear(unsigned mask);
+
+		void SetInt(int location, int value);
+		void SetFloat(int location, float value);
+		void SetVec3f(int location, const glm::vec3& value);
+		void SetVec4f(int location, const glm::vec4& value);
+		void SetMat3f(int location, const glm::mat3& value);
+		void SetMat4f(int location, const glm::mat4& value);
+
+		void SetInt(const ShaderProgram& program, const std::string& name, int value);
+		void SetFloat(const ShaderProgram& program, const std::string& name, float value);
+		void SetVec3f(const ShaderProgram& program, const std::string& name, const glm::vec3& value);
+		void SetVec4f(const ShaderProgram& program, const std::string& name, const glm::vec4& value);
+		void SetMat3f(const ShaderProgram& program, const std::string& name, const glm::mat3& value);
+		void SetMat4f(const ShaderProgram& program, const std::string& name, const glm::mat4& value);
+
+		void DrawArrays(unsigned mode, int first, int count);
+		// The byte offset into the element buffer is recorded as an int, so it is limited to 2 GiB
+		void DrawElements(unsigned mode, int count, int indexOffset = 0);
+
+		void Reset();
+
+		void Execute(CommandExecutionState& state) const;
+
+		[[nodiscard]] size_t GetCommandCount() const { return commands.size(); }
+		[[nodiscard]] bool IsEmpty() const { return commands.empty(); }
+	};
+}
@@ -0,0 +1,40 @@
+#include "CommandQueue.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace Graphics
+{
+	void CommandQueue::Submit(const unsigned key, CommandList&& list)
+	{
+		std::lock_guard lock(mutex);
+
+		entries.push_back({ key, std::move(list) });
+	}
+
+	void CommandQueue::Execute()
+	{
+		std::lock_guard lock(mutex);
+
+		std::sort(entries.begin(), entries.end(),
+			[](const Entry& left, const Entry& right) { return left.key < right.key; });
+
+		const auto duplicate = std::adjacent_find(entries.begin(), entries.end(),
+			[](const Entry& left, const Entry& right) { return left.key == right.key; });
+
+		if (duplicate != entries.end())
+		{
+			const auto errorMessage = "Command list key " + std::to_string(duplicate->key) + " was submitted twice.";
+			entries.clear();
+			throw std::runtime_error(errorMessage.c_str());
+		}
+
+		CommandExecutionState state;
+
+		for (const auto& entry : entries)
+			entry.list.Execute(state);
+
+		entries.clear();
+	}
+}
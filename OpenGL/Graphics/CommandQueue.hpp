@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "CommandList.hpp"
+
+namespace Graphics
+{
+	// Collects command lists recorded on any thread and replays them on the GL thread
+	// ordered by their submission key, regardless of which thread finished first.
+	class CommandQueue
+	{
+		struct Entry
+		{
+			unsigned key;
+			CommandList list;
+		};
+
+		std::vector<Entry> entries;
+		std::mutex mutex;
+
+	public:
+		CommandQueue() = default;
+		CommandQueue(const CommandQueue& other) = delete;
+		CommandQueue& operator=(const CommandQueue& other) = delete;
+		CommandQueue(CommandQueue&& other) = delete;
+		CommandQueue& operator=(CommandQueue&& other) = delete;
+		~CommandQueue() = default;
+
+		// Keys must be unique within a frame, lists are replayed in ascending key order.
+		void Submit(unsigned key, CommandList&& list);
+
+		// Replays and then drops every submitted list, must be called on the GL thread.
+		void Execute();
+	};
+}
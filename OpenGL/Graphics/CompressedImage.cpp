@@ -0,0 +1,315 @@
+#include "CompressedImage.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+
+//-------------------------------------------------------------------
+
+#include "../Utils/AssetPack.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	namespace
+	{
+		constexpr unsigned char KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+		constexpr size_t HEADER_SIZE = 80;
+		constexpr size_t LEVEL_INDEX_ENTRY_SIZE = 24;
+
+		const std::string ORIENTATION_KEY = "KTXorientation";
+		const std::string WRITER_KEY = "KTXwriter";
+
+		struct FormatInfo
+		{
+			CompressedFormat format;
+			const char* name;
+			size_t blockSize;
+
+			uint32_t vkFormat;
+			uint32_t vkSrgbFormat;
+
+			// Data format descriptor color model and the channel of each 64 bit half of a block
+			uint32_t colorModel;
+			std::vector<uint32_t> channels;
+		};
+
+		// Vulkan format numbers and descriptor values from the Khronos Data Format specification
+		const std::vector<FormatInfo> FORMATS =
+		{
+			{ CompressedFormat::BC1, "bc1", 8, 131, 132, 128, { 0 } },
+			{ CompressedFormat::BC3, "bc3", 16, 137, 138, 130, { 15, 0 } },
+			{ CompressedFormat::BC4, "bc4", 8, 139, 139, 131, { 0 } },
+			{ CompressedFormat::BC5, "bc5", 16, 141, 141, 132, { 0, 1 } },
+			{ CompressedFormat::BC7, "bc7", 16, 145, 146, 134, { 0 } },
+			{ CompressedFormat::ETC2, "etc2", 8, 147, 148, 161, { 2 } }
+		};
+
+		const FormatInfo& GetInfo(const CompressedFormat format)
+		{
+			return FORMATS[static_cast<size_t>(format)];
+		}
+
+		size_t AlignUp(const size_t value, const size_t alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		template <typename T>
+		void Append(std::vector<unsigned char>& bytes, const T value)
+		{
+			const auto size = bytes.size();
+			bytes.resize(size + sizeof(T));
+			std::memcpy(bytes.data() + size, &value, sizeof(T));
+		}
+
+		template <typename T>
+		T Read(const std::span<const unsigned char> bytes, const size_t offset)
+		{
+			T value;
+			std::memcpy(&value, bytes.data() + offset, sizeof(T));
+
+			return value;
+		}
+
+		void AppendKeyValue(std::vector<unsigned char>& bytes, const std::string& key, const std::string& value)
+		{
+			// Both strings are stored with their terminators
+			Append<uint32_t>(bytes, static_cast<uint32_t>(key.size() + value.size() + 2));
+			bytes.insert(bytes.end(), key.c_str(), key.c_str() + key.size() + 1);
+			bytes.insert(bytes.end(), value.c_str(), value.c_str() + value.size() + 1);
+			bytes.resize(AlignUp(bytes.size(), 4));
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	CompressedImage::CompressedImage(const CompressedFormat format, const bool isSrgb, const bool isFlippedVertically,
+		std::vector<CompressedLevel> levels, std::shared_ptr<const unsigned char> data)
+		: format(format), isSrgb(isSrgb), isFlippedVertically(isFlippedVertically), levels(std::move(levels)), data(std::move(data))
+	{
+		if (this->levels.empty())
+			throw std::runtime_error("A compressed image needs at least one level.");
+	}
+
+	//-------------------------------------------------------------------
+
+	CompressedImage CompressedImage::Load(const std::string& path)
+	{
+		const auto asset = Utils::AssetPack::Load(path);
+		const auto bytes = asset.GetBytes();
+
+		const auto fail = [&path](const std::string& reason)
+		{
+			return std::runtime_error(("Failed to load " + path + ": " + reason).c_str());
+		};
+
+		if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+			throw fail("not a KTX2 file");
+
+		const auto vkFormat = Read<uint32_t>(bytes, 12);
+		const auto width = Read<uint32_t>(bytes, 20);
+		const auto height = Read<uint32_t>(bytes, 24);
+		const auto levelCount = Read<uint32_t>(bytes, 40);
+
+		const auto info = std::find_if(FORMATS.begin(), FORMATS.end(), [vkFormat](const FormatInfo& candidate)
+		{
+			return candidate.vkFormat == vkFormat || candidate.vkSrgbFormat == vkFormat;
+		});
+
+		if (info == FORMATS.end())
+			throw fail("unsupported format " + std::to_string(vkFormat));
+
+		// Depth, layer count, face count and supercompression must describe a plain 2D texture
+		if (Read<uint32_t>(bytes, 28) != 0 || Read<uint32_t>(bytes, 32) > 1 || Read<uint32_t>(bytes, 36) != 1
+			|| Read<uint32_t>(bytes, 44) != 0)
+			throw fail("only uncompressed 2D textures are supported");
+
+		if (width == 0 || height == 0 || levelCount == 0 || levelCount > 32)
+			throw fail("invalid dimensions or level count");
+
+		if (HEADER_SIZE + levelCount * LEVEL_INDEX_ENTRY_SIZE > bytes.size())
+			throw fail("truncated level index");
+
+		std::vector<CompressedLevel> levels;
+
+		for (uint32_t i = 0; i < levelCount; i++)
+		{
+			const auto entry = HEADER_SIZE + i * LEVEL_INDEX_ENTRY_SIZE;
+
+			CompressedLevel level;
+			level.width = static_cast<int>(std::max(width >> i, 1u));
+			level.height = static_cast<int>(std::max(height >> i, 1u));
+			level.offset = static_cast<size_t>(Read<uint64_t>(bytes, entry));
+			level.size = static_cast<size_t>(Read<uint64_t>(bytes, entry + 8));
+
+			if (level.size != GetLevelSize(info->format, level.width, level.height)
+				|| level.offset > bytes.size() || level.size > bytes.size() - level.offset)
+				throw fail("level " + std::to_string(i) + " is out of bounds or has the wrong size");
+
+			levels.push_back(level);
+		}
+
+		// Images are stored top row first unless the orientation says otherwise
+		auto isFlippedVertically = false;
+
+		const auto keyValueOffset = static_cast<size_t>(Read<uint32_t>(bytes, 56));
+		const auto keyValueEnd = keyValueOffset + Read<uint32_t>(bytes, 60);
+
+		if (keyValueEnd > bytes.size())
+			throw fail("truncated key value data");
+
+		for (auto offset = keyValueOffset; offset + 4 <= keyValueEnd;)
+		{
+			const auto length = static_cast<size_t>(Read<uint32_t>(bytes, offset));
+
+			if (length > keyValueEnd - offset - 4)
+				throw fail("truncated key value data");
+
+			const auto pair = reinterpret_cast<const char*>(bytes.data() + offset + 4);
+			const std::string key(pair, strnlen(pair, length));
+
+			if (key == ORIENTATION_KEY && key.size() + 2 < length)
+				isFlippedVertically = pair[key.size() + 2] == 'u';
+
+			offset = AlignUp(offset + 4 + length, 4);
+		}
+
+		const auto isSrgb = vkFormat == info->vkSrgbFormat && info->vkSrgbFormat != info->vkFormat;
+
+		// The levels point into the mapped file, which stays mapped as long as they do
+		return { info->format, isSrgb, isFlippedVertically, std::move(levels), asset.GetPointer() };
+	}
+
+	//-------------------------------------------------------------------
+
+	void CompressedImage::Save(const std::string& path) const
+	{
+		const auto& info = GetInfo(format);
+		const auto levelCount = static_cast<uint32_t>(levels.size());
+
+		// Data format descriptor, a single basic block with one sample per 64 bits of a block
+		std::vector<unsigned char> descriptor;
+		const auto blockSize = static_cast<uint32_t>(24 + 16 * info.channels.size());
+
+		Append<uint32_t>(descriptor, 4 + blockSize);
+		Append<uint32_t>(descriptor, 0);
+		Append<uint32_t>(descriptor, 2 | blockSize << 16);
+		Append<uint32_t>(descriptor, info.colorModel | 1 << 8 | (isSrgb ? 2 : 1) << 16);
+		Append<uint32_t>(descriptor, 3 | 3 << 8);
+		Append<uint32_t>(descriptor, static_cast<uint32_t>(info.blockSize));
+		Append<uint32_t>(descriptor, 0);
+
+		for (size_t i = 0; i < info.channels.size(); i++)
+		{
+			const auto bitLength = static_cast<uint32_t>(info.blockSize * 8 / info.channels.size());
+
+			Append<uint32_t>(descriptor, static_cast<uint32_t>(i) * bitLength | (bitLength - 1) << 16 | info.channels[i] << 24);
+			Append<uint32_t>(descriptor, 0);
+			Append<uint32_t>(descriptor, 0);
+			Append<uint32_t>(descriptor, 0xFFFFFFFF);
+		}
+
+		// Keys must be sorted
+		std::vector<unsigned char> keyValues;
+		AppendKeyValue(keyValues, ORIENTATION_KEY, isFlippedVertically ? "ru" : "rd");
+		AppendKeyValue(keyValues, WRITER_KEY, "OpenGL compress");
+
+		const auto descriptorOffset = HEADER_SIZE + levelCount * LEVEL_INDEX_ENTRY_SIZE;
+		const auto keyValueOffset = descriptorOffset + descriptor.size();
+
+		// Levels go smallest first, each aligned to its block size
+		std::vector<size_t> levelOffsets(levels.size());
+		auto offset = keyValueOffset + keyValues.size();
+
+		for (auto i = levels.size(); i-- > 0;)
+		{
+			offset = AlignUp(offset, info.blockSize);
+			levelOffsets[i] = offset;
+			offset += levels[i].size;
+		}
+
+		std::vector<unsigned char> bytes(std::begin(KTX2_IDENTIFIER), std::end(KTX2_IDENTIFIER));
+		Append<uint32_t>(bytes, isSrgb ? info.vkSrgbFormat : info.vkFormat);
+		Append<uint32_t>(bytes, 1);
+		Append<uint32_t>(bytes, static_cast<uint32_t>(GetWidth()));
+		Append<uint32_t>(bytes, static_cast<uint32_t>(GetHeight()));
+		Append<uint32_t>(bytes, 0);
+		Append<uint32_t>(bytes, 0);
+		Append<uint32_t>(bytes, 1);
+		Append<uint32_t>(bytes, levelCount);
+		Append<uint32_t>(bytes, 0);
+
+		Append<uint32_t>(bytes, static_cast<uint32_t>(descriptorOffset));
+		Append<uint32_t>(bytes, static_cast<uint32_t>(descriptor.size()));
+		Append<uint32_t>(bytes, static_cast<uint32_t>(keyValueOffset));
+		Append<uint32_t>(bytes, static_cast<uint32_t>(keyValues.size()));
+		Append<uint64_t>(bytes, 0);
+		Append<uint64_t>(bytes, 0);
+
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			Append<uint64_t>(bytes, levelOffsets[i]);
+			Append<uint64_t>(bytes, levels[i].size);
+			Append<uint64_t>(bytes, levels[i].size);
+		}
+
+		bytes.insert(bytes.end(), descriptor.begin(), descriptor.end());
+		bytes.insert(bytes.end(), keyValues.begin(), keyValues.end());
+
+		for (auto i = levels.size(); i-- > 0;)
+		{
+			bytes.resize(levelOffsets[i]);
+			bytes.insert(bytes.end(), data.get() + levels[i].offset, data.get() + levels[i].offset + levels[i].size);
+		}
+
+		std::ofstream file(path, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+		if (!file)
+			throw std::runtime_error(("Failed to write " + path).c_str());
+	}
+
+	//-------------------------------------------------------------------
+
+	size_t CompressedImage::GetSize() const
+	{
+		size_t size = 0;
+
+		for (const auto& level : levels)
+			size += level.size;
+
+		return size;
+	}
+
+	//-------------------------------------------------------------------
+
+	const char* CompressedImage::GetFormatName(const CompressedFormat format)
+	{
+		return GetInfo(format).name;
+	}
+
+	//-------------------------------------------------------------------
+
+	size_t CompressedImage::GetBlockSize(const CompressedFormat format)
+	{
+		return GetInfo(format).blockSize;
+	}
+
+	//-------------------------------------------------------------------
+
+	size_t CompressedImage::GetLevelSize(const CompressedFormat format, const int width, const int height)
+	{
+		const auto blocksX = static_cast<size_t>(width + 3) / 4;
+		const auto blocksY = static_cast<size_t>(height + 3) / 4;
+
+		return blocksX * blocksY * GetBlockSize(format);
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	// Block compressed formats, each encodes blocks of 4x4 texels
+	enum class CompressedFormat
+	{
+		BC1,	// RGB, 8 bytes per block
+		BC3,	// RGBA, BC1 color plus an 8 byte alpha block
+		BC4,	// R, 8 bytes per block
+		BC5,	// RG, two BC4 blocks
+		BC7,	// RGBA, 16 bytes per block, the highest quality
+		ETC2	// RGB, 8 bytes per block
+	};
+
+	struct CompressedLevel
+	{
+		int width = 0;
+		int height = 0;
+
+		// Into the image's data
+		size_t offset = 0;
+		size_t size = 0;
+	};
+
+	// A mip chain of block compressed data, as written by the compress tool into a KTX2 file.
+	class CompressedImage
+	{
+		CompressedFormat format = CompressedFormat::BC1;
+		bool isSrgb = false;
+
+		// Rows run bottom to top, as GL expects them, rather than top to bottom
+		bool isFlippedVertically = false;
+
+		std::vector<CompressedLevel> levels;
+		std::shared_ptr<const unsigned char> data;
+
+	public:
+		CompressedImage() = default;
+		CompressedImage(CompressedFormat format, bool isSrgb, bool isFlippedVertically,
+			std::vector<CompressedLevel> levels, std::shared_ptr<const unsigned char> data);
+
+		// Throws when the file is not a KTX2 file this class could have written.
+		static CompressedImage Load(const std::string& path);
+		void Save(const std::string& path) const;
+
+		[[nodiscard]] CompressedFormat GetFormat() const { return format; }
+		[[nodiscard]] bool GetIsSrgb() const { return isSrgb; }
+		[[nodiscard]] bool GetIsFlippedVertically() const { return isFlippedVertically; }
+		[[nodiscard]] int GetWidth() const { return levels.front().width; }
+		[[nodiscard]] int GetHeight() const { return levels.front().height; }
+		[[nodiscard]] const std::vector<CompressedLevel>& GetLevels() const { return levels; }
+		[[nodiscard]] const unsigned char* GetData() const { return data.get(); }
+		[[nodiscard]] size_t GetSize() const;
+
+		[[nodiscard]] static const char* GetFormatName(CompressedFormat format);
+		[[nodiscard]] static size_t GetBlockSize(CompressedFormat format);
+		[[nodiscard]] static size_t GetLevelSize(CompressedFormat format, int width, int height);
+	};
+}
@@ -2,18 +2,26 @@
 
 #include <glad/glad.h>
 
+#include "GLDebug.hpp"
+#include "GLExtensions.hpp"
+#include "GpuMemoryTracker.hpp"
+
 namespace Graphics
 {
-	ElementBuffer::ElementBuffer(const unsigned* data, int count)
+	ElementBuffer::ElementBuffer(const unsigned* data, int count, std::string name, const GpuAllocationSite site)
 		:count(count)
 	{
 		glGenBuffers(1, &id);
 
 		Bind();
 
+		GLDebug::SetObjectLabel(GL_BUFFER, id, name);
+
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned), data, GL_STATIC_DRAW);
 
 		Unbind();
+
+		GpuMemoryTracker::Register(GpuMemoryCategory::ELEMENT_BUFFER, id, count * sizeof(unsigned), std::move(name), site);
 	}
 
 	ElementBuffer::ElementBuffer(ElementBuffer&& other) noexcept
@@ -27,6 +35,8 @@ namespace Graphics
 	{
 		if (this != &other)
 		{
+			Delete();
+
 			id = other.id;
 			count = other.count;
 
@@ -54,6 +64,7 @@ namespace Graphics
 
 	void ElementBuffer::Delete() const
 	{
+		GpuMemoryTracker::Unregister(GpuMemoryCategory::ELEMENT_BUFFER, id);
 		glDeleteBuffers(1, &id);
 	}
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <string>
+
+#include "GpuMemoryTracker.hpp"
+
 namespace Graphics
 {
 	class ElementBuffer
@@ -10,7 +14,8 @@ namespace Graphics
 		void Delete() const;
 	
 	public:
-		ElementBuffer(const unsigned* data, int count);
+		ElementBuffer(const unsigned* data, int count, std::string name = "element buffer",
+			GpuAllocationSite site = GpuAllocationSite::Current());
 		ElementBuffer(const ElementBuffer& other) = delete;
 		ElementBuffer& operator=(const ElementBuffer& other) = delete;
 		ElementBuffer(ElementBuffer&& other) noexcept;
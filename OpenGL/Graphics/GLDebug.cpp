@@ -0,0 +1,285 @@
+#include "GLDebug.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+//-------------------------------------------------------------------
+
+#include "GLExtensions.hpp"
+#include "../Utils/CpuProfiler.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	namespace
+	{
+		// The callback may run on any thread the driver chooses unless output is synchronous
+		std::mutex mutex;
+
+		bool isInstalled = false;
+		GLint maxLabelLength = 0;
+
+		GLDebugFrameStats currentFrame;
+		GLDebugFrameStats lastFrame;
+		GLDebugFrameStats totals;
+
+		std::vector<GLDebugMessage> messages;
+		std::unordered_map<std::string, size_t> messageIndices;
+
+		// Trace markers need names that outlive the capture
+		constexpr const char* TRACE_NAMES[] =
+		{
+			"GL error",
+			"GL undefined behavior",
+			"GL deprecated",
+			"GL portability",
+			"GL performance warning",
+			"GL message"
+		};
+
+		GLDebugCategory Classify(const GLenum type)
+		{
+			switch (type)
+			{
+			case GL_DEBUG_TYPE_ERROR:
+				return GLDebugCategory::API_ERROR;
+			case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+				return GLDebugCategory::UNDEFINED_BEHAVIOR;
+			case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+				return GLDebugCategory::DEPRECATED;
+			case GL_DEBUG_TYPE_PORTABILITY:
+				return GLDebugCategory::PORTABILITY;
+			case GL_DEBUG_TYPE_PERFORMANCE:
+				return GLDebugCategory::PERFORMANCE;
+			default:
+				return GLDebugCategory::OTHER;
+			}
+		}
+
+		void APIENTRY OnDebugMessage(const GLenum source, const GLenum type, const GLuint id, const GLenum severity,
+			const GLsizei length, const GLchar* message, const void* /*userParam*/)
+		{
+			const auto category = Classify(type);
+			const auto now = Utils::CpuProfiler::Now();
+
+			Utils::CpuProfiler::Record(TRACE_NAMES[static_cast<size_t>(category)], now, now);
+
+			const std::string text(message, length >= 0 ? static_cast<size_t>(length) : std::char_traits<char>::length(message));
+
+			const std::lock_guard lock(mutex);
+
+			currentFrame.messageCounts[static_cast<size_t>(category)]++;
+			totals.messageCounts[static_cast<size_t>(category)]++;
+
+			// Drivers reuse ids for messages about different objects, the text tells them apart
+			auto key = std::to_string(source) + ":" + std::to_string(type) + ":" + std::to_string(id) + ":" + text;
+			const auto found = messageIndices.find(key);
+
+			if (found != messageIndices.end())
+			{
+				messages[found->second].totalCount++;
+				return;
+			}
+
+			if (messages.size() >= GLDebug::MAX_MESSAGES)
+				return;
+
+			messageIndices.emplace(std::move(key), messages.size());
+			messages.push_back({ category, source, type, id, severity, text, currentFrame.frameIndex, 1 });
+
+			std::cout << GLDebug::GetCategoryName(category) << " (" << GLDebug::GetSeverityName(severity) << "): " << text << std::endl;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	bool GLDebug::Install()
+	{
+		if (isInstalled)
+			return true;
+
+		if (!GLExtensions::GetHasDebugOutput())
+			return false;
+
+		const auto& gl = GLExtensions::GetFunctions();
+
+		glGetIntegerv(GL_MAX_LABEL_LENGTH, &maxLabelLength);
+
+		{
+			const std::lock_guard lock(mutex);
+
+			currentFrame = GLDebugFrameStats();
+			lastFrame = GLDebugFrameStats();
+			totals = GLDebugFrameStats();
+			messages.clear();
+			messageIndices.clear();
+		}
+
+		gl.debugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+		gl.debugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+		gl.debugMessageCallback(OnDebugMessage, nullptr);
+
+		glEnable(GL_DEBUG_OUTPUT);
+
+		// Messages then arrive inside the offending call, so they land in the right frame and CPU zone
+		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+
+		isInstalled = true;
+		return true;
+	}
+
+	//-------------------------------------------------------------------
+
+	void GLDebug::Uninstall()
+	{
+		if (!isInstalled)
+			return;
+
+		glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		glDisable(GL_DEBUG_OUTPUT);
+
+		GLExtensions::GetFunctions().debugMessageCallback(nullptr, nullptr);
+
+		isInstalled = false;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool GLDebug::GetIsInstalled()
+	{
+		return isInstalled;
+	}
+
+	//-------------------------------------------------------------------
+
+	void GLDebug::EndFrame()
+	{
+		const std::lock_guard lock(mutex);
+
+		lastFrame = currentFrame;
+
+		currentFrame = GLDebugFrameStats();
+		currentFrame.frameIndex = lastFrame.frameIndex + 1;
+	}
+
+	//-------------------------------------------------------------------
+
+	GLDebugFrameStats GLDebug::GetLastFrame()
+	{
+		const std::lock_guard lock(mutex);
+		return lastFrame;
+	}
+
+	//-------------------------------------------------------------------
+
+	GLDebugFrameStats GLDebug::GetTotals()
+	{
+		const std::lock_guard lock(mutex);
+		return totals;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<GLDebugMessage> GLDebug::GetMessages()
+	{
+		std::vector<GLDebugMessage> result;
+
+		{
+			const std::lock_guard lock(mutex);
+			result = messages;
+		}
+
+		std::stable_sort(result.begin(), result.end(),
+			[](const GLDebugMessage& a, const GLDebugMessage& b) { return a.totalCount > b.totalCount; });
+
+		return result;
+	}
+
+	//-------------------------------------------------------------------
+
+	void GLDebug::PrintReport(std::ostream& stream)
+	{
+		if (!isInstalled)
+			return;
+
+		const auto messageTotals = GetTotals();
+
+		stream << "GL debug messages:";
+
+		for (size_t category = 0; category < static_cast<size_t>(GLDebugCategory::COUNT); category++)
+			stream << " " << GetCategoryName(static_cast<GLDebugCategory>(category)) << " " << messageTotals.messageCounts[category];
+
+		stream << std::endl;
+
+		for (const auto& message : GetMessages())
+			stream << "  " << message.totalCount << "x " << GetCategoryName(message.category)
+				<< " since frame " << message.firstFrame << ": " << message.text << std::endl;
+	}
+
+	//-------------------------------------------------------------------
+
+	void GLDebug::SetObjectLabel(const unsigned identifier, const unsigned name, const std::string& label)
+	{
+		const auto objectLabel = GLExtensions::GetFunctions().objectLabel;
+
+		if (objectLabel == nullptr || name == 0)
+			return;
+
+		if (maxLabelLength == 0)
+			glGetIntegerv(GL_MAX_LABEL_LENGTH, &maxLabelLength);
+
+		// Longer labels are an error, keep the end since it names the file
+		const auto length = std::min(label.size(), static_cast<size_t>(std::max(maxLabelLength - 1, 0)));
+
+		objectLabel(identifier, name, static_cast<GLsizei>(length), label.c_str() + label.size() - length);
+	}
+
+	//-------------------------------------------------------------------
+
+	const char* GLDebug::GetCategoryName(const GLDebugCategory category)
+	{
+		switch (category)
+		{
+		case GLDebugCategory::API_ERROR:
+			return "error";
+		case GLDebugCategory::UNDEFINED_BEHAVIOR:
+			return "undefined behavior";
+		case GLDebugCategory::DEPRECATED:
+			return "deprecated";
+		case GLDebugCategory::PORTABILITY:
+			return "portability";
+		case GLDebugCategory::PERFORMANCE:
+			return "performance";
+		case GLDebugCategory::OTHER:
+			return "other";
+		case GLDebugCategory::COUNT:
+			break;
+		}
+
+		return "unknown";
+	}
+
+	//-------------------------------------------------------------------
+
+	const char* GLDebug::GetSeverityName(const unsigned severity)
+	{
+		switch (severity)
+		{
+		case GL_DEBUG_SEVERITY_HIGH:
+			return "high";
+		case GL_DEBUG_SEVERITY_MEDIUM:
+			return "medium";
+		case GL_DEBUG_SEVERITY_LOW:
+			return "low";
+		case GL_DEBUG_SEVERITY_NOTIFICATION:
+			return "notification";
+		default:
+			return "unknown";
+		}
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	enum class GLDebugCategory
+	{
+		API_ERROR,
+		UNDEFINED_BEHAVIOR,
+		DEPRECATED,
+		PORTABILITY,
+		PERFORMANCE,
+		OTHER,
+		COUNT
+	};
+
+	struct GLDebugFrameStats
+	{
+		uint64_t frameIndex = 0;
+		std::array<uint64_t, static_cast<size_t>(GLDebugCategory::COUNT)> messageCounts = {};
+
+		[[nodiscard]] uint64_t GetCount(GLDebugCategory category) const { return messageCounts[static_cast<size_t>(category)]; }
+	};
+
+	// A distinct driver message, repeats only increase the counts
+	struct GLDebugMessage
+	{
+		GLDebugCategory category = GLDebugCategory::OTHER;
+		unsigned source = 0;
+		unsigned type = 0;
+		unsigned id = 0;
+		unsigned severity = 0;
+		std::string text;
+
+		uint64_t firstFrame = 0;
+		uint64_t totalCount = 0;
+	};
+
+	// Receives KHR_debug messages from the driver. Each distinct message is printed once, then
+	// only counted, per frame and in total, and marks the CPU trace when a capture is running.
+	// Messages are only guaranteed in debug contexts, see Utils::Window::SetIsDebugContextEnabled.
+	class GLDebug
+	{
+	public:
+		// Distinct messages beyond this are counted but not kept
+		static constexpr size_t MAX_MESSAGES = 256;
+
+		// Returns false when the context does not support debug output. Notifications are filtered
+		// out, they are informational and some drivers send one for every buffer allocation.
+		static bool Install();
+		static void Uninstall();
+
+		[[nodiscard]] static bool GetIsInstalled();
+
+		// Closes the frame being counted, must be called on the thread owning the context.
+		static void EndFrame();
+
+		[[nodiscard]] static GLDebugFrameStats GetLastFrame();
+		[[nodiscard]] static GLDebugFrameStats GetTotals();
+
+		// Distinct messages seen so far, most frequent first.
+		[[nodiscard]] static std::vector<GLDebugMessage> GetMessages();
+
+		static void PrintReport(std::ostream& stream);
+
+		// Names a GL object in driver messages and graphics debuggers, does nothing without debug output.
+		static void SetObjectLabel(unsigned identifier, unsigned name, const std::string& label);
+
+		[[nodiscard]] static const char* GetCategoryName(GLDebugCategory category);
+		[[nodiscard]] static const char* GetSeverityName(unsigned severity);
+	};
+}
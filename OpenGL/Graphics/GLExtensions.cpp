@@ -0,0 +1,103 @@
+#include "GLExtensions.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	namespace
+	{
+		std::vector<std::string> extensions;
+		GLExtensionFunctions functions;
+
+		bool hasDebugOutput = false;
+
+		template <typename T>
+		T LoadFunction(const GLADloadproc loader, const char* name)
+		{
+			return reinterpret_cast<T>(loader(name));
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void GLExtensions::Load(const GLADloadproc loader)
+	{
+		extensions.clear();
+		functions = GLExtensionFunctions();
+
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+		for (GLint i = 0; i < count; i++)
+			extensions.emplace_back(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)));
+
+		std::sort(extensions.begin(), extensions.end());
+
+		// KHR_debug uses unsuffixed names in core profile contexts
+		if (IsVersionAtLeast(4, 3) || IsSupported("GL_KHR_debug"))
+		{
+			functions.debugMessageCallback = LoadFunction<PFNGLDEBUGMESSAGECALLBACKPROC>(loader, "glDebugMessageCallback");
+			functions.debugMessageControl = LoadFunction<PFNGLDEBUGMESSAGECONTROLPROC>(loader, "glDebugMessageControl");
+			functions.objectLabel = LoadFunction<PFNGLOBJECTLABELPROC>(loader, "glObjectLabel");
+		}
+
+		hasDebugOutput = functions.debugMessageCallback != nullptr && functions.debugMessageControl != nullptr
+			&& functions.objectLabel != nullptr;
+
+		if (IsVersionAtLeast(4, 4) || IsSupported("GL_ARB_buffer_storage"))
+			functions.bufferStorage = LoadFunction<PFNGLBUFFERSTORAGEPROC>(loader, "glBufferStorage");
+
+		if (IsVersionAtLeast(4, 2) || IsSupported("GL_ARB_texture_storage"))
+		{
+			functions.texStorage2D = LoadFunction<PFNGLTEXSTORAGE2DPROC>(loader, "glTexStorage2D");
+			functions.texStorage3D = LoadFunction<PFNGLTEXSTORAGE3DPROC>(loader, "glTexStorage3D");
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	bool GLExtensions::IsSupported(const std::string& extension)
+	{
+		return std::binary_search(extensions.begin(), extensions.end(), extension);
+	}
+
+	//-------------------------------------------------------------------
+
+	bool GLExtensions::IsVersionAtLeast(const int major, const int minor)
+	{
+		return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+	}
+
+	//-------------------------------------------------------------------
+
+	bool GLExtensions::GetHasDebugOutput()
+	{
+		return hasDebugOutput;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool GLExtensions::GetHasBufferStorage()
+	{
+		return functions.bufferStorage != nullptr;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool GLExtensions::GetHasTextureStorage()
+	{
+		return functions.texStorage2D != nullptr && functions.texStorage3D != nullptr;
+	}
+
+	//-------------------------------------------------------------------
+
+	const GLExtensionFunctions& GLExtensions::GetFunctions()
+	{
+		return functions;
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <glad/glad.h>
+
+#include <string>
+
+//-------------------------------------------------------------------
+
+// glad is generated for the 3.3 core profile only, the constants of newer versions and
+// extensions used by the engine are declared here.
+
+#ifndef GL_DEBUG_OUTPUT
+#define GL_DEBUG_OUTPUT 0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_CONTEXT_FLAG_DEBUG_BIT 0x00000002
+#define GL_MAX_LABEL_LENGTH 0x82E8
+
+#define GL_DEBUG_SOURCE_API 0x8246
+#define GL_DEBUG_SOURCE_WINDOW_SYSTEM 0x8247
+#define GL_DEBUG_SOURCE_SHADER_COMPILER 0x8248
+#define GL_DEBUG_SOURCE_THIRD_PARTY 0x8249
+#define GL_DEBUG_SOURCE_APPLICATION 0x824A
+#define GL_DEBUG_SOURCE_OTHER 0x824B
+
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR 0x824D
+#define GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR 0x824E
+#define GL_DEBUG_TYPE_PORTABILITY 0x824F
+#define GL_DEBUG_TYPE_PERFORMANCE 0x8250
+#define GL_DEBUG_TYPE_OTHER 0x8251
+#define GL_DEBUG_TYPE_MARKER 0x8268
+#define GL_DEBUG_TYPE_PUSH_GROUP 0x8269
+#define GL_DEBUG_TYPE_POP_GROUP 0x826A
+
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+
+#define GL_BUFFER 0x82E0
+#define GL_SHADER 0x82E1
+#define GL_PROGRAM 0x82E2
+#define GL_VERTEX_ARRAY 0x8074
+#define GL_QUERY 0x82E3
+#define GL_SAMPLER 0x82E6
+#endif
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#endif
+
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#define GL_COMPRESSED_SRGB8_ETC2 0x9275
+#endif
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	using PFNGLDEBUGMESSAGECALLBACKPROC = void (APIENTRYP)(GLDEBUGPROC callback, const void* userParam);
+	using PFNGLDEBUGMESSAGECONTROLPROC = void (APIENTRYP)(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint* ids, GLboolean enabled);
+	using PFNGLOBJECTLABELPROC = void (APIENTRYP)(GLenum identifier, GLuint name, GLsizei length, const GLchar* label);
+	using PFNGLBUFFERSTORAGEPROC = void (APIENTRYP)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+	using PFNGLTEXSTORAGE2DPROC = void (APIENTRYP)(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height);
+	using PFNGLTEXSTORAGE3DPROC = void (APIENTRYP)(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth);
+
+	// Entry points glad does not load, null when the driver does not provide them
+	struct GLExtensionFunctions
+	{
+		PFNGLDEBUGMESSAGECALLBACKPROC debugMessageCallback = nullptr;
+		PFNGLDEBUGMESSAGECONTROLPROC debugMessageControl = nullptr;
+		PFNGLOBJECTLABELPROC objectLabel = nullptr;
+		PFNGLBUFFERSTORAGEPROC bufferStorage = nullptr;
+		PFNGLTEXSTORAGE2DPROC texStorage2D = nullptr;
+		PFNGLTEXSTORAGE3DPROC texStorage3D = nullptr;
+	};
+
+	class GLExtensions
+	{
+	public:
+		// Must be called right after glad, with the same loader, on the thread owning the context.
+		static void Load(GLADloadproc loader);
+
+		[[nodiscard]] static bool IsSupported(const std::string& extension);
+		[[nodiscard]] static bool IsVersionAtLeast(int major, int minor);
+
+		// GL 4.3 or KHR_debug, needed for debug callbacks and object labels
+		[[nodiscard]] static bool GetHasDebugOutput();
+
+		// GL 4.4 or ARB_buffer_storage, needed for persistently mapped buffers
+		[[nodiscard]] static bool GetHasBufferStorage();
+
+		// GL 4.2 or ARB_texture_storage, needed for immutable texture storage
+		[[nodiscard]] static bool GetHasTextureStorage();
+
+		[[nodiscard]] static const GLExtensionFunctions& GetFunctions();
+	};
+}
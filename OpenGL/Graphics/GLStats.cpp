@@ -0,0 +1,488 @@
+#include "GLStats.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <DbgHelp.h>
+#pragma comment(lib, "Dbghelp.lib")
+#else
+#include <dlfcn.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define GL_STATS_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define GL_STATS_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <glad/glad.h>
+
+namespace Graphics
+{
+	namespace
+	{
+		struct CallSite
+		{
+			const void* returnAddress = nullptr;
+			const char* function = nullptr;
+			uint64_t currentFrameCalls = 0;
+			uint64_t lastFrameCalls = 0;
+			uint64_t totalCalls = 0;
+		};
+
+		bool isInstalled = false;
+		bool isPaused = false;
+		GLFrameStats currentFrame;
+		GLuint pixelUnpackBuffer = 0;
+
+		std::atomic<bool> isCallSiteTrackingEnabled = false;
+
+		// Open addressing on the return address, only the GL thread touches it
+		std::vector<CallSite> callSites;
+		size_t usedCallSites = 0;
+
+		// Published by EndFrame for readers on other threads
+		std::mutex publishedMutex;
+		GLFrameStats lastFrame;
+		std::vector<CallSite> publishedCallSites;
+
+		void RecordCallSite(const void* returnAddress, const char* function)
+		{
+			if (!isCallSiteTrackingEnabled.load(std::memory_order_relaxed))
+				return;
+
+			if (callSites.empty())
+				callSites.resize(GLStats::MAX_CALL_SITES);
+
+			auto index = (reinterpret_cast<uintptr_t>(returnAddress) >> 2) % callSites.size();
+
+			while (callSites[index].returnAddress != returnAddress)
+			{
+				if (callSites[index].returnAddress == nullptr)
+				{
+					// Keep a free slot so probing always terminates
+					if (usedCallSites + 1 == callSites.size())
+						return;
+
+					callSites[index].returnAddress = returnAddress;
+					callSites[index].function = function;
+					usedCallSites++;
+					break;
+				}
+
+				index = (index + 1) % callSites.size();
+			}
+
+			callSites[index].currentFrameCalls++;
+			callSites[index].totalCalls++;
+		}
+
+		std::string DescribeAddress(const void* address)
+		{
+			std::ostringstream description;
+
+#ifdef _WIN32
+			static std::once_flag symbolsLoaded;
+			std::call_once(symbolsLoaded, [] { SymInitialize(GetCurrentProcess(), nullptr, TRUE); });
+
+			char symbolStorage[sizeof(SYMBOL_INFO) + MAX_SYM_NAME] = {};
+			const auto symbol = reinterpret_cast<SYMBOL_INFO*>(symbolStorage);
+			symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+			symbol->MaxNameLen = MAX_SYM_NAME;
+
+			const auto process = GetCurrentProcess();
+			const auto address64 = reinterpret_cast<DWORD64>(address);
+
+			DWORD lineDisplacement = 0;
+			IMAGEHLP_LINE64 line = {};
+			line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+
+			if (SymFromAddr(process, address64, nullptr, symbol))
+				description << symbol->Name;
+			else
+				description << address;
+
+			if (SymGetLineFromAddr64(process, address64, &lineDisplacement, &line))
+				description << " (" << line.FileName << ":" << line.LineNumber << ")";
+#else
+			Dl_info info = {};
+
+			if (dladdr(address, &info) != 0 && info.dli_sname != nullptr)
+				description << info.dli_sname << "+" << (static_cast<const char*>(address) - static_cast<const char*>(info.dli_saddr));
+			else
+				description << address;
+#endif
+
+			return description.str();
+		}
+
+		uint64_t GetPixelSize(const GLenum format, const GLenum type)
+		{
+			switch (type)
+			{
+			case GL_UNSIGNED_BYTE_3_3_2:
+			case GL_UNSIGNED_BYTE_2_3_3_REV:
+				return 1;
+			case GL_UNSIGNED_SHORT_5_6_5:
+			case GL_UNSIGNED_SHORT_5_6_5_REV:
+			case GL_UNSIGNED_SHORT_4_4_4_4:
+			case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+			case GL_UNSIGNED_SHORT_5_5_5_1:
+			case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+				return 2;
+			case GL_UNSIGNED_INT_8_8_8_8:
+			case GL_UNSIGNED_INT_8_8_8_8_REV:
+			case GL_UNSIGNED_INT_10_10_10_2:
+			case GL_UNSIGNED_INT_2_10_10_10_REV:
+			case GL_UNSIGNED_INT_24_8:
+			case GL_UNSIGNED_INT_10F_11F_11F_REV:
+			case GL_UNSIGNED_INT_5_9_9_9_REV:
+				return 4;
+			case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+				return 8;
+			default:
+				break;
+			}
+
+			uint64_t componentSize = 1;
+
+			switch (type)
+			{
+			case GL_SHORT:
+			case GL_UNSIGNED_SHORT:
+			case GL_HALF_FLOAT:
+				componentSize = 2;
+				break;
+			case GL_INT:
+			case GL_UNSIGNED_INT:
+			case GL_FLOAT:
+				componentSize = 4;
+				break;
+			default:
+				break;
+			}
+
+			switch (format)
+			{
+			case GL_RG:
+			case GL_RG_INTEGER:
+				return componentSize * 2;
+			case GL_RGB:
+			case GL_BGR:
+			case GL_RGB_INTEGER:
+			case GL_BGR_INTEGER:
+				return componentSize * 3;
+			case GL_RGBA:
+			case GL_BGRA:
+			case GL_RGBA_INTEGER:
+			case GL_BGRA_INTEGER:
+				return componentSize * 4;
+			default:
+				return componentSize;
+			}
+		}
+
+		// Texture calls only transfer data when given client memory or a bound unpack buffer
+		uint64_t GetTextureBytes(const GLsizei width, const GLsizei height, const GLsizei depth,
+			const GLenum format, const GLenum type, const void* pixels)
+		{
+			if (pixels == nullptr && pixelUnpackBuffer == 0)
+				return 0;
+
+			return static_cast<uint64_t>(width) * height * depth * GetPixelSize(format, type);
+		}
+
+		// Each wrapped entry point keeps the pointer glad loaded and forwards to it
+#define GL_STATS_WRAP(function, parameters, arguments, counting) \
+		decltype(glad_##function) original_##function = nullptr; \
+		void APIENTRY Counting_##function parameters \
+		{ \
+			if (!isPaused) \
+			{ \
+				RecordCallSite(GL_STATS_RETURN_ADDRESS(), #function); \
+				counting; \
+			} \
+			original_##function arguments; \
+		}
+
+		GL_STATS_WRAP(glDrawArrays, (GLenum mode, GLint first, GLsizei count),
+			(mode, first, count), currentFrame.drawCalls++)
+		GL_STATS_WRAP(glDrawElements, (GLenum mode, GLsizei count, GLenum type, const void* indices),
+			(mode, count, type, indices), currentFrame.drawCalls++)
+		GL_STATS_WRAP(glDrawRangeElements, (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void* indices),
+			(mode, start, end, count, type, indices), currentFrame.drawCalls++)
+		GL_STATS_WRAP(glDrawArraysInstanced, (GLenum mode, GLint first, GLsizei count, GLsizei instanceCount),
+			(mode, first, count, instanceCount), currentFrame.drawCalls++)
+		GL_STATS_WRAP(glDrawElementsInstanced, (GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount),
+			(mode, count, type, indices, instanceCount), currentFrame.drawCalls++)
+		GL_STATS_WRAP(glDrawElementsBaseVertex, (GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex),
+			(mode, count, type, indices, baseVertex), currentFrame.drawCalls++)
+		GL_STATS_WRAP(glMultiDrawArrays, (GLenum mode, const GLint* first, const GLsizei* count, GLsizei drawCount),
+			(mode, first, count, drawCount), currentFrame.drawCalls += drawCount)
+		GL_STATS_WRAP(glMultiDrawElements, (GLenum mode, const GLsizei* count, GLenum type, const void* const* indices, GLsizei drawCount),
+			(mode, count, type, indices, drawCount), currentFrame.drawCalls += drawCount)
+
+		GL_STATS_WRAP(glUseProgram, (GLuint program),
+			(program), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glBindVertexArray, (GLuint array),
+			(array), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glBindTexture, (GLenum target, GLuint texture),
+			(target, texture), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glActiveTexture, (GLenum texture),
+			(texture), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glBindSampler, (GLuint unit, GLuint sampler),
+			(unit, sampler), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glBindFramebuffer, (GLenum target, GLuint framebuffer),
+			(target, framebuffer), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glEnable, (GLenum capability),
+			(capability), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glDisable, (GLenum capability),
+			(capability), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glBlendFunc, (GLenum source, GLenum destination),
+			(source, destination), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glDepthFunc, (GLenum function),
+			(function), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glDepthMask, (GLboolean flag),
+			(flag), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glCullFace, (GLenum mode),
+			(mode), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glViewport, (GLint x, GLint y, GLsizei width, GLsizei height),
+			(x, y, width, height), currentFrame.stateChanges++)
+		GL_STATS_WRAP(glBindBuffer, (GLenum target, GLuint buffer),
+			(target, buffer), currentFrame.stateChanges++; if (target == GL_PIXEL_UNPACK_BUFFER) pixelUnpackBuffer = buffer)
+
+		GL_STATS_WRAP(glUniform1i, (GLint location, GLint v0),
+			(location, v0), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform2i, (GLint location, GLint v0, GLint v1),
+			(location, v0, v1), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform3i, (GLint location, GLint v0, GLint v1, GLint v2),
+			(location, v0, v1, v2), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform4i, (GLint location, GLint v0, GLint v1, GLint v2, GLint v3),
+			(location, v0, v1, v2, v3), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform1f, (GLint location, GLfloat v0),
+			(location, v0), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform2f, (GLint location, GLfloat v0, GLfloat v1),
+			(location, v0, v1), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform3f, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2),
+			(location, v0, v1, v2), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform4f, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3),
+			(location, v0, v1, v2, v3), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform1iv, (GLint location, GLsizei count, const GLint* value),
+			(location, count, value), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform1fv, (GLint location, GLsizei count, const GLfloat* value),
+			(location, count, value), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform2fv, (GLint location, GLsizei count, const GLfloat* value),
+			(location, count, value), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform3fv, (GLint location, GLsizei count, const GLfloat* value),
+			(location, count, value), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniform4fv, (GLint location, GLsizei count, const GLfloat* value),
+			(location, count, value), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniformMatrix3fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value),
+			(location, count, transpose, value), currentFrame.uniformUploads++)
+		GL_STATS_WRAP(glUniformMatrix4fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value),
+			(location, count, transpose, value), currentFrame.uniformUploads++)
+
+		GL_STATS_WRAP(glBufferData, (GLenum target, GLsizeiptr size, const void* data, GLenum usage),
+			(target, size, data, usage), if (data != nullptr) currentFrame.bufferBytes += size)
+		GL_STATS_WRAP(glBufferSubData, (GLenum target, GLintptr offset, GLsizeiptr size, const void* data),
+			(target, offset, size, data), currentFrame.bufferBytes += size)
+		GL_STATS_WRAP(glTexImage2D, (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels),
+			(target, level, internalFormat, width, height, border, format, type, pixels),
+			currentFrame.textureBytes += GetTextureBytes(width, height, 1, format, type, pixels))
+		GL_STATS_WRAP(glTexSubImage2D, (GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels),
+			(target, level, x, y, width, height, format, type, pixels),
+			currentFrame.textureBytes += GetTextureBytes(width, height, 1, format, type, pixels))
+		GL_STATS_WRAP(glTexImage3D, (GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels),
+			(target, level, internalFormat, width, height, depth, border, format, type, pixels),
+			currentFrame.textureBytes += GetTextureBytes(width, height, depth, format, type, pixels))
+		GL_STATS_WRAP(glTexSubImage3D, (GLenum target, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* pixels),
+			(target, level, x, y, z, width, height, depth, format, type, pixels),
+			currentFrame.textureBytes += GetTextureBytes(width, height, depth, format, type, pixels))
+		GL_STATS_WRAP(glCompressedTexImage2D, (GLenum target, GLint level, GLenum internalFormat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data),
+			(target, level, internalFormat, width, height, border, imageSize, data),
+			currentFrame.textureBytes += imageSize)
+		GL_STATS_WRAP(glCompressedTexSubImage2D, (GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void* data),
+			(target, level, x, y, width, height, format, imageSize, data),
+			currentFrame.textureBytes += imageSize)
+
+#undef GL_STATS_WRAP
+	}
+
+#define GL_STATS_FOR_EACH_WRAPPED(action) \
+	action(glDrawArrays) \
+	action(glDrawElements) \
+	action(glDrawRangeElements) \
+	action(glDrawArraysInstanced) \
+	action(glDrawElementsInstanced) \
+	action(glDrawElementsBaseVertex) \
+	action(glMultiDrawArrays) \
+	action(glMultiDrawElements) \
+	action(glUseProgram) \
+	action(glBindVertexArray) \
+	action(glBindTexture) \
+	action(glActiveTexture) \
+	action(glBindSampler) \
+	action(glBindFramebuffer) \
+	action(glEnable) \
+	action(glDisable) \
+	action(glBlendFunc) \
+	action(glDepthFunc) \
+	action(glDepthMask) \
+	action(glCullFace) \
+	action(glViewport) \
+	action(glBindBuffer) \
+	action(glUniform1i) \
+	action(glUniform2i) \
+	action(glUniform3i) \
+	action(glUniform4i) \
+	action(glUniform1f) \
+	action(glUniform2f) \
+	action(glUniform3f) \
+	action(glUniform4f) \
+	action(glUniform1iv) \
+	action(glUniform1fv) \
+	action(glUniform2fv) \
+	action(glUniform3fv) \
+	action(glUniform4fv) \
+	action(glUniformMatrix3fv) \
+	action(glUniformMatrix4fv) \
+	action(glBufferData) \
+	action(glBufferSubData) \
+	action(glTexImage2D) \
+	action(glTexSubImage2D) \
+	action(glTexImage3D) \
+	action(glTexSubImage3D) \
+	action(glCompressedTexImage2D) \
+	action(glCompressedTexSubImage2D)
+
+#define GL_STATS_INSTALL(function) \
+	original_##function = glad_##function; \
+	glad_##function = Counting_##function;
+
+#define GL_STATS_UNINSTALL(function) \
+	glad_##function = original_##function;
+
+	void GLStats::Install()
+	{
+		if (isInstalled)
+			return;
+
+		if (glad_glDrawArrays == nullptr)
+			throw std::runtime_error("GL statistics can only be installed after GL has been loaded.");
+
+		GL_STATS_FOR_EACH_WRAPPED(GL_STATS_INSTALL)
+
+		currentFrame = GLFrameStats();
+		callSites.clear();
+		usedCallSites = 0;
+		isInstalled = true;
+
+		std::lock_guard lock(publishedMutex);
+		lastFrame = GLFrameStats();
+		publishedCallSites.clear();
+	}
+
+	void GLStats::Uninstall()
+	{
+		if (!isInstalled)
+			return;
+
+		GL_STATS_FOR_EACH_WRAPPED(GL_STATS_UNINSTALL)
+
+		isInstalled = false;
+	}
+
+#undef GL_STATS_INSTALL
+#undef GL_STATS_UNINSTALL
+#undef GL_STATS_FOR_EACH_WRAPPED
+
+	bool GLStats::GetIsInstalled()
+	{
+		return isInstalled;
+	}
+
+	void GLStats::SetIsPaused(const bool value)
+	{
+		isPaused = value;
+	}
+
+	void GLStats::SetIsCallSiteTrackingEnabled(const bool value)
+	{
+		isCallSiteTrackingEnabled = value;
+	}
+
+	bool GLStats::GetIsCallSiteTrackingEnabled()
+	{
+		return isCallSiteTrackingEnabled;
+	}
+
+	void GLStats::EndFrame()
+	{
+		if (!isInstalled)
+			return;
+
+		std::lock_guard lock(publishedMutex);
+
+		lastFrame = currentFrame;
+		currentFrame = GLFrameStats();
+		currentFrame.frameIndex = lastFrame.frameIndex + 1;
+
+		if (usedCallSites == 0)
+			return;
+
+		publishedCallSites.clear();
+
+		for (auto& site : callSites)
+		{
+			if (site.returnAddress == nullptr)
+				continue;
+
+			site.lastFrameCalls = site.currentFrameCalls;
+			site.currentFrameCalls = 0;
+
+			publishedCallSites.push_back(site);
+		}
+	}
+
+	GLFrameStats GLStats::GetCurrentFrame()
+	{
+		return currentFrame;
+	}
+
+	GLFrameStats GLStats::GetLastFrame()
+	{
+		std::lock_guard lock(publishedMutex);
+		return lastFrame;
+	}
+
+	std::vector<GLCallSiteStats> GLStats::GetCallSites()
+	{
+		std::vector<CallSite> sites;
+
+		{
+			std::lock_guard lock(publishedMutex);
+			sites = publishedCallSites;
+		}
+
+		std::sort(sites.begin(), sites.end(), [](const CallSite& a, const CallSite& b)
+		{
+			return a.lastFrameCalls != b.lastFrameCalls ? a.lastFrameCalls > b.lastFrameCalls : a.totalCalls > b.totalCalls;
+		});
+
+		std::vector<GLCallSiteStats> stats;
+		stats.reserve(sites.size());
+
+		for (const auto& site : sites)
+			stats.push_back({ site.function, site.returnAddress, DescribeAddress(site.returnAddress), site.lastFrameCalls, site.totalCalls });
+
+		return stats;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Graphics
+{
+	struct GLFrameStats
+	{
+		uint64_t frameIndex = 0;
+		uint64_t drawCalls = 0;
+		uint64_t stateChanges = 0;
+		uint64_t uniformUploads = 0;
+		uint64_t bufferBytes = 0;
+		uint64_t textureBytes = 0;
+
+		[[nodiscard]] uint64_t GetBytesUploaded() const { return bufferBytes + textureBytes; }
+	};
+
+	struct GLCallSiteStats
+	{
+		// Name of the wrapped entry point, e.g. "glDrawArrays"
+		const char* function = nullptr;
+		const void* returnAddress = nullptr;
+
+		// Symbol and source line of the caller when debug information is available
+		std::string location;
+
+		uint64_t lastFrameCalls = 0;
+		uint64_t totalCalls = 0;
+	};
+
+	// Counts GL work by swapping the glad function pointers for counting wrappers. Nothing
+	// is wrapped until Install is called, so the layer costs nothing when unused. Counters
+	// are only touched from the thread owning the context, the finished frame is published
+	// by EndFrame and can be read from any thread.
+	class GLStats
+	{
+	public:
+		static constexpr size_t MAX_CALL_SITES = 1024;
+
+		// Must be called after glad has loaded the GL entry points.
+		static void Install();
+		static void Uninstall();
+
+		[[nodiscard]] static bool GetIsInstalled();
+
+		// While paused wrapped calls are forwarded without being counted.
+		static void SetIsPaused(bool value);
+
+		// Attributes every wrapped call to the code calling it. Costs a hash lookup per call,
+		// so it is off by default.
+		static void SetIsCallSiteTrackingEnabled(bool value);
+		[[nodiscard]] static bool GetIsCallSiteTrackingEnabled();
+
+		// Closes the frame being counted, its totals become available from GetLastFrame.
+		static void EndFrame();
+
+		[[nodiscard]] static GLFrameStats GetCurrentFrame();
+		[[nodiscard]] static GLFrameStats GetLastFrame();
+
+		// Call sites seen so far, busiest in the last frame first.
+		[[nodiscard]] static std::vector<GLCallSiteStats> GetCallSites();
+	};
+}
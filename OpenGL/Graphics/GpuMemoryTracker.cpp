@@ -0,0 +1,271 @@
+#include "GpuMemoryTracker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace Graphics
+{
+	namespace
+	{
+		constexpr auto CATEGORY_COUNT = static_cast<size_t>(GpuMemoryCategory::COUNT);
+
+		struct Budgeted
+		{
+			GpuMemoryTotals totals;
+			uint64_t budget = 0;
+		};
+
+		std::mutex mutex;
+		std::map<std::pair<GpuMemoryCategory, unsigned>, GpuAllocationInfo> allocations;
+		std::array<Budgeted, CATEGORY_COUNT> categories;
+		Budgeted total;
+
+		void WriteMegabytes(std::ostream& stream, const uint64_t bytes)
+		{
+			stream << static_cast<double>(bytes) / (1024.0 * 1024.0) << " MB";
+		}
+
+		void Add(Budgeted& budgeted, const uint64_t size, const char* name)
+		{
+			const auto wasOverBudget = budgeted.budget != 0 && budgeted.totals.liveBytes > budgeted.budget;
+
+			budgeted.totals.liveBytes += size;
+			budgeted.totals.peakBytes = std::max(budgeted.totals.peakBytes, budgeted.totals.liveBytes);
+
+			if (budgeted.budget != 0 && !wasOverBudget && budgeted.totals.liveBytes > budgeted.budget)
+			{
+				std::cerr << "Warning: GPU memory budget for " << name << " exceeded, ";
+				WriteMegabytes(std::cerr, budgeted.totals.liveBytes);
+				std::cerr << " of ";
+				WriteMegabytes(std::cerr, budgeted.budget);
+				std::cerr << std::endl;
+			}
+		}
+
+		void Remove(Budgeted& budgeted, const uint64_t size)
+		{
+			budgeted.totals.liveBytes -= std::min(size, budgeted.totals.liveBytes);
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuMemoryTracker::Register(const GpuMemoryCategory category, const unsigned id, const uint64_t size, std::string name,
+		const GpuAllocationSite site)
+	{
+		std::lock_guard lock(mutex);
+
+		const auto [found, isInserted] = allocations.try_emplace({ category, id });
+		auto& allocation = found->second;
+
+		// Registering a live name again replaces it, as GL does when storage is respecified
+		if (!isInserted)
+		{
+			Remove(categories[static_cast<size_t>(category)], allocation.size);
+			Remove(total, allocation.size);
+		}
+		else
+		{
+			categories[static_cast<size_t>(category)].totals.liveCount++;
+			total.totals.liveCount++;
+		}
+
+		allocation = { category, id, size, std::move(name), site };
+
+		Add(categories[static_cast<size_t>(category)], size, GetCategoryName(category));
+		Add(total, size, "all categories");
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuMemoryTracker::Resize(const GpuMemoryCategory category, const unsigned id, const uint64_t size)
+	{
+		std::lock_guard lock(mutex);
+
+		const auto found = allocations.find({ category, id });
+
+		if (found == allocations.end())
+			throw std::runtime_error("Resizing a GPU allocation that was never registered.");
+
+		auto& budgeted = categories[static_cast<size_t>(category)];
+
+		Remove(budgeted, found->second.size);
+		Remove(total, found->second.size);
+
+		found->second.size = size;
+
+		Add(budgeted, size, GetCategoryName(category));
+		Add(total, size, "all categories");
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuMemoryTracker::Unregister(const GpuMemoryCategory category, const unsigned id)
+	{
+		std::lock_guard lock(mutex);
+
+		const auto found = allocations.find({ category, id });
+
+		// Deleting name 0 or an object twice is harmless in GL, so it is here too
+		if (found == allocations.end())
+			return;
+
+		auto& budgeted = categories[static_cast<size_t>(category)];
+
+		Remove(budgeted, found->second.size);
+		Remove(total, found->second.size);
+		budgeted.totals.liveCount--;
+		total.totals.liveCount--;
+
+		allocations.erase(found);
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuMemoryTracker::SetBudget(const GpuMemoryCategory category, const uint64_t bytes)
+	{
+		std::lock_guard lock(mutex);
+		categories[static_cast<size_t>(category)].budget = bytes;
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuMemoryTracker::SetTotalBudget(const uint64_t bytes)
+	{
+		std::lock_guard lock(mutex);
+		total.budget = bytes;
+	}
+
+	//-------------------------------------------------------------------
+
+	GpuMemoryTotals GpuMemoryTracker::GetTotals(const GpuMemoryCategory category)
+	{
+		std::lock_guard lock(mutex);
+		return categories[static_cast<size_t>(category)].totals;
+	}
+
+	//-------------------------------------------------------------------
+
+	GpuMemoryTotals GpuMemoryTracker::GetTotals()
+	{
+		std::lock_guard lock(mutex);
+		return total.totals;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<GpuAllocationInfo> GpuMemoryTracker::GetLiveAllocations()
+	{
+		std::lock_guard lock(mutex);
+
+		std::vector<GpuAllocationInfo> live;
+		live.reserve(allocations.size());
+
+		for (const auto& [key, allocation] : allocations)
+			live.push_back(allocation);
+
+		return live;
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuMemoryTracker::PrintReport(std::ostream& stream)
+	{
+		std::lock_guard lock(mutex);
+
+		stream << "GPU memory:" << std::endl;
+
+		for (size_t i = 0; i < CATEGORY_COUNT; i++)
+		{
+			const auto& totals = categories[i].totals;
+
+			stream << "  " << GetCategoryName(static_cast<GpuMemoryCategory>(i)) << ": " << totals.liveCount << " live, ";
+			WriteMegabytes(stream, totals.liveBytes);
+			stream << ", peak ";
+			WriteMegabytes(stream, totals.peakBytes);
+			stream << std::endl;
+		}
+
+		stream << "  total: ";
+		WriteMegabytes(stream, total.totals.liveBytes);
+		stream << ", peak ";
+		WriteMegabytes(stream, total.totals.peakBytes);
+		stream << std::endl;
+	}
+
+	//-------------------------------------------------------------------
+
+	size_t GpuMemoryTracker::PrintLeakReport(std::ostream& stream, const std::vector<GpuAllocationInfo>& expected)
+	{
+		std::lock_guard lock(mutex);
+
+		std::vector<const GpuAllocationInfo*> leaks;
+
+		for (const auto& [key, allocation] : allocations)
+		{
+			const auto isExpected = std::any_of(expected.begin(), expected.end(), [&](const GpuAllocationInfo& info)
+			{
+				return info.category == allocation.category && info.id == allocation.id;
+			});
+
+			if (!isExpected)
+				leaks.push_back(&allocation);
+		}
+
+		if (leaks.empty())
+			return 0;
+
+		stream << leaks.size() << " GPU allocations were never released:" << std::endl;
+
+		for (const auto leak : leaks)
+		{
+			const auto& allocation = *leak;
+
+			stream << "  " << GetCategoryName(allocation.category) << " " << allocation.id
+				<< " '" << allocation.name << "', " << allocation.size << " bytes, created at "
+				<< allocation.site.file << ":" << allocation.site.line;
+
+			if (*allocation.site.function != '\0')
+				stream << " in " << allocation.site.function;
+
+			stream << std::endl;
+		}
+
+		return leaks.size();
+	}
+
+	//-------------------------------------------------------------------
+
+	const char* GpuMemoryTracker::GetCategoryName(const GpuMemoryCategory category)
+	{
+		switch (category)
+		{
+		case GpuMemoryCategory::VERTEX_BUFFER:
+			return "vertex buffers";
+		case GpuMemoryCategory::ELEMENT_BUFFER:
+			return "element buffers";
+		case GpuMemoryCategory::TEXTURE:
+			return "textures";
+		case GpuMemoryCategory::RENDER_TARGET:
+			return "render targets";
+		case GpuMemoryCategory::STAGING:
+			return "staging buffers";
+		default:
+			return "unknown";
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	uint64_t GpuMemoryTracker::GetTextureSize(const int width, const int height, const int bytesPerPixel, const bool hasMipmaps)
+	{
+		const auto baseSize = static_cast<uint64_t>(width) * height * bytesPerPixel;
+
+		return hasMipmaps ? baseSize + baseSize / 3 : baseSize;
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if __has_include(<source_location>)
+#include <source_location>
+#endif
+
+namespace Graphics
+{
+	enum class GpuMemoryCategory
+	{
+		VERTEX_BUFFER,
+		ELEMENT_BUFFER,
+		TEXTURE,
+		RENDER_TARGET,
+		STAGING,
+		COUNT
+	};
+
+	struct GpuAllocationSite
+	{
+		const char* file = "unknown";
+		unsigned line = 0;
+		const char* function = "";
+
+#ifdef __cpp_lib_source_location
+		static GpuAllocationSite Current(const std::source_location location = std::source_location::current())
+		{
+			return { location.file_name(), location.line(), location.function_name() };
+		}
+#else
+		static GpuAllocationSite Current() { return {}; }
+#endif
+	};
+
+	struct GpuAllocationInfo
+	{
+		GpuMemoryCategory category = GpuMemoryCategory::TEXTURE;
+		unsigned id = 0;
+		uint64_t size = 0;
+		std::string name;
+		GpuAllocationSite site;
+	};
+
+	struct GpuMemoryTotals
+	{
+		uint64_t liveBytes = 0;
+		uint64_t peakBytes = 0;
+		uint64_t liveCount = 0;
+	};
+
+	// Keeps a record of every GPU allocation the application makes, keyed by category and GL
+	// object name. Sizes are what was requested from GL, drivers may pad them. Thread safe.
+	class GpuMemoryTracker
+	{
+	public:
+		static void Register(GpuMemoryCategory category, unsigned id, uint64_t size, std::string name,
+			GpuAllocationSite site = GpuAllocationSite::Current());
+
+		// For storage that is respecified in place, e.g. glBufferData on an existing buffer.
+		static void Resize(GpuMemoryCategory category, unsigned id, uint64_t size);
+
+		static void Unregister(GpuMemoryCategory category, unsigned id);
+
+		// A warning is printed each time live memory rises above a budget, 0 disables it.
+		static void SetBudget(GpuMemoryCategory category, uint64_t bytes);
+		static void SetTotalBudget(uint64_t bytes);
+
+		[[nodiscard]] static GpuMemoryTotals GetTotals(GpuMemoryCategory category);
+		[[nodiscard]] static GpuMemoryTotals GetTotals();
+		[[nodiscard]] static std::vector<GpuAllocationInfo> GetLiveAllocations();
+
+		static void PrintReport(std::ostream& stream);
+
+		// Lists every allocation still alive but the expected ones, returns how many there were.
+		static size_t PrintLeakReport(std::ostream& stream, const std::vector<GpuAllocationInfo>& expected = {});
+
+		[[nodiscard]] static const char* GetCategoryName(GpuMemoryCategory category);
+
+		// Approximate size of a 2D texture, a full mip chain adds a third.
+		[[nodiscard]] static uint64_t GetTextureSize(int width, int height, int bytesPerPixel, bool hasMipmaps);
+	};
+}
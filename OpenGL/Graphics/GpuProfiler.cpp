@@ -0,0 +1,259 @@
+#include "GpuProfiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <stdexcept>
+#include <unordered_map>
+#include <glad/glad.h>
+
+namespace Graphics
+{
+	namespace
+	{
+		struct ZoneRecord
+		{
+			size_t zone;
+			size_t beginQuery;
+			size_t endQuery;
+		};
+
+		struct FrameSlot
+		{
+			uint64_t frameIndex = 0;
+			std::vector<GLuint> queries;
+			size_t usedQueries = 0;
+			std::vector<ZoneRecord> records;
+		};
+
+		struct ZoneHistory
+		{
+			std::array<double, GpuProfiler::AVERAGE_WINDOW> samples{};
+			size_t nextSample = 0;
+			double sum = 0.0;
+			GpuZoneStats stats;
+		};
+
+		bool isEnabled = false;
+
+		std::array<FrameSlot, GpuProfiler::FRAME_LATENCY + 1> slots;
+		size_t currentSlot = 0;
+		uint64_t frameIndex = 0;
+
+		// Zones still open in the current frame, as indices into the current slot's records
+		std::vector<size_t> openRecords;
+
+		std::unordered_map<std::string, size_t> zoneIndices;
+		std::vector<ZoneHistory> zones;
+
+		uint64_t droppedFrameCount = 0;
+
+		GpuFrameTimings lastResolvedFrame;
+		bool hasResolvedFrame = false;
+
+		size_t GetZoneIndex(const char* name)
+		{
+			const auto found = zoneIndices.find(name);
+
+			if (found != zoneIndices.end())
+				return found->second;
+
+			const auto index = zones.size();
+
+			zoneIndices.emplace(name, index);
+			zones.emplace_back().stats.name = name;
+
+			return index;
+		}
+
+		size_t IssueTimestamp(FrameSlot& slot)
+		{
+			if (slot.usedQueries == slot.queries.size())
+			{
+				GLuint query = 0;
+				glGenQueries(1, &query);
+				slot.queries.push_back(query);
+			}
+
+			const auto index = slot.usedQueries++;
+
+			glQueryCounter(slot.queries[index], GL_TIMESTAMP);
+
+			return index;
+		}
+
+		void AddSample(ZoneHistory& zone, const double milliseconds)
+		{
+			auto& oldest = zone.samples[zone.nextSample];
+
+			zone.sum += milliseconds - oldest;
+			oldest = milliseconds;
+			zone.nextSample = (zone.nextSample + 1) % zone.samples.size();
+
+			zone.stats.sampleCount++;
+			zone.stats.lastMs = milliseconds;
+			zone.stats.averageMs = zone.sum / static_cast<double>(std::min<uint64_t>(zone.stats.sampleCount, zone.samples.size()));
+		}
+
+		void ResolveSlot(FrameSlot& slot)
+		{
+			if (slot.records.empty())
+				return;
+
+			// The last query issued finishes last, if it is available all of them are
+			GLint isAvailable = GL_FALSE;
+			glGetQueryObjectiv(slot.queries[slot.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+
+			if (isAvailable == GL_FALSE)
+			{
+				droppedFrameCount++;
+				return;
+			}
+
+			lastResolvedFrame.frameIndex = slot.frameIndex;
+			lastResolvedFrame.zoneMs.assign(zones.size(), 0.0);
+			lastResolvedFrame.zoneRan.assign(zones.size(), false);
+
+			for (const auto& record : slot.records)
+			{
+				GLuint64 begin = 0;
+				GLuint64 end = 0;
+				glGetQueryObjectui64v(slot.queries[record.beginQuery], GL_QUERY_RESULT, &begin);
+				glGetQueryObjectui64v(slot.queries[record.endQuery], GL_QUERY_RESULT, &end);
+
+				lastResolvedFrame.zoneMs[record.zone] += static_cast<double>(end - begin) * 1e-6;
+				lastResolvedFrame.zoneRan[record.zone] = true;
+			}
+
+			// A zone entered several times in one frame counts as a single sample
+			for (size_t zone = 0; zone < zones.size(); zone++)
+				if (lastResolvedFrame.zoneRan[zone])
+					AddSample(zones[zone], lastResolvedFrame.zoneMs[zone]);
+
+			hasResolvedFrame = true;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuProfiler::SetIsEnabled(const bool value)
+	{
+		if (!openRecords.empty())
+			throw std::runtime_error("Cannot toggle the GPU profiler inside a zone.");
+
+		isEnabled = value;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool GpuProfiler::GetIsEnabled()
+	{
+		return isEnabled;
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuProfiler::BeginZone(const char* name)
+	{
+		if (!isEnabled)
+			return;
+
+		auto& slot = slots[currentSlot];
+
+		const auto zone = GetZoneIndex(name);
+		const auto beginQuery = IssueTimestamp(slot);
+
+		openRecords.push_back(slot.records.size());
+		slot.records.push_back({ zone, beginQuery, beginQuery });
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuProfiler::EndZone()
+	{
+		if (!isEnabled)
+			return;
+
+		if (openRecords.empty())
+			throw std::runtime_error("GPU zone ended without being begun.");
+
+		auto& slot = slots[currentSlot];
+
+		slot.records[openRecords.back()].endQuery = IssueTimestamp(slot);
+		openRecords.pop_back();
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuProfiler::EndFrame()
+	{
+		if (!isEnabled)
+			return;
+
+		if (!openRecords.empty())
+			throw std::runtime_error("GPU zone left open at the end of the frame.");
+
+		slots[currentSlot].frameIndex = frameIndex++;
+		currentSlot = (currentSlot + 1) % slots.size();
+
+		// The slot about to be reused holds the frame recorded FRAME_LATENCY frames ago
+		auto& slot = slots[currentSlot];
+
+		ResolveSlot(slot);
+
+		slot.usedQueries = 0;
+		slot.records.clear();
+	}
+
+	//-------------------------------------------------------------------
+
+	void GpuProfiler::Release()
+	{
+		for (auto& slot : slots)
+		{
+			if (!slot.queries.empty())
+				glDeleteQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+
+			slot = FrameSlot();
+		}
+
+		openRecords.clear();
+	}
+
+	//-------------------------------------------------------------------
+
+	uint64_t GpuProfiler::GetFrameIndex()
+	{
+		return frameIndex;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<GpuZoneStats> GpuProfiler::GetZoneStats()
+	{
+		std::vector<GpuZoneStats> stats;
+		stats.reserve(zones.size());
+
+		for (const auto& zone : zones)
+			stats.push_back(zone.stats);
+
+		return stats;
+	}
+
+	//-------------------------------------------------------------------
+
+	uint64_t GpuProfiler::GetDroppedFrameCount()
+	{
+		return droppedFrameCount;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool GpuProfiler::GetLastResolvedFrame(GpuFrameTimings& timings)
+	{
+		if (hasResolvedFrame)
+			timings = lastResolvedFrame;
+
+		return hasResolvedFrame;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Graphics
+{
+	struct GpuZoneStats
+	{
+		std::string name;
+		double lastMs = 0.0;
+		double averageMs = 0.0;
+		uint64_t sampleCount = 0;
+	};
+
+	struct GpuFrameTimings
+	{
+		uint64_t frameIndex = 0;
+
+		// Indexed like GetZoneStats, zones that did not run in the frame read 0
+		std::vector<double> zoneMs;
+
+		// Indexed the same, whether the zone ran in the frame at all
+		std::vector<bool> zoneRan;
+	};
+
+	// Measures GPU time of named zones with GL_TIMESTAMP queries. Queries of a frame are only
+	// read back FRAME_LATENCY frames later and only if already available, so the CPU never
+	// waits for the GPU; frames whose results are late are dropped instead. All calls must
+	// happen on the thread owning the context.
+	class GpuProfiler
+	{
+	public:
+		static constexpr int FRAME_LATENCY = 4;
+		static constexpr int AVERAGE_WINDOW = 64;
+
+		static void SetIsEnabled(bool value);
+		[[nodiscard]] static bool GetIsEnabled();
+
+		static void BeginZone(const char* name);
+		static void EndZone();
+
+		// Closes the frame being recorded and collects the results of the oldest frame in the ring.
+		static void EndFrame();
+
+		// Deletes the query objects, the context must still be current.
+		static void Release();
+
+		// Index of the frame currently being recorded.
+		[[nodiscard]] static uint64_t GetFrameIndex();
+
+		[[nodiscard]] static std::vector<GpuZoneStats> GetZoneStats();
+		[[nodiscard]] static uint64_t GetDroppedFrameCount();
+
+		// Timings of the most recently resolved frame, false until the first one resolves.
+		[[nodiscard]] static bool GetLastResolvedFrame(GpuFrameTimings& timings);
+	};
+
+	class GpuZone
+	{
+	public:
+		explicit GpuZone(const char* name) { GpuProfiler::BeginZone(name); }
+		~GpuZone() { GpuProfiler::EndZone(); }
+
+		GpuZone(const GpuZone& other) = delete;
+		GpuZone& operator=(const GpuZone& other) = delete;
+		GpuZone(GpuZone&& other) = delete;
+		GpuZone& operator=(GpuZone&& other) = delete;
+	};
+}
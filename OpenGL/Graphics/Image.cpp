@@ -0,0 +1,50 @@
+#include "Image.hpp"
+
+#include <stdexcept>
+#include <stb/stb_image.h>
+
+namespace Graphics
+{
+	Image::Image(const int width, const int height, const int channels, std::shared_ptr<const unsigned char> pixels)
+		: width(width), height(height), channels(channels), pixels(std::move(pixels))
+	{
+	}
+
+	Image Image::Load(const std::string& path, const bool isFlippedVertically)
+	{
+		stbi_set_flip_vertically_on_load_thread(isFlippedVertically);
+
+		int width, height, channels;
+		const auto data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+
+		if (data == nullptr)
+		{
+			const std::string errorMessage = "Failed to load image " + path + ": " + stbi_failure_reason();
+			throw std::runtime_error(errorMessage.c_str());
+		}
+
+		return { width, height, channels, std::shared_ptr<const unsigned char>(data, [](const unsigned char* pixels)
+		{
+			stbi_image_free(const_cast<unsigned char*>(pixels));
+		}) };
+	}
+
+	Image Image::Decode(const unsigned char* data, const size_t size, const std::string& name, const bool isFlippedVertically)
+	{
+		stbi_set_flip_vertically_on_load_thread(isFlippedVertically);
+
+		int width, height, channels;
+		const auto pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 0);
+
+		if (pixels == nullptr)
+		{
+			const std::string errorMessage = "Failed to decode image " + name + ": " + stbi_failure_reason();
+			throw std::runtime_error(errorMessage.c_str());
+		}
+
+		return { width, height, channels, std::shared_ptr<const unsigned char>(pixels, [](const unsigned char* pixels)
+		{
+			stbi_image_free(const_cast<unsigned char*>(pixels));
+		}) };
+	}
+}
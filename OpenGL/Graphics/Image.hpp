@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace Graphics
+{
+	// Decoded 8 bit pixels in CPU memory, rows packed without padding. Copies share the pixels.
+	class Image
+	{
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+
+		std::shared_ptr<const unsigned char> pixels;
+
+	public:
+		Image() = default;
+		Image(int width, int height, int channels, std::shared_ptr<const unsigned char> pixels);
+
+		// Safe to call from any thread, the flip only applies to the calling thread.
+		static Image Load(const std::string& path, bool isFlippedVertically = true);
+
+		// Decodes a whole PNG or JPEG file already in memory, the name is only for errors.
+		static Image Decode(const unsigned char* data, size_t size, const std::string& name, bool isFlippedVertically = true);
+
+		[[nodiscard]] int GetWidth() const { return width; }
+		[[nodiscard]] int GetHeight() const { return height; }
+		[[nodiscard]] int GetChannels() const { return channels; }
+		[[nodiscard]] const unsigned char* GetPixels() const { return pixels.get(); }
+		[[nodiscard]] size_t GetSize() const { return static_cast<size_t>(width) * height * channels; }
+	};
+}
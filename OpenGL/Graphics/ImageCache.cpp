@@ -0,0 +1,238 @@
+#include "ImageCache.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+//-------------------------------------------------------------------
+
+#include "../Utils/ContentHash.hpp"
+#include "../Utils/MappedFile.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	namespace
+	{
+		constexpr char MAGIC[4] = { 'I', 'M', 'G', 'C' };
+		constexpr uint32_t VERSION = 2;
+
+		constexpr uint32_t FLAG_SRGB = 1;
+		constexpr uint32_t FLAG_FLIPPED_VERTICALLY = 2;
+		constexpr uint32_t FLAG_MIPMAPS = 4;
+
+		// Followed by the levels' pixels, largest first, without padding. A cache line long, so
+		// mapped pixels start aligned.
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+
+			uint64_t sourceHash;
+			uint64_t sourceSize;
+
+			uint32_t filter;
+			uint32_t flags;
+
+			uint32_t width;
+			uint32_t height;
+			uint32_t channels;
+			uint32_t levelCount;
+
+			uint32_t reserved[4];
+		};
+
+		static_assert(sizeof(Header) == 64);
+
+		uint32_t GetFlags(const MipSettings& settings, const bool isFlippedVertically, const bool hasMipmaps)
+		{
+			return (settings.isSrgb ? FLAG_SRGB : 0) | (isFlippedVertically ? FLAG_FLIPPED_VERTICALLY : 0)
+				| (hasMipmaps ? FLAG_MIPMAPS : 0);
+		}
+
+		int GetLevelCount(const int width, const int height, const bool hasMipmaps)
+		{
+			return hasMipmaps ? MipGenerator::GetLevelCount(width, height) : 1;
+		}
+
+		bool GetIsNormalized(const int channels)
+		{
+			return channels == 1 || channels == 2 || channels == 4;
+		}
+
+		Image ExpandToRgba(const Image& image)
+		{
+			const auto pixelCount = static_cast<size_t>(image.GetWidth()) * image.GetHeight();
+			const auto pixels = std::make_shared<std::vector<unsigned char>>(pixelCount * 4);
+
+			const auto source = image.GetPixels();
+			const auto destination = pixels->data();
+
+			for (size_t i = 0; i < pixelCount; i++)
+			{
+				destination[i * 4 + 0] = source[i * 3 + 0];
+				destination[i * 4 + 1] = source[i * 3 + 1];
+				destination[i * 4 + 2] = source[i * 3 + 2];
+				destination[i * 4 + 3] = 255;
+			}
+
+			return { image.GetWidth(), image.GetHeight(), 4, std::shared_ptr<const unsigned char>(pixels, pixels->data()) };
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	ImageCache::ImageCache(const unsigned char* source, const size_t sourceSize, const MipSettings& settings,
+		const bool isFlippedVertically, const bool hasMipmaps)
+		: sourceHash(Utils::ContentHash::Compute(source, sourceSize)), sourceSize(sourceSize),
+		settings(hasMipmaps ? settings : MipSettings{}), isFlippedVertically(isFlippedVertically), hasMipmaps(hasMipmaps)
+	{
+		// Filter settings do not matter without mipmaps, so they share an entry
+		const uint32_t key[] = { static_cast<uint32_t>(this->settings.filter), GetFlags(this->settings, isFlippedVertically, hasMipmaps) };
+		const auto hash = Utils::ContentHash::Compute(key, sizeof(key), sourceHash);
+
+		path = (std::filesystem::path(DIRECTORY) / (Utils::ContentHash::ToString(hash) + ".img")).string();
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<Image> ImageCache::Load() const
+	{
+		const auto file = Utils::MappedFile::Open(path);
+
+		if (file == nullptr || file->GetSize() < sizeof(Header))
+			return {};
+
+		Header header{};
+		std::memcpy(&header, file->GetData(), sizeof(header));
+
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.sourceHash != sourceHash
+			|| header.sourceSize != sourceSize || header.filter != static_cast<uint32_t>(settings.filter)
+			|| header.flags != GetFlags(settings, isFlippedVertically, hasMipmaps))
+			return {};
+
+		const auto width = static_cast<int>(header.width);
+		const auto height = static_cast<int>(header.height);
+		const auto channels = static_cast<int>(header.channels);
+
+		if (width <= 0 || height <= 0 || !GetIsNormalized(channels)
+			|| header.levelCount != static_cast<uint32_t>(GetLevelCount(width, height, hasMipmaps)))
+			return {};
+
+		auto size = sizeof(Header);
+
+		for (uint32_t i = 0; i < header.levelCount; i++)
+			size += static_cast<size_t>(std::max(width >> i, 1)) * std::max(height >> i, 1) * channels;
+
+		if (size != file->GetSize())
+			return {};
+
+		std::vector<Image> levels;
+		levels.reserve(header.levelCount);
+
+		size_t offset = sizeof(Header);
+
+		for (uint32_t i = 0; i < header.levelCount; i++)
+		{
+			levels.emplace_back(std::max(width >> i, 1), std::max(height >> i, 1), channels, Utils::MappedFile::GetPointer(file, offset));
+			offset += levels.back().GetSize();
+		}
+
+		return levels;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<Image> ImageCache::Normalize(std::vector<Image> levels)
+	{
+		for (auto& level : levels)
+		{
+			if (level.GetChannels() == 3)
+				level = ExpandToRgba(level);
+		}
+
+		return levels;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool ImageCache::Save(const std::vector<Image>& levels) const
+	{
+		if (levels.empty())
+			throw std::runtime_error("No levels to cache.");
+
+		const auto& image = levels.front();
+
+		if (!GetIsNormalized(image.GetChannels()))
+			throw std::runtime_error(("Images with " + std::to_string(image.GetChannels()) + " channels must be normalized before they are cached.").c_str());
+
+		if (static_cast<int>(levels.size()) != GetLevelCount(image.GetWidth(), image.GetHeight(), hasMipmaps))
+			throw std::runtime_error("The levels to cache are not a full mip chain.");
+
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			if (levels[i].GetWidth() != std::max(image.GetWidth() >> i, 1) || levels[i].GetHeight() != std::max(image.GetHeight() >> i, 1)
+				|| levels[i].GetChannels() != image.GetChannels())
+				throw std::runtime_error(("Level " + std::to_string(i) + " to cache does not match the size of level 0.").c_str());
+		}
+
+		Header header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.sourceHash = sourceHash;
+		header.sourceSize = sourceSize;
+		header.filter = static_cast<uint32_t>(settings.filter);
+		header.flags = GetFlags(settings, isFlippedVertically, hasMipmaps);
+		header.width = static_cast<uint32_t>(image.GetWidth());
+		header.height = static_cast<uint32_t>(image.GetHeight());
+		header.channels = static_cast<uint32_t>(image.GetChannels());
+		header.levelCount = static_cast<uint32_t>(levels.size());
+
+		std::error_code error;
+		std::filesystem::create_directories(DIRECTORY, error);
+
+		if (error)
+			return false;
+
+		// Unique per thread, two loads of the same image may save at once
+		const auto temporaryPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+		{
+			std::ofstream file(temporaryPath, std::ios::binary);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+			for (const auto& level : levels)
+				file.write(reinterpret_cast<const char*>(level.GetPixels()), static_cast<std::streamsize>(level.GetSize()));
+
+			file.close();
+
+			if (!file)
+			{
+				std::error_code ignored;
+				std::filesystem::remove(temporaryPath, ignored);
+
+				return false;
+			}
+		}
+
+		std::filesystem::rename(temporaryPath, path, error);
+
+		if (error)
+		{
+			std::error_code ignored;
+			std::filesystem::remove(temporaryPath, ignored);
+
+			return false;
+		}
+
+		return true;
+	}
+}
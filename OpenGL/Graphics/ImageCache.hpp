@@ -0,0 +1,56 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "Image.hpp"
+#include "MipGenerator.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	// Decoded images, with the mip chain MipGenerator built for them when textures have mipmaps,
+	// kept in Cache/Images under a hash of the image file's contents and the settings they were
+	// built with. Renaming, copying or touching an image keeps its entry, editing it does not.
+	// Entries are the raw levels behind a small header and are mapped rather than read, so a warm
+	// start neither decodes, filters nor copies pixels before uploading them. Entries hold one, two
+	// or four channels: three channel levels are expanded to RGBA when the entry is built, as
+	// drivers convert tightly packed RGB on the CPU when it is uploaded.
+	class ImageCache
+	{
+		uint64_t sourceHash = 0;
+		uint64_t sourceSize = 0;
+
+		MipSettings settings;
+		bool isFlippedVertically = true;
+		bool hasMipmaps = true;
+
+		std::string path;
+
+	public:
+		static constexpr const char* DIRECTORY = "Cache/Images";
+
+		// Hashes the contents of the image file.
+		ImageCache(const unsigned char* source, size_t sourceSize, const MipSettings& settings, bool isFlippedVertically,
+			bool hasMipmaps);
+
+		[[nodiscard]] const std::string& GetPath() const { return path; }
+
+		// Returns no levels when there is no valid entry. The levels keep the entry mapped.
+		[[nodiscard]] std::vector<Image> Load() const;
+
+		// Expands three channel levels to opaque RGBA, leaves the others as they are.
+		static std::vector<Image> Normalize(std::vector<Image> levels);
+
+		// Writes a temporary file and renames it, so a concurrent Load never reads half an entry.
+		// Returns false when the file could not be written, a missing entry only costs time.
+		// Throws for levels that are not normalized.
+		bool Save(const std::vector<Image>& levels) const;
+	};
+}
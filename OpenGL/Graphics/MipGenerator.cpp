@@ -0,0 +1,464 @@
+#include "MipGenerator.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+// The AVX kernel is built whatever the target and only used when the CPU turns out to have it
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MIP_GENERATOR_AVX
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define MIP_GENERATOR_TARGET_AVX
+#else
+#define MIP_GENERATOR_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2 || defined(__SSE2__)
+#define MIP_GENERATOR_SSE
+#include <emmintrin.h>
+#endif
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	namespace
+	{
+		// In destination texels, three lobes of the sinc
+		constexpr float KAISER_RADIUS = 3.0f;
+		constexpr float KAISER_ALPHA = 4.0f;
+
+		constexpr float PI = 3.14159265358979f;
+
+		// Steps of the linear to sRGB table, fine enough to keep every dark sRGB value reachable
+		constexpr int LINEAR_STEPS = 4096;
+
+		// RGBA floats per texel whatever the channel count, so one texel fills one SSE register
+		struct LinearImage
+		{
+			int width = 0;
+			int height = 0;
+			std::vector<float> texels;
+
+			[[nodiscard]] float* GetRow(const int y) { return texels.data() + static_cast<size_t>(y) * width * 4; }
+			[[nodiscard]] const float* GetRow(const int y) const { return texels.data() + static_cast<size_t>(y) * width * 4; }
+		};
+
+		// The weights of every destination texel along one axis, padded to the same count
+		struct FilterTaps
+		{
+			int tapCount = 0;
+			std::vector<int> indices;
+			std::vector<float> weights;
+		};
+
+		const std::array<float, 256>& GetSrgbToLinearTable()
+		{
+			static const auto table = []
+			{
+				std::array<float, 256> result{};
+
+				for (auto i = 0; i < 256; i++)
+				{
+					const auto value = static_cast<float>(i) / 255.0f;
+					result[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+				}
+
+				return result;
+			}();
+
+			return table;
+		}
+
+		const std::array<unsigned char, LINEAR_STEPS>& GetLinearToSrgbTable()
+		{
+			static const auto table = []
+			{
+				std::array<unsigned char, LINEAR_STEPS> result{};
+
+				for (auto i = 0; i < LINEAR_STEPS; i++)
+				{
+					const auto value = static_cast<float>(i) / (LINEAR_STEPS - 1);
+					const auto encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+					result[i] = static_cast<unsigned char>(std::lround(std::clamp(encoded, 0.0f, 1.0f) * 255.0f));
+				}
+
+				return result;
+			}();
+
+			return table;
+		}
+
+		// Modified Bessel function of the first kind, order 0
+		float Bessel0(const float x)
+		{
+			const auto halfSquared = x * x / 4.0f;
+			auto term = 1.0f;
+			auto sum = 1.0f;
+
+			for (auto k = 1; term > sum * 1e-7f; k++)
+			{
+				term *= halfSquared / static_cast<float>(k * k);
+				sum += term;
+			}
+
+			return sum;
+		}
+
+		float EvaluateFilter(const MipFilter filter, const float x)
+		{
+			if (filter == MipFilter::BOX)
+				return std::abs(x) <= 0.5f ? 1.0f : 0.0f;
+
+			const auto ratio = x / KAISER_RADIUS;
+
+			if (std::abs(ratio) >= 1.0f)
+				return 0.0f;
+
+			const auto sinc = x == 0.0f ? 1.0f : std::sin(PI * x) / (PI * x);
+
+			return sinc * Bessel0(KAISER_ALPHA * std::sqrt(1.0f - ratio * ratio)) / Bessel0(KAISER_ALPHA);
+		}
+
+		// Texel centers line up at both sizes, so odd sizes spread their extra texel over both neighbours
+		FilterTaps ComputeTaps(const MipFilter filter, const int sourceSize, const int size)
+		{
+			const auto scale = static_cast<float>(sourceSize) / static_cast<float>(size);
+			const auto radius = (filter == MipFilter::BOX ? 0.5f : KAISER_RADIUS) * scale;
+
+			std::vector<int> firsts(size);
+			std::vector<int> lasts(size);
+
+			FilterTaps taps;
+
+			for (auto i = 0; i < size; i++)
+			{
+				const auto center = (static_cast<float>(i) + 0.5f) * scale;
+				firsts[i] = static_cast<int>(std::ceil(center - radius - 0.5f));
+				lasts[i] = static_cast<int>(std::floor(center + radius - 0.5f));
+
+				taps.tapCount = std::max(taps.tapCount, lasts[i] - firsts[i] + 1);
+			}
+
+			taps.indices.resize(static_cast<size_t>(size) * taps.tapCount);
+			taps.weights.resize(taps.indices.size());
+
+			for (auto i = 0; i < size; i++)
+			{
+				const auto center = (static_cast<float>(i) + 0.5f) * scale;
+				const auto first = firsts[i];
+				const auto last = lasts[i];
+
+				const auto indices = taps.indices.data() + static_cast<size_t>(i) * taps.tapCount;
+				const auto weights = taps.weights.data() + static_cast<size_t>(i) * taps.tapCount;
+
+				auto sum = 0.0f;
+
+				for (auto tap = 0; tap < taps.tapCount; tap++)
+				{
+					const auto source = std::min(first + tap, last);
+
+					// Taps past the edges repeat the edge texel
+					indices[tap] = std::clamp(source, 0, sourceSize - 1);
+					weights[tap] = first + tap <= last
+						? EvaluateFilter(filter, (static_cast<float>(source) + 0.5f - center) / scale)
+						: 0.0f;
+
+					sum += weights[tap];
+				}
+
+				for (auto tap = 0; tap < taps.tapCount; tap++)
+					weights[tap] /= sum;
+			}
+
+			return taps;
+		}
+
+		void ForEachRow(Utils::ThreadPool* threadPool, const int rowCount, const std::function<void(int begin, int end)>& body)
+		{
+			if (threadPool == nullptr)
+			{
+				body(0, rowCount);
+				return;
+			}
+
+			threadPool->ParallelFor(static_cast<size_t>(rowCount), [&body](size_t, const size_t begin, const size_t end)
+			{
+				body(static_cast<int>(begin), static_cast<int>(end));
+			});
+		}
+
+		//-------------------------------------------------------------------
+
+		void FilterRow(const float* source, float* destination, const FilterTaps& taps, const int width)
+		{
+			for (auto x = 0; x < width; x++)
+			{
+				const auto indices = taps.indices.data() + static_cast<size_t>(x) * taps.tapCount;
+				const auto weights = taps.weights.data() + static_cast<size_t>(x) * taps.tapCount;
+
+#ifdef MIP_GENERATOR_SSE
+				auto sum = _mm_setzero_ps();
+
+				for (auto tap = 0; tap < taps.tapCount; tap++)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[tap]), _mm_loadu_ps(source + indices[tap] * 4)));
+
+				_mm_storeu_ps(destination + x * 4, sum);
+#else
+				float sum[4] = {};
+
+				for (auto tap = 0; tap < taps.tapCount; tap++)
+					for (auto channel = 0; channel < 4; channel++)
+						sum[channel] += weights[tap] * source[indices[tap] * 4 + channel];
+
+				std::copy(std::begin(sum), std::end(sum), destination + x * 4);
+#endif
+			}
+		}
+
+#ifdef MIP_GENERATOR_AVX
+		bool GetHasAvx()
+		{
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 1);
+
+			// The OS must also save the upper halves of the registers, which XSAVE and XCR0 tell
+			const auto hasAvx = (info[2] & (1 << 28)) != 0;
+			const auto hasOsXsave = (info[2] & (1 << 27)) != 0;
+
+			return hasAvx && hasOsXsave && (_xgetbv(0) & 6) == 6;
+#else
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx");
+#endif
+		}
+
+		// Returns how many values it filtered, a multiple of 8
+		MIP_GENERATOR_TARGET_AVX size_t FilterColumnsAvx(const float* const* rows, const float* weights, const int tapCount,
+			float* destination, const size_t count)
+		{
+			size_t i = 0;
+
+			for (; i + 8 <= count; i += 8)
+			{
+				auto sum = _mm256_setzero_ps();
+
+				for (auto tap = 0; tap < tapCount; tap++)
+					sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[tap]), _mm256_loadu_ps(rows[tap] + i)));
+
+				_mm256_storeu_ps(destination + i, sum);
+			}
+
+			return i;
+		}
+#endif
+
+		// Weighs whole rows against each other, so the vectors run along the row
+		void FilterColumns(const float* const* rows, const float* weights, const int tapCount, float* destination, const size_t count)
+		{
+			size_t i = 0;
+
+#ifdef MIP_GENERATOR_AVX
+			static const auto hasAvx = GetHasAvx();
+
+			if (hasAvx)
+				i = FilterColumnsAvx(rows, weights, tapCount, destination, count);
+#endif
+
+#ifdef MIP_GENERATOR_SSE
+			for (; i + 4 <= count; i += 4)
+			{
+				auto sum = _mm_setzero_ps();
+
+				for (auto tap = 0; tap < tapCount; tap++)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[tap]), _mm_loadu_ps(rows[tap] + i)));
+
+				_mm_storeu_ps(destination + i, sum);
+			}
+#endif
+
+			for (; i < count; i++)
+			{
+				auto sum = 0.0f;
+
+				for (auto tap = 0; tap < tapCount; tap++)
+					sum += weights[tap] * rows[tap][i];
+
+				destination[i] = sum;
+			}
+		}
+
+		LinearImage Downsample(const LinearImage& source, const MipFilter filter, Utils::ThreadPool* threadPool)
+		{
+			const auto width = std::max(source.width / 2, 1);
+			const auto height = std::max(source.height / 2, 1);
+
+			// Along an axis already at 1 texel the pass would copy it
+			const auto horizontal = [&]
+			{
+				if (width == source.width)
+					return source;
+
+				LinearImage result{ width, source.height, std::vector<float>(static_cast<size_t>(width) * source.height * 4) };
+				const auto taps = ComputeTaps(filter, source.width, width);
+
+				ForEachRow(threadPool, source.height, [&](const int begin, const int end)
+				{
+					for (auto y = begin; y < end; y++)
+						FilterRow(source.GetRow(y), result.GetRow(y), taps, width);
+				});
+
+				return result;
+			}();
+
+			if (height == source.height)
+				return horizontal;
+
+			LinearImage result{ width, height, std::vector<float>(static_cast<size_t>(width) * height * 4) };
+			const auto taps = ComputeTaps(filter, source.height, height);
+
+			ForEachRow(threadPool, height, [&](const int begin, const int end)
+			{
+				std::vector<const float*> rows(taps.tapCount);
+
+				for (auto y = begin; y < end; y++)
+				{
+					for (auto tap = 0; tap < taps.tapCount; tap++)
+						rows[tap] = horizontal.GetRow(taps.indices[static_cast<size_t>(y) * taps.tapCount + tap]);
+
+					FilterColumns(rows.data(), taps.weights.data() + static_cast<size_t>(y) * taps.tapCount, taps.tapCount,
+						result.GetRow(y), static_cast<size_t>(width) * 4);
+				}
+			});
+
+			return result;
+		}
+
+		//-------------------------------------------------------------------
+
+		LinearImage Decode(const Image& image, const bool isSrgb, Utils::ThreadPool* threadPool)
+		{
+			const auto& table = GetSrgbToLinearTable();
+			const auto channels = image.GetChannels();
+			const auto colorChannels = isSrgb && channels >= 3 ? 3 : 0;
+
+			LinearImage result{ image.GetWidth(), image.GetHeight(),
+				std::vector<float>(static_cast<size_t>(image.GetWidth()) * image.GetHeight() * 4) };
+
+			ForEachRow(threadPool, image.GetHeight(), [&](const int begin, const int end)
+			{
+				for (auto y = begin; y < end; y++)
+				{
+					const auto source = image.GetPixels() + static_cast<size_t>(y) * image.GetWidth() * channels;
+					const auto destination = result.GetRow(y);
+
+					for (auto x = 0; x < image.GetWidth(); x++)
+					{
+						for (auto channel = 0; channel < channels; channel++)
+						{
+							const auto value = source[x * channels + channel];
+							destination[x * 4 + channel] = channel < colorChannels ? table[value] : static_cast<float>(value) / 255.0f;
+						}
+					}
+				}
+			});
+
+			return result;
+		}
+
+		Image Encode(const LinearImage& image, const int channels, const bool isSrgb, Utils::ThreadPool* threadPool)
+		{
+			const auto& table = GetLinearToSrgbTable();
+			const auto colorChannels = isSrgb && channels >= 3 ? 3 : 0;
+
+			const auto pixels = std::make_shared<std::vector<unsigned char>>(static_cast<size_t>(image.width) * image.height * channels);
+
+			ForEachRow(threadPool, image.height, [&](const int begin, const int end)
+			{
+				for (auto y = begin; y < end; y++)
+				{
+					const auto source = image.GetRow(y);
+					const auto destination = pixels->data() + static_cast<size_t>(y) * image.width * channels;
+
+					for (auto x = 0; x < image.width; x++)
+					{
+						for (auto channel = 0; channel < channels; channel++)
+						{
+							// The sinc's negative lobes can overshoot
+							const auto value = std::clamp(source[x * 4 + channel], 0.0f, 1.0f);
+
+							destination[x * channels + channel] = channel < colorChannels
+								? table[static_cast<size_t>(value * (LINEAR_STEPS - 1) + 0.5f)]
+								: static_cast<unsigned char>(value * 255.0f + 0.5f);
+						}
+					}
+				}
+			});
+
+			return { image.width, image.height, channels, std::shared_ptr<const unsigned char>(pixels, pixels->data()) };
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<Image> MipGenerator::Generate(const Image& image, const MipSettings& settings, Utils::ThreadPool* threadPool)
+	{
+		std::vector<Image> levels;
+		levels.reserve(GetLevelCount(image.GetWidth(), image.GetHeight()));
+		levels.push_back(image);
+
+		auto level = Decode(image, settings.isSrgb, threadPool);
+
+		while (level.width > 1 || level.height > 1)
+		{
+			level = Downsample(level, settings.filter, threadPool);
+			levels.push_back(Encode(level, image.GetChannels(), settings.isSrgb, threadPool));
+		}
+
+		return levels;
+	}
+
+	//-------------------------------------------------------------------
+
+	int MipGenerator::GetLevelCount(int width, int height)
+	{
+		auto count = 1;
+
+		for (; width > 1 || height > 1; count++)
+		{
+			width = std::max(width / 2, 1);
+			height = std::max(height / 2, 1);
+		}
+
+		return count;
+	}
+
+	//-------------------------------------------------------------------
+
+	const char* MipGenerator::GetFilterName(const MipFilter filter)
+	{
+		return filter == MipFilter::BOX ? "box" : "kaiser";
+	}
+
+	//-------------------------------------------------------------------
+
+	MipFilter MipGenerator::ParseFilter(const std::string& name)
+	{
+		for (const auto filter : { MipFilter::BOX, MipFilter::KAISER })
+		{
+			if (name == GetFilterName(filter))
+				return filter;
+		}
+
+		throw std::runtime_error(("Unknown mip filter " + name).c_str());
+	}
+}
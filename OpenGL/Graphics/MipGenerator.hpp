@@ -0,0 +1,51 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "Image.hpp"
+#include "../Utils/ThreadPool.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	enum class MipFilter
+	{
+		BOX,	// Averages the texels under each destination texel, cheap but slightly blurry
+		KAISER	// Kaiser windowed sinc over three destination texels, sharper with little ringing
+	};
+
+	struct MipSettings
+	{
+		MipFilter filter = MipFilter::KAISER;
+
+		// Filters the color channels of three and four channel images in linear light. Alpha and
+		// the channels of one and two channel images are filtered as stored.
+		bool isSrgb = true;
+	};
+
+	// Builds mip chains on the CPU, so their quality no longer depends on the driver. Each level is
+	// filtered from the previous one in 32 bit float, which is only quantized for the output. The
+	// filter kernels use SSE, AVX when the CPU has it, and fall back to scalar code elsewhere. All
+	// of them multiply and add in the same order, so their output is bit-identical.
+	class MipGenerator
+	{
+	public:
+		// Returns the image followed by its levels down to 1x1. Given a pool, the rows of every
+		// level are split across its workers, so it must not be called from one of them.
+		[[nodiscard]] static std::vector<Image> Generate(const Image& image, const MipSettings& settings,
+			Utils::ThreadPool* threadPool = nullptr);
+
+		[[nodiscard]] static int GetLevelCount(int width, int height);
+
+		[[nodiscard]] static const char* GetFilterName(MipFilter filter);
+
+		// Throws for names GetFilterName never returns.
+		[[nodiscard]] static MipFilter ParseFilter(const std::string& name);
+	};
+}
@@ -0,0 +1,230 @@
+#include "Overlay.hpp"
+
+//-------------------------------------------------------------------
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+
+//-------------------------------------------------------------------
+
+#include "GLDebug.hpp"
+#include "GLExtensions.hpp"
+#include "GpuMemoryTracker.hpp"
+#include "OverlayFont.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	namespace
+	{
+		constexpr auto ATLAS_ROWS = (OverlayFont::GLYPH_COUNT + 15) / 16;
+		constexpr auto ATLAS_WIDTH = 16 * OverlayFont::GLYPH_WIDTH;
+		constexpr auto ATLAS_HEIGHT = ATLAS_ROWS * OverlayFont::GLYPH_HEIGHT;
+	}
+
+	//-------------------------------------------------------------------
+
+	Overlay::Overlay()
+	{
+		program = std::make_unique<ShaderProgram>("Content/Shaders/overlay.vert", "Content/Shaders/overlay.frag");
+
+		CreateGlyphAtlas();
+
+		glGenVertexArrays(1, &vertexArray);
+		glGenBuffers(1, &vertexBuffer);
+
+		glBindVertexArray(vertexArray);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, MAX_VERTICES * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+
+		GLDebug::SetObjectLabel(GL_VERTEX_ARRAY, vertexArray, "overlay");
+		GLDebug::SetObjectLabel(GL_BUFFER, vertexBuffer, "overlay vertices");
+
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, texCoord)));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, color)));
+		glEnableVertexAttribArray(2);
+
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		GpuMemoryTracker::Register(GpuMemoryCategory::VERTEX_BUFFER, vertexBuffer, MAX_VERTICES * sizeof(Vertex), "overlay vertices");
+
+		program->Use();
+		program->SetInt("glyphAtlas", 0);
+		program->Unuse();
+
+		vertices.reserve(MAX_VERTICES);
+	}
+
+	//-------------------------------------------------------------------
+
+	Overlay::~Overlay()
+	{
+		GpuMemoryTracker::Unregister(GpuMemoryCategory::VERTEX_BUFFER, vertexBuffer);
+
+		glDeleteVertexArrays(1, &vertexArray);
+		glDeleteBuffers(1, &vertexBuffer);
+	}
+
+	//-------------------------------------------------------------------
+
+	void Overlay::CreateGlyphAtlas()
+	{
+		const auto pixels = std::make_shared<std::vector<unsigned char>>(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+
+		for (auto glyph = 0; glyph < OverlayFont::GLYPH_COUNT; glyph++)
+		{
+			const auto left = glyph % ATLAS_COLUMNS * OverlayFont::GLYPH_WIDTH;
+			const auto top = glyph / ATLAS_COLUMNS * OverlayFont::GLYPH_HEIGHT;
+
+			for (auto y = 0; y < OverlayFont::GLYPH_HEIGHT; y++)
+			{
+				const auto row = OverlayFont::GLYPHS[glyph][y];
+
+				for (auto x = 0; x < OverlayFont::GLYPH_WIDTH; x++)
+					if (row & (0x80 >> x))
+						(*pixels)[(top + y) * ATLAS_WIDTH + left + x] = 255;
+			}
+		}
+
+		TextureSettings settings;
+		settings.wrap = TextureWrap::CLAMP_TO_EDGE;
+		settings.filter = TextureFilter::NEAREST;
+		settings.hasMipmaps = false;
+
+		const Image image(ATLAS_WIDTH, ATLAS_HEIGHT, 1, std::shared_ptr<const unsigned char>(pixels, pixels->data()));
+
+		glyphAtlas = std::make_unique<Texture>(std::vector<Image>{ image }, settings, "overlay glyph atlas");
+	}
+
+	//-------------------------------------------------------------------
+
+	glm::vec2 Overlay::GetGlyphTexCoord(const int glyph) const
+	{
+		return {
+			static_cast<float>(glyph % ATLAS_COLUMNS * OverlayFont::GLYPH_WIDTH) / ATLAS_WIDTH,
+			static_cast<float>(glyph / ATLAS_COLUMNS * OverlayFont::GLYPH_HEIGHT) / ATLAS_HEIGHT
+		};
+	}
+
+	//-------------------------------------------------------------------
+
+	void Overlay::AddQuad(const glm::vec2& min, const glm::vec2& max, const glm::vec2& texMin, const glm::vec2& texMax, const glm::vec4& color)
+	{
+		// Anything past the buffer capacity is dropped rather than growing it mid-frame
+		if (vertices.size() + 6 > MAX_VERTICES)
+			return;
+
+		const Vertex topLeft{ min, texMin, color };
+		const Vertex topRight{ { max.x, min.y }, { texMax.x, texMin.y }, color };
+		const Vertex bottomLeft{ { min.x, max.y }, { texMin.x, texMax.y }, color };
+		const Vertex bottomRight{ max, texMax, color };
+
+		vertices.insert(vertices.end(), { topLeft, bottomLeft, bottomRight, topLeft, bottomRight, topRight });
+	}
+
+	//-------------------------------------------------------------------
+
+	void Overlay::AddRectangle(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
+	{
+		// Sample the middle of the solid glyph so filtering never reaches its neighbours
+		const auto texCoord = GetGlyphTexCoord(OverlayFont::SOLID_GLYPH)
+			+ glm::vec2(0.5f * OverlayFont::GLYPH_WIDTH / ATLAS_WIDTH, 0.5f * OverlayFont::GLYPH_HEIGHT / ATLAS_HEIGHT);
+
+		AddQuad(position, position + size, texCoord, texCoord, color);
+	}
+
+	//-------------------------------------------------------------------
+
+	void Overlay::AddText(const glm::vec2& position, const std::string& text, const glm::vec4& color)
+	{
+		const glm::vec2 glyphSize(OverlayFont::GLYPH_WIDTH, OverlayFont::GLYPH_HEIGHT);
+		const glm::vec2 glyphTexSize(static_cast<float>(OverlayFont::GLYPH_WIDTH) / ATLAS_WIDTH,
+			static_cast<float>(OverlayFont::GLYPH_HEIGHT) / ATLAS_HEIGHT);
+
+		auto cursor = position;
+
+		for (const auto character : text)
+		{
+			if (character == '\n')
+			{
+				cursor = glm::vec2(position.x, cursor.y + LINE_HEIGHT);
+				continue;
+			}
+
+			const auto glyph = character - OverlayFont::FIRST_CHARACTER;
+
+			// Spaces and characters outside the font only advance the cursor
+			if (glyph > 0 && glyph < OverlayFont::SOLID_GLYPH)
+			{
+				const auto texCoord = GetGlyphTexCoord(glyph);
+				AddQuad(cursor, cursor + glyphSize, texCoord, texCoord + glyphTexSize, color);
+			}
+
+			cursor.x += CHARACTER_WIDTH;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void Overlay::AddGraph(const glm::vec2& position, const glm::vec2& size, const std::vector<float>& values, const float maxValue, const glm::vec4& color)
+	{
+		if (values.empty() || maxValue <= 0.0f)
+			return;
+
+		const auto barWidth = size.x / static_cast<float>(values.size());
+
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			const auto height = std::clamp(values[i] / maxValue, 0.0f, 1.0f) * size.y;
+
+			AddRectangle({ position.x + barWidth * i, position.y + size.y - height }, { barWidth, height }, color);
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void Overlay::Draw(const glm::ivec2& framebufferSize)
+	{
+		if (vertices.empty())
+			return;
+
+		const auto isDepthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
+		const auto isBlendEnabled = glIsEnabled(GL_BLEND);
+
+		glDisable(GL_DEPTH_TEST);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		// Orphan last frame's storage so the upload never waits for the GPU to finish reading it
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, MAX_VERTICES * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		program->Use();
+		program->SetVec2f("screenSize", glm::vec2(framebufferSize));
+
+		glyphAtlas->Bind(0);
+
+		glBindVertexArray(vertexArray);
+		glDrawArrays(GL_TRIANGLES, 0, static_cast<int>(vertices.size()));
+		glBindVertexArray(0);
+
+		program->Unuse();
+
+		if (isDepthTestEnabled)
+			glEnable(GL_DEPTH_TEST);
+
+		if (!isBlendEnabled)
+			glDisable(GL_BLEND);
+
+		vertices.clear();
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+//-------------------------------------------------------------------
+
+#include "ShaderProgram.hpp"
+#include "Texture.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	// Immediate mode 2D text and graph renderer. Everything added during a frame is written to
+	// one streaming vertex buffer and drawn by Draw with a single call and a single program,
+	// text and solid shapes both sample the same glyph atlas.
+	class Overlay
+	{
+		struct Vertex
+		{
+			glm::vec2 position;
+			glm::vec2 texCoord;
+			glm::vec4 color;
+		};
+
+		static constexpr size_t MAX_VERTICES = 6 * 4096;
+		static constexpr int ATLAS_COLUMNS = 16;
+
+		std::unique_ptr<ShaderProgram> program;
+		unsigned vertexArray = 0;
+		unsigned vertexBuffer = 0;
+		std::unique_ptr<Texture> glyphAtlas;
+
+		std::vector<Vertex> vertices;
+
+		void CreateGlyphAtlas();
+		void AddQuad(const glm::vec2& min, const glm::vec2& max, const glm::vec2& texMin, const glm::vec2& texMax, const glm::vec4& color);
+		[[nodiscard]] glm::vec2 GetGlyphTexCoord(int glyph) const;
+
+	public:
+		static constexpr float LINE_HEIGHT = 14.0f;
+		static constexpr float CHARACTER_WIDTH = 8.0f;
+
+		Overlay();
+		Overlay(const Overlay& other) = delete;
+		Overlay& operator=(const Overlay& other) = delete;
+		Overlay(Overlay&& other) = delete;
+		Overlay& operator=(Overlay&& other) = delete;
+		~Overlay();
+
+		// Positions are in pixels from the top left corner of the framebuffer.
+		void AddRectangle(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+		void AddText(const glm::vec2& position, const std::string& text, const glm::vec4& color);
+
+		// One bar per value, scaled so maxValue fills the height.
+		void AddGraph(const glm::vec2& position, const glm::vec2& size, const std::vector<float>& values, float maxValue, const glm::vec4& color);
+
+		// Uploads and draws everything added since the last call.
+		void Draw(const glm::ivec2& framebufferSize);
+	};
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace Graphics
+{
+	// Monospaced 1 bit font for the overlay, one byte per row with the leftmost pixel in the
+	// high bit. Covers printable ASCII from ' ' to '~' followed by a solid block that the
+	// overlay uses to draw untextured shapes.
+	struct OverlayFont
+	{
+		static constexpr int GLYPH_WIDTH = 8;
+		static constexpr int GLYPH_HEIGHT = 14;
+		static constexpr int FIRST_CHARACTER = 32;
+		static constexpr int GLYPH_COUNT = 96;
+		static constexpr int SOLID_GLYPH = GLYPH_COUNT - 1;
+
+		static const unsigned char GLYPHS[GLYPH_COUNT][GLYPH_HEIGHT];
+	};
+}
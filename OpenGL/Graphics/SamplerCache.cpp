@@ -0,0 +1,86 @@
+#include "SamplerCache.hpp"
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <glad/glad.h>
+
+#include "GLDebug.hpp"
+#include "GLExtensions.hpp"
+
+namespace Graphics
+{
+	namespace
+	{
+		using SamplerKey = std::tuple<TextureWrap, TextureFilter, bool>;
+
+		std::map<SamplerKey, GLuint> samplers;
+
+		GLint GetGLWrap(const TextureWrap wrap)
+		{
+			switch (wrap)
+			{
+			case TextureWrap::REPEAT:
+				return GL_REPEAT;
+			case TextureWrap::MIRRORED_REPEAT:
+				return GL_MIRRORED_REPEAT;
+			case TextureWrap::CLAMP_TO_EDGE:
+				return GL_CLAMP_TO_EDGE;
+			}
+
+			throw std::runtime_error("Unhandled texture wrap mode.");
+		}
+
+		GLint GetGLMinFilter(const TextureFilter filter, const bool hasMipmaps)
+		{
+			if (filter == TextureFilter::NEAREST)
+				return hasMipmaps ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST;
+
+			return hasMipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+		}
+
+		std::string GetLabel(const TextureWrap wrap, const TextureFilter filter, const bool hasMipmaps)
+		{
+			static const char* wrapNames[] = { "repeat", "mirrored repeat", "clamp to edge" };
+
+			return std::string("sampler ") + wrapNames[static_cast<int>(wrap)]
+				+ (filter == TextureFilter::NEAREST ? " nearest" : " linear") + (hasMipmaps ? " mipmapped" : "");
+		}
+	}
+
+	unsigned SamplerCache::Get(const TextureWrap wrap, const TextureFilter filter, const bool hasMipmaps)
+	{
+		const SamplerKey key(wrap, filter, hasMipmaps);
+
+		if (const auto found = samplers.find(key); found != samplers.end())
+			return found->second;
+
+		GLuint sampler;
+		glGenSamplers(1, &sampler);
+
+		GLDebug::SetObjectLabel(GL_SAMPLER, sampler, GetLabel(wrap, filter, hasMipmaps));
+
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, GetGLWrap(wrap));
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, GetGLWrap(wrap));
+		glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, GetGLMinFilter(filter, hasMipmaps));
+		glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, filter == TextureFilter::NEAREST ? GL_NEAREST : GL_LINEAR);
+
+		samplers.emplace(key, sampler);
+
+		return sampler;
+	}
+
+	void SamplerCache::Release()
+	{
+		for (const auto& [key, sampler] : samplers)
+			glDeleteSamplers(1, &sampler);
+
+		samplers.clear();
+	}
+
+	size_t SamplerCache::GetCount()
+	{
+		return samplers.size();
+	}
+}
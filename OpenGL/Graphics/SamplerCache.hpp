@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Texture.hpp"
+
+namespace Graphics
+{
+	// Sampler objects shared by every texture sampled the same way, one per distinct wrap and
+	// filter state. Textures bind theirs next to them, which overrides the sampling state of the
+	// texture object itself. All calls must happen on the thread owning the context.
+	class SamplerCache
+	{
+	public:
+		// Creates the sampler the first time the state is asked for.
+		[[nodiscard]] static unsigned Get(TextureWrap wrap, TextureFilter filter, bool hasMipmaps);
+
+		// Deletes the sampler objects, the context must still be current.
+		static void Release();
+
+		[[nodiscard]] static size_t GetCount();
+	};
+}
@@ -1,55 +1,77 @@
 #include "ShaderProgram.hpp"
 
-#include <fstream>
-#include <sstream>
+#include <stdexcept>
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "GLDebug.hpp"
+#include "GLExtensions.hpp"
+#include "../Utils/AssetPack.hpp"
+#include "../Utils/StartupTimer.hpp"
+
 namespace Graphics
 {
 	ShaderProgram::ShaderProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath)
 	{
-		const auto vertexShaderCode = ReadShaderFile(vertexShaderPath);
-		const auto fragmentShaderCode = ReadShaderFile(fragmentShaderPath);
+		const Utils::StartupPhase phase("Build shader program " + vertexShaderPath + " + " + fragmentShaderPath);
+
+		const auto vertexShaderCode = Utils::AssetPack::Load(vertexShaderPath);
+		const auto fragmentShaderCode = Utils::AssetPack::Load(fragmentShaderPath);
 
 		const auto vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
 		const auto fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
 
+		GLDebug::SetObjectLabel(GL_SHADER, vertexShaderId, vertexShaderPath);
+		GLDebug::SetObjectLabel(GL_SHADER, fragmentShaderId, fragmentShaderPath);
+
 		std::string errorMessage;
 
-		if (!CompileShader(vertexShaderId, vertexShaderCode, errorMessage))
+		// Many drivers defer most of the compilation to the link
 		{
-			DeleteShaders(vertexShaderId, fragmentShaderId);
+			const Utils::StartupPhase compilePhase("Compile");
 
-			throw std::exception(errorMessage.c_str());
-		}
+			if (!CompileShader(vertexShaderId, vertexShaderCode.GetText(), errorMessage))
+			{
+				DeleteShaders(vertexShaderId, fragmentShaderId);
 
-		if (!CompileShader(fragmentShaderId, fragmentShaderCode, errorMessage))
-		{
-			DeleteShaders(vertexShaderId, fragmentShaderId);
+				throw std::runtime_error(errorMessage.c_str());
+			}
 
-			throw std::exception(errorMessage.c_str());
+			if (!CompileShader(fragmentShaderId, fragmentShaderCode.GetText(), errorMessage))
+			{
+				DeleteShaders(vertexShaderId, fragmentShaderId);
+
+				throw std::runtime_error(errorMessage.c_str());
+			}
 		}
 
-		if (!LinkProgram(vertexShaderId, fragmentShaderId, errorMessage))
 		{
-			glDetachShader(id, vertexShaderId);
-			glDetachShader(id, fragmentShaderId);
-			
-			DeleteShaders(vertexShaderId, fragmentShaderId);
-			Delete();
+			const Utils::StartupPhase linkPhase("Link");
+
+			if (!LinkProgram(vertexShaderId, fragmentShaderId, errorMessage))
+			{
+				glDetachShader(id, vertexShaderId);
+				glDetachShader(id, fragmentShaderId);
+
+				DeleteShaders(vertexShaderId, fragmentShaderId);
+				Delete();
 
-			throw std::exception(errorMessage.c_str());
+				throw std::runtime_error(errorMessage.c_str());
+			}
 		}
 
 		glDetachShader(id, vertexShaderId);
 		glDetachShader(id, fragmentShaderId);
 
 		DeleteShaders(vertexShaderId, fragmentShaderId);
+
+		GLDebug::SetObjectLabel(GL_PROGRAM, id, vertexShaderPath + " + " + fragmentShaderPath);
+
+		CacheUniformLocations();
 	}
 
 	ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept
-		: id(other.id)
+		: id(other.id), uniformLocations(std::move(other.uniformLocations))
 	{
 		other.id = 0;
 	}
@@ -61,6 +83,7 @@ namespace Graphics
 			Delete();
 
 			id = other.id;
+			uniformLocations = std::move(other.uniformLocations);
 
 			other.id = 0;
 		}
@@ -137,26 +160,13 @@ namespace Graphics
 		glDeleteShader(fragmentShaderId);
 	}
 
-	std::string ShaderProgram::ReadShaderFile(const std::string& shaderPath)
+	bool ShaderProgram::CompileShader(unsigned shaderId, const std::string_view code, std::string& errorMessage)
 	{
-		std::ifstream shaderFile;
-		std::stringstream shaderStream;
-
-		shaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-		shaderFile.open(shaderPath);
+		// Mapped files are not null terminated
+		const auto codeData = code.data();
+		const auto codeLength = static_cast<GLint>(code.size());
 
-		shaderStream << shaderFile.rdbuf();
-		shaderFile.close();
-
-		return shaderStream.str();
-	}
-
-	bool ShaderProgram::CompileShader(unsigned shaderId, const std::string& code, std::string& errorMessage)
-	{
-		const auto codeCstr = code.c_str();
-
-		glShaderSource(shaderId, 1, &codeCstr, nullptr);
+		glShaderSource(shaderId, 1, &codeData, &codeLength);
 		glCompileShader(shaderId);
 
 		int status;
@@ -201,17 +211,60 @@ namespace Graphics
 		return true;
 	}
 
+	void ShaderProgram::CacheUniformLocations()
+	{
+		auto uniformCount = 0;
+		auto maxNameLength = 0;
+
+		glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &uniformCount);
+		glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+		std::string nameBuffer(maxNameLength, '\0');
+
+		for (auto i = 0; i < uniformCount; i++)
+		{
+			auto nameLength = 0;
+			auto size = 0;
+			unsigned type = 0;
+
+			glGetActiveUniform(id, i, maxNameLength, &nameLength, &size, &type, nameBuffer.data());
+
+			const std::string name(nameBuffer.data(), nameLength);
+			const auto location = glGetUniformLocation(id, name.c_str());
+
+			// Uniforms living in uniform blocks have no location
+			if (location == -1)
+				continue;
+
+			uniformLocations[name] = location;
+
+			// Arrays are reported once as "name[0]", allow them to be looked up by their plain name
+			// and by every other element, whose locations are not guaranteed to be contiguous
+			if (!name.ends_with("[0]"))
+				continue;
+
+			const auto baseName = name.substr(0, name.size() - 3);
+			uniformLocations[baseName] = location;
+
+			for (auto element = 1; element < size; element++)
+			{
+				const auto elementName = baseName + "[" + std::to_string(element) + "]";
+				uniformLocations[elementName] = glGetUniformLocation(id, elementName.c_str());
+			}
+		}
+	}
+
 	int ShaderProgram::GetUniformLocation(const std::string& name) const
 	{
-		const auto uniformLocation = glGetUniformLocation(id, name.c_str());
+		const auto umit = uniformLocations.find(name);
 
-		if (uniformLocation == -1)
+		if (umit == uniformLocations.end())
 		{
 			const std::string errorMessage = "Uniform '" + name + "' could not be found.";
-			throw std::exception(errorMessage.c_str());
+			throw std::runtime_error(errorMessage.c_str());
 		}
 
-		return uniformLocation;
+		return umit->second;
 	}
 
 	void ShaderProgram::Delete() const
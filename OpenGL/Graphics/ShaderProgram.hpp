@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
 namespace Graphics
@@ -9,15 +11,15 @@ namespace Graphics
 	{
 		unsigned id = 0;
 
-		static void DeleteShaders(unsigned vertexShaderId, unsigned fragmentShaderId);
+		std::unordered_map<std::string, int> uniformLocations;
 
-		static std::string ReadShaderFile(const std::string& shaderPath);
+		static void DeleteShaders(unsigned vertexShaderId, unsigned fragmentShaderId);
 
-		static bool CompileShader(unsigned shaderId, const std::string& code, std::string& errorMessage);
+		static bool CompileShader(unsigned shaderId, std::string_view code, std::string& errorMessage);
 
 		bool LinkProgram(unsigned vertexShaderId, unsigned fragmentShaderId, std::string& errorMessage);
 
-		[[nodiscard]] int GetUniformLocation(const std::string& name) const;
+		void CacheUniformLocations();
 
 		void Delete() const;
 
@@ -42,5 +44,10 @@ namespace Graphics
 		void SetVec4f(const std::string& name, const glm::vec4& value) const;
 		void SetMat3f(const std::string& name, const glm::mat3& value) const;
 		void SetMat4f(const std::string& name, const glm::mat4& value) const;
+
+		// Reads only the location cache built at link time, so it is safe to call from any thread.
+		[[nodiscard]] int GetUniformLocation(const std::string& name) const;
+
+		[[nodiscard]] unsigned GetId() const { return id; }
 	};
 }
\ No newline at end of file
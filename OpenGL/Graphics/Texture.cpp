@@ -0,0 +1,538 @@
+#include "Texture.hpp"
+
+#include <stdexcept>
+#include <glad/glad.h>
+
+#include "GLDebug.hpp"
+#include "GLExtensions.hpp"
+#include "SamplerCache.hpp"
+#include "../Utils/StartupTimer.hpp"
+
+namespace Graphics
+{
+	namespace
+	{
+		void GetGLFormat(const int channels, GLint& internalFormat, GLenum& format)
+		{
+			switch (channels)
+			{
+			case 1:
+				internalFormat = GL_R8;
+				format = GL_RED;
+				return;
+			case 2:
+				internalFormat = GL_RG8;
+				format = GL_RG;
+				return;
+			case 3:
+				internalFormat = GL_RGB8;
+				format = GL_RGB;
+				return;
+			case 4:
+				internalFormat = GL_RGBA8;
+				format = GL_RGBA;
+				return;
+			default:
+				throw std::runtime_error(("Unsupported texture channel count " + std::to_string(channels)).c_str());
+			}
+		}
+
+		GLenum GetGLCompressedFormat(const CompressedFormat format, const bool isSrgb)
+		{
+			switch (format)
+			{
+			case CompressedFormat::BC1:
+				return isSrgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			case CompressedFormat::BC3:
+				return isSrgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			case CompressedFormat::BC4:
+				return GL_COMPRESSED_RED_RGTC1;
+			case CompressedFormat::BC5:
+				return GL_COMPRESSED_RG_RGTC2;
+			case CompressedFormat::BC7:
+				return isSrgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+			case CompressedFormat::ETC2:
+				return isSrgb ? GL_COMPRESSED_SRGB8_ETC2 : GL_COMPRESSED_RGB8_ETC2;
+			}
+
+			throw std::runtime_error("Unhandled compressed format.");
+		}
+
+		int GetChannelCount(const CompressedFormat format)
+		{
+			switch (format)
+			{
+			case CompressedFormat::BC4:
+				return 1;
+			case CompressedFormat::BC5:
+				return 2;
+			case CompressedFormat::BC1:
+			case CompressedFormat::ETC2:
+				return 3;
+			default:
+				return 4;
+			}
+		}
+	}
+
+	Texture::Texture(const std::vector<Image>& levels, const TextureSettings& settings, const std::string& name,
+		const GpuAllocationSite site)
+		: Texture(levels, 0, settings, name, site)
+	{
+	}
+
+	Texture::Texture(const std::vector<Image>& levels, const int baseLevel, const TextureSettings& settings,
+		const std::string& name, const GpuAllocationSite site)
+		: baseLevel(baseLevel), allocatedLevel(baseLevel)
+	{
+		if (levels.empty())
+			throw std::runtime_error(("No levels to create " + name + " from.").c_str());
+
+		width = levels.front().GetWidth();
+		height = levels.front().GetHeight();
+		channels = levels.front().GetChannels();
+		levelCount = settings.hasMipmaps ? static_cast<int>(levels.size()) : 1;
+
+		if (baseLevel < 0 || baseLevel >= levelCount)
+			throw std::runtime_error(("Base level " + std::to_string(baseLevel) + " of " + name + " is out of range.").c_str());
+
+		for (auto i = 0; i < levelCount; i++)
+		{
+			const auto& level = levels[i];
+
+			if (level.GetWidth() != std::max(width >> i, 1) || level.GetHeight() != std::max(height >> i, 1)
+				|| level.GetChannels() != channels)
+				throw std::runtime_error(("Level " + std::to_string(i) + " of " + name + " does not match the size of level 0.").c_str());
+		}
+
+		Create(&levels, settings, name, site);
+	}
+
+	Texture::Texture(const CompressedImage& image, const TextureSettings& settings, const std::string& name,
+		const GpuAllocationSite site)
+		: width(image.GetWidth()), height(image.GetHeight()), channels(GetChannelCount(image.GetFormat()))
+	{
+		const auto& levels = image.GetLevels();
+		levelCount = settings.hasMipmaps ? static_cast<int>(levels.size()) : 1;
+		const auto format = GetGLCompressedFormat(image.GetFormat(), image.GetIsSrgb());
+
+		hasMipmaps = levelCount > 1;
+		sampler = SamplerCache::Get(settings.wrap, settings.filter, hasMipmaps);
+		isImmutable = GLExtensions::GetHasTextureStorage();
+
+		glGenTextures(1, &id);
+		glBindTexture(GL_TEXTURE_2D, id);
+
+		GLDebug::SetObjectLabel(GL_TEXTURE, id, name);
+
+		// A chain that stops short of 1x1 is still complete, immutable storage has only its levels
+		if (isImmutable)
+			GLExtensions::GetFunctions().texStorage2D(GL_TEXTURE_2D, levelCount, format, width, height);
+		else
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+		uint64_t size = 0;
+
+		{
+			const Utils::StartupPhase phase("Upload " + name);
+
+			for (auto i = 0; i < levelCount; i++)
+			{
+				const auto& level = levels[i];
+
+				if (isImmutable)
+				{
+					glCompressedTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.width, level.height, format,
+						static_cast<GLsizei>(level.size), image.GetData() + level.offset);
+				}
+				else
+				{
+					glCompressedTexImage2D(GL_TEXTURE_2D, i, format, level.width, level.height, 0,
+						static_cast<GLsizei>(level.size), image.GetData() + level.offset);
+				}
+
+				size += level.size;
+			}
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		GpuMemoryTracker::Register(GpuMemoryCategory::TEXTURE, id, size, name, site);
+	}
+
+	Texture::Texture(const int width, const int height, const int channels, const int levelCount,
+		const TextureSettings& settings, const std::string& name, const GpuAllocationSite site)
+		: width(width), height(height), channels(channels), levelCount(settings.hasMipmaps ? levelCount : 1)
+	{
+		Create(nullptr, settings, name, site);
+	}
+
+	void Texture::Create(const std::vector<Image>* levels, const TextureSettings& settings, const std::string& name,
+		const GpuAllocationSite site)
+	{
+		GLint internalFormat;
+		GLenum format;
+		GetGLFormat(channels, internalFormat, format);
+
+		hasMipmaps = settings.hasMipmaps;
+		sampler = SamplerCache::Get(settings.wrap, settings.filter, hasMipmaps);
+
+		// Streamed textures allocate and free their levels one at a time
+		isImmutable = baseLevel == 0 && GLExtensions::GetHasTextureStorage();
+
+		glGenTextures(1, &id);
+		glBindTexture(GL_TEXTURE_2D, id);
+
+		GLDebug::SetObjectLabel(GL_TEXTURE, id, name);
+
+		if (isImmutable)
+		{
+			// Room for the whole chain when the driver generates it
+			const auto storageLevelCount = hasMipmaps && levelCount == 1 ? MipGenerator::GetLevelCount(width, height) : levelCount;
+
+			GLExtensions::GetFunctions().texStorage2D(GL_TEXTURE_2D, storageLevelCount, internalFormat, width, height);
+		}
+		else
+		{
+			// A chain that stops short of 1x1 is still complete
+			if (levelCount > 1)
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+			if (baseLevel > 0)
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel);
+		}
+
+		{
+			const Utils::StartupPhase phase((levels != nullptr ? "Upload " : "Allocate ") + name);
+
+			// Rows of one and three channel images are not padded to four bytes
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+			for (auto i = allocatedLevel; i < levelCount; i++)
+			{
+				const auto levelWidth = std::max(width >> i, 1);
+				const auto levelHeight = std::max(height >> i, 1);
+				const auto pixels = levels != nullptr ? (*levels)[i].GetPixels() : nullptr;
+
+				if (!isImmutable)
+					glTexImage2D(GL_TEXTURE_2D, i, internalFormat, levelWidth, levelHeight, 0, format, GL_UNSIGNED_BYTE, pixels);
+				else if (pixels != nullptr)
+					glTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, levelWidth, levelHeight, format, GL_UNSIGNED_BYTE, pixels);
+			}
+
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+
+		if (levels != nullptr && hasMipmaps && levelCount == 1)
+		{
+			const Utils::StartupPhase phase("Generate mipmaps " + name);
+			glGenerateMipmap(GL_TEXTURE_2D);
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		GpuMemoryTracker::Register(GpuMemoryCategory::TEXTURE, id, GetStorageSize(), name, site);
+	}
+
+	Texture::Texture(Texture&& other) noexcept
+		: id(other.id), width(other.width), height(other.height), channels(other.channels), levelCount(other.levelCount),
+		hasMipmaps(other.hasMipmaps), sampler(other.sampler), baseLevel(other.baseLevel), allocatedLevel(other.allocatedLevel),
+		isImmutable(other.isImmutable)
+	{
+		other.id = 0;
+	}
+
+	Texture& Texture::operator=(Texture&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Delete();
+
+			id = other.id;
+			width = other.width;
+			height = other.height;
+			channels = other.channels;
+			levelCount = other.levelCount;
+			hasMipmaps = other.hasMipmaps;
+			sampler = other.sampler;
+			baseLevel = other.baseLevel;
+			allocatedLevel = other.allocatedLevel;
+			isImmutable = other.isImmutable;
+
+			other.id = 0;
+		}
+
+		return *this;
+	}
+
+	Texture::~Texture()
+	{
+		Delete();
+	}
+
+	void Texture::Bind(const unsigned unit) const
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_2D, id);
+		glBindSampler(unit, sampler);
+	}
+
+	void Texture::SetRows(const int level, const int firstRow, const int rowCount, const void* pixels) const
+	{
+		GLint internalFormat;
+		GLenum format;
+		GetGLFormat(channels, internalFormat, format);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, id);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, level, 0, firstRow, std::max(width >> level, 1), rowCount, format, GL_UNSIGNED_BYTE, pixels);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+
+	void Texture::GenerateMipmaps() const
+	{
+		if (!hasMipmaps || levelCount > 1)
+			return;
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, id);
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+
+	void Texture::AllocateLevel(const int level)
+	{
+		if (level != allocatedLevel - 1)
+			throw std::runtime_error(("Only level " + std::to_string(allocatedLevel - 1) + " can be allocated next.").c_str());
+
+		GLint internalFormat;
+		GLenum format;
+		GetGLFormat(channels, internalFormat, format);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, id);
+		glTexImage2D(GL_TEXTURE_2D, level, internalFormat, std::max(width >> level, 1), std::max(height >> level, 1), 0,
+			format, GL_UNSIGNED_BYTE, nullptr);
+
+		allocatedLevel = level;
+
+		GpuMemoryTracker::Resize(GpuMemoryCategory::TEXTURE, id, GetStorageSize());
+	}
+
+	void Texture::SetBaseLevel(const int level)
+	{
+		if (level < allocatedLevel || level >= levelCount)
+			throw std::runtime_error(("Level " + std::to_string(level) + " has no storage to sample from.").c_str());
+
+		GLint internalFormat;
+		GLenum format;
+		GetGLFormat(channels, internalFormat, format);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, id);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+
+		// Respecifying a level with no texels releases its storage
+		for (; !isImmutable && allocatedLevel < level; allocatedLevel++)
+			glTexImage2D(GL_TEXTURE_2D, allocatedLevel, internalFormat, 0, 0, 0, format, GL_UNSIGNED_BYTE, nullptr);
+
+		baseLevel = level;
+
+		GpuMemoryTracker::Resize(GpuMemoryCategory::TEXTURE, id, GetStorageSize());
+	}
+
+	bool Texture::GetIsFormatSupported(const CompressedFormat format, const bool isSrgb)
+	{
+		switch (format)
+		{
+		case CompressedFormat::BC1:
+		case CompressedFormat::BC3:
+			return GLExtensions::IsSupported("GL_EXT_texture_compression_s3tc") && (!isSrgb
+				|| GLExtensions::IsSupported("GL_EXT_texture_sRGB") || GLExtensions::IsSupported("GL_EXT_texture_compression_s3tc_srgb"));
+		case CompressedFormat::BC4:
+		case CompressedFormat::BC5:
+			return true;
+		case CompressedFormat::BC7:
+			return GLExtensions::IsVersionAtLeast(4, 2) || GLExtensions::IsSupported("GL_ARB_texture_compression_bptc");
+		case CompressedFormat::ETC2:
+			return GLExtensions::IsVersionAtLeast(4, 3) || GLExtensions::IsSupported("GL_ARB_ES3_compatibility");
+		}
+
+		return false;
+	}
+
+	uint64_t Texture::GetStorageSize() const
+	{
+		// Mipmaps generated by the driver
+		if (levelCount == 1)
+			return GpuMemoryTracker::GetTextureSize(width, height, channels, hasMipmaps);
+
+		uint64_t size = 0;
+
+		for (auto level = allocatedLevel; level < levelCount; level++)
+			size += static_cast<uint64_t>(std::max(width >> level, 1)) * std::max(height >> level, 1) * channels;
+
+		return size;
+	}
+
+	void Texture::Delete() const
+	{
+		if (id == 0)
+			return;
+
+		GpuMemoryTracker::Unregister(GpuMemoryCategory::TEXTURE, id);
+		glDeleteTextures(1, &id);
+	}
+
+	TextureArray::TextureArray(const std::vector<std::vector<Image>>& layers, const TextureSettings& settings,
+		const std::string& name, const GpuAllocationSite site)
+	{
+		if (layers.empty() || layers.front().empty())
+			throw std::runtime_error(("No layers to create " + name + " from.").c_str());
+
+		const auto& first = layers.front();
+
+		width = first.front().GetWidth();
+		height = first.front().GetHeight();
+		channels = first.front().GetChannels();
+		layerCount = static_cast<int>(layers.size());
+		levelCount = settings.hasMipmaps ? static_cast<int>(first.size()) : 1;
+		hasMipmaps = settings.hasMipmaps;
+
+		for (auto layer = 0; layer < layerCount; layer++)
+		{
+			if (layers[layer].size() != first.size())
+				throw std::runtime_error(("Layer " + std::to_string(layer) + " of " + name + " has a different level count.").c_str());
+
+			for (auto i = 0; i < levelCount; i++)
+			{
+				const auto& level = layers[layer][i];
+
+				if (level.GetWidth() != std::max(width >> i, 1) || level.GetHeight() != std::max(height >> i, 1)
+					|| level.GetChannels() != channels)
+				{
+					throw std::runtime_error(("Level " + std::to_string(i) + " of layer " + std::to_string(layer) + " of " + name
+						+ " does not match the size of level 0 of the first layer.").c_str());
+				}
+			}
+		}
+
+		GLint internalFormat;
+		GLenum format;
+		GetGLFormat(channels, internalFormat, format);
+
+		sampler = SamplerCache::Get(settings.wrap, settings.filter, hasMipmaps);
+
+		const auto isImmutable = GLExtensions::GetHasTextureStorage();
+
+		glGenTextures(1, &id);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+
+		GLDebug::SetObjectLabel(GL_TEXTURE, id, name);
+
+		if (isImmutable)
+		{
+			const auto storageLevelCount = hasMipmaps && levelCount == 1 ? MipGenerator::GetLevelCount(width, height) : levelCount;
+
+			GLExtensions::GetFunctions().texStorage3D(GL_TEXTURE_2D_ARRAY, storageLevelCount, internalFormat, width, height,
+				layerCount);
+		}
+		else if (levelCount > 1)
+		{
+			// A chain that stops short of 1x1 is still complete
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+		}
+
+		uint64_t size = 0;
+
+		{
+			const Utils::StartupPhase phase("Upload " + name);
+
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+			for (auto i = 0; i < levelCount; i++)
+			{
+				const auto levelWidth = std::max(width >> i, 1);
+				const auto levelHeight = std::max(height >> i, 1);
+
+				if (!isImmutable)
+				{
+					glTexImage3D(GL_TEXTURE_2D_ARRAY, i, internalFormat, levelWidth, levelHeight, layerCount, 0, format,
+						GL_UNSIGNED_BYTE, nullptr);
+				}
+
+				for (auto layer = 0; layer < layerCount; layer++)
+				{
+					glTexSubImage3D(GL_TEXTURE_2D_ARRAY, i, 0, 0, layer, levelWidth, levelHeight, 1, format, GL_UNSIGNED_BYTE,
+						layers[layer][i].GetPixels());
+				}
+
+				size += static_cast<uint64_t>(levelWidth) * levelHeight * channels * layerCount;
+			}
+
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+
+		if (hasMipmaps && levelCount == 1)
+		{
+			const Utils::StartupPhase phase("Generate mipmaps " + name);
+			glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+			size = GpuMemoryTracker::GetTextureSize(width, height, channels, true) * layerCount;
+		}
+
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+		GpuMemoryTracker::Register(GpuMemoryCategory::TEXTURE, id, size, name, site);
+	}
+
+	TextureArray::TextureArray(TextureArray&& other) noexcept
+		: id(other.id), width(other.width), height(other.height), channels(other.channels), layerCount(other.layerCount),
+		levelCount(other.levelCount), hasMipmaps(other.hasMipmaps), sampler(other.sampler)
+	{
+		other.id = 0;
+	}
+
+	TextureArray& TextureArray::operator=(TextureArray&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Delete();
+
+			id = other.id;
+			width = other.width;
+			height = other.height;
+			channels = other.channels;
+			layerCount = other.layerCount;
+			levelCount = other.levelCount;
+			hasMipmaps = other.hasMipmaps;
+			sampler = other.sampler;
+
+			other.id = 0;
+		}
+
+		return *this;
+	}
+
+	TextureArray::~TextureArray()
+	{
+		Delete();
+	}
+
+	void TextureArray::Bind(const unsigned unit) const
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+		glBindSampler(unit, sampler);
+	}
+
+	void TextureArray::Delete() const
+	{
+		if (id == 0)
+			return;
+
+		GpuMemoryTracker::Unregister(GpuMemoryCategory::TEXTURE, id);
+		glDeleteTextures(1, &id);
+	}
+}
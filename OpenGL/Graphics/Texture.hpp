@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "CompressedImage.hpp"
+#include "GpuMemoryTracker.hpp"
+#include "Image.hpp"
+#include "MipGenerator.hpp"
+
+namespace Graphics
+{
+	enum class TextureWrap
+	{
+		REPEAT,
+		MIRRORED_REPEAT,
+		CLAMP_TO_EDGE
+	};
+
+	enum class TextureFilter
+	{
+		NEAREST,
+		LINEAR
+	};
+
+	struct TextureSettings
+	{
+		TextureWrap wrap = TextureWrap::REPEAT;
+		TextureFilter filter = TextureFilter::LINEAR;
+		bool hasMipmaps = true;
+
+		// How the texture loader builds mipmaps on the CPU. Turn isSrgb off for data such as normal
+		// or height maps, whose values are not sRGB encoded.
+		MipFilter mipFilter = MipFilter::KAISER;
+		bool isSrgb = true;
+
+		// Keeps the decoded image and its mip chain for later loads, see ImageCache
+		bool isImageCacheEnabled = true;
+
+		// Images are stored top row first, GL expects the bottom row first
+		bool isFlippedVertically = true;
+
+		// Loads <name>.ktx2 from next to the image instead when the compress tool produced one
+		// with the same row order and the context supports its format
+		bool isCompressedVariantPreferred = true;
+	};
+
+	class Texture
+	{
+		unsigned id = 0;
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		int levelCount = 1;
+		bool hasMipmaps = false;
+		unsigned sampler = 0;
+
+		// Levels below allocatedLevel have no storage, sampling starts at baseLevel
+		int baseLevel = 0;
+		int allocatedLevel = 0;
+
+		// Storage allocated once with glTexStorage2D, its levels can no longer be respecified
+		bool isImmutable = false;
+
+		void Create(const std::vector<Image>* levels, const TextureSettings& settings, const std::string& name, GpuAllocationSite site);
+		void Delete() const;
+
+		[[nodiscard]] uint64_t GetStorageSize() const;
+
+	public:
+		// Uploads the levels as they are, only the first without mipmaps. A single level gets its
+		// mipmaps from glGenerateMipmap. Textures get immutable storage for exactly their levels
+		// when the context supports it, sampled through the shared sampler for their settings.
+		// Must be called on the thread owning the context.
+		Texture(const std::vector<Image>& levels, const TextureSettings& settings, const std::string& name,
+			GpuAllocationSite site = GpuAllocationSite::Current());
+
+		// Uploads only the levels from baseLevel on and samples from it, see SetBaseLevel. A base
+		// level above 0 keeps the storage mutable, so the streamer can allocate and free levels.
+		Texture(const std::vector<Image>& levels, int baseLevel, const TextureSettings& settings, const std::string& name,
+			GpuAllocationSite site = GpuAllocationSite::Current());
+
+		// Uploads the levels as they are, only level 0 without mipmaps.
+		Texture(const CompressedImage& image, const TextureSettings& settings, const std::string& name,
+			GpuAllocationSite site = GpuAllocationSite::Current());
+
+		// Allocates storage for the levels without filling them, the contents are undefined until
+		// SetRows. A single level gets its mipmaps from GenerateMipmaps.
+		Texture(int width, int height, int channels, int levelCount, const TextureSettings& settings, const std::string& name,
+			GpuAllocationSite site = GpuAllocationSite::Current());
+		Texture(const Texture& other) = delete;
+		Texture& operator=(const Texture& other) = delete;
+		Texture(Texture&& other) noexcept;
+		Texture& operator=(Texture&& other) noexcept;
+		~Texture();
+
+		// Binds the sampler to the unit as well.
+		void Bind(unsigned unit) const;
+
+		// Replaces whole rows of a level. With a buffer bound to GL_PIXEL_UNPACK_BUFFER, pixels is
+		// an offset into it. Leaves the texture unit 0 binding changed.
+		void SetRows(int level, int firstRow, int rowCount, const void* pixels) const;
+
+		// Does nothing for textures created without mipmaps or with their levels.
+		void GenerateMipmaps() const;
+
+		// Gives storage to the level above the finest one that has it, so it can be streamed in with
+		// SetRows while sampling still starts further down. Leaves the texture unit 0 binding changed.
+		void AllocateLevel(int level);
+
+		// Makes sampling start at the level, which must have storage, and frees the levels above it
+		// unless the storage is immutable. Leaves the texture unit 0 binding changed.
+		void SetBaseLevel(int level);
+
+		[[nodiscard]] unsigned GetId() const { return id; }
+		[[nodiscard]] unsigned GetSampler() const { return sampler; }
+		[[nodiscard]] int GetWidth() const { return width; }
+		[[nodiscard]] int GetHeight() const { return height; }
+		[[nodiscard]] int GetChannels() const { return channels; }
+		[[nodiscard]] int GetLevelCount() const { return levelCount; }
+		[[nodiscard]] int GetBaseLevel() const { return baseLevel; }
+		[[nodiscard]] bool GetIsImmutable() const { return isImmutable; }
+		[[nodiscard]] size_t GetRowSize(int level = 0) const { return static_cast<size_t>(std::max(width >> level, 1)) * channels; }
+
+		[[nodiscard]] static bool GetIsFormatSupported(CompressedFormat format, bool isSrgb);
+	};
+
+	// Layers of the same size and format behind a single binding, sampled with a sampler2DArray
+	class TextureArray
+	{
+		unsigned id = 0;
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		int layerCount = 0;
+		int levelCount = 1;
+		bool hasMipmaps = false;
+		unsigned sampler = 0;
+
+		void Delete() const;
+
+	public:
+		// Takes each layer's mip chain, which all have the same length. Chains of a single level get
+		// their mipmaps from glGenerateMipmap. Storage is immutable when the context supports it.
+		// Must be called on the thread owning the context.
+		TextureArray(const std::vector<std::vector<Image>>& layers, const TextureSettings& settings, const std::string& name,
+			GpuAllocationSite site = GpuAllocationSite::Current());
+		TextureArray(const TextureArray& other) = delete;
+		TextureArray& operator=(const TextureArray& other) = delete;
+		TextureArray(TextureArray&& other) noexcept;
+		TextureArray& operator=(TextureArray&& other) noexcept;
+		~TextureArray();
+
+		// Binds the sampler to the unit as well.
+		void Bind(unsigned unit) const;
+
+		[[nodiscard]] unsigned GetId() const { return id; }
+		[[nodiscard]] unsigned GetSampler() const { return sampler; }
+		[[nodiscard]] int GetWidth() const { return width; }
+		[[nodiscard]] int GetHeight() const { return height; }
+		[[nodiscard]] int GetChannels() const { return channels; }
+		[[nodiscard]] int GetLayerCount() const { return layerCount; }
+		[[nodiscard]] int GetLevelCount() const { return levelCount; }
+	};
+}
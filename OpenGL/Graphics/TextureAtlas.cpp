@@ -0,0 +1,234 @@
+#include "TextureAtlas.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+//-------------------------------------------------------------------
+
+#include "../Utils/AssetPack.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	namespace
+	{
+		constexpr char MAGIC[4] = { 'A', 'T', 'L', 'S' };
+		constexpr uint32_t VERSION = 1;
+
+		constexpr uint32_t FLAG_FLIPPED_VERTICALLY = 1;
+
+		// Followed by the entries, each with its name after it, then by every layer's levels, largest first
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t flags;
+
+			uint32_t width;
+			uint32_t height;
+			uint32_t channels;
+			uint32_t layerCount;
+			uint32_t levelCount;
+			uint32_t entryCount;
+		};
+
+		struct EntryHeader
+		{
+			uint32_t layer;
+			uint32_t x;
+			uint32_t y;
+			uint32_t width;
+			uint32_t height;
+			uint32_t nameLength;
+		};
+	}
+
+	//-------------------------------------------------------------------
+
+	TextureAtlas::TextureAtlas(std::vector<std::vector<Image>> layers, std::vector<TextureAtlasEntry> entries,
+		const bool isFlippedVertically)
+		: layers(std::move(layers)), entries(std::move(entries)), isFlippedVertically(isFlippedVertically)
+	{
+		if (this->layers.empty() || this->layers.front().empty())
+			throw std::runtime_error("An atlas needs at least one layer.");
+
+		const auto width = GetWidth();
+		const auto height = GetHeight();
+		const auto channels = GetChannels();
+		const auto levelCount = GetLevelCount();
+
+		for (const auto& layer : this->layers)
+		{
+			if (static_cast<int>(layer.size()) != levelCount)
+				throw std::runtime_error("Every layer of an atlas needs the same level count.");
+
+			for (auto i = 0; i < levelCount; i++)
+			{
+				if (layer[i].GetWidth() != std::max(width >> i, 1) || layer[i].GetHeight() != std::max(height >> i, 1)
+					|| layer[i].GetChannels() != channels)
+					throw std::runtime_error(("Level " + std::to_string(i) + " of an atlas layer does not match the first layer.").c_str());
+			}
+		}
+
+		for (auto& entry : this->entries)
+		{
+			if (entry.layer < 0 || entry.layer >= GetLayerCount() || entry.x < 0 || entry.y < 0 || entry.width <= 0
+				|| entry.height <= 0 || entry.x + entry.width > width || entry.y + entry.height > height)
+				throw std::runtime_error(("Atlas entry " + entry.name + " is out of bounds.").c_str());
+
+			entry.uvScale = glm::vec2(entry.width, entry.height) / glm::vec2(width, height);
+			entry.uvOffset = glm::vec2(entry.x, entry.y) / glm::vec2(width, height);
+		}
+
+		std::sort(this->entries.begin(), this->entries.end(), [](const TextureAtlasEntry& a, const TextureAtlasEntry& b)
+		{
+			return a.name < b.name;
+		});
+	}
+
+	//-------------------------------------------------------------------
+
+	TextureAtlas TextureAtlas::Load(const std::string& path)
+	{
+		const auto asset = Utils::AssetPack::Load(path);
+		size_t offset = 0;
+
+		const auto read = [&asset, &offset, &path](void* destination, const size_t size)
+		{
+			if (size > asset.GetSize() - offset)
+				throw std::runtime_error(("Truncated texture atlas " + path).c_str());
+
+			std::memcpy(destination, asset.GetData() + offset, size);
+			offset += size;
+		};
+
+		Header header{};
+		read(&header, sizeof(header));
+
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+			throw std::runtime_error((path + " is not a texture atlas.").c_str());
+
+		const auto width = static_cast<int>(header.width);
+		const auto height = static_cast<int>(header.height);
+		const auto channels = static_cast<int>(header.channels);
+		const auto levelCount = static_cast<int>(header.levelCount);
+
+		if (width <= 0 || height <= 0 || channels < 1 || channels > 4 || header.layerCount == 0 || levelCount <= 0
+			|| levelCount > MipGenerator::GetLevelCount(width, height))
+			throw std::runtime_error(("Unsupported texture atlas " + path).c_str());
+
+		std::vector<TextureAtlasEntry> entries(header.entryCount);
+
+		for (auto& entry : entries)
+		{
+			EntryHeader entryHeader{};
+			read(&entryHeader, sizeof(entryHeader));
+
+			entry.name.resize(entryHeader.nameLength);
+			read(entry.name.data(), entry.name.size());
+
+			entry.layer = static_cast<int>(entryHeader.layer);
+			entry.x = static_cast<int>(entryHeader.x);
+			entry.y = static_cast<int>(entryHeader.y);
+			entry.width = static_cast<int>(entryHeader.width);
+			entry.height = static_cast<int>(entryHeader.height);
+		}
+
+		size_t layerSize = 0;
+
+		for (auto i = 0; i < levelCount; i++)
+			layerSize += static_cast<size_t>(std::max(width >> i, 1)) * std::max(height >> i, 1) * channels;
+
+		if (asset.GetSize() - offset != layerSize * header.layerCount)
+			throw std::runtime_error(("Truncated texture atlas " + path).c_str());
+
+		// The levels point into the mapped file
+		std::vector<std::vector<Image>> layers(header.layerCount);
+
+		for (auto& layer : layers)
+		{
+			for (auto i = 0; i < levelCount; i++)
+			{
+				layer.emplace_back(std::max(width >> i, 1), std::max(height >> i, 1), channels, asset.GetPointer(offset));
+				offset += layer.back().GetSize();
+			}
+		}
+
+		return { std::move(layers), std::move(entries), (header.flags & FLAG_FLIPPED_VERTICALLY) != 0 };
+	}
+
+	//-------------------------------------------------------------------
+
+	void TextureAtlas::Save(const std::string& path) const
+	{
+		Header header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.flags = isFlippedVertically ? FLAG_FLIPPED_VERTICALLY : 0;
+		header.width = static_cast<uint32_t>(GetWidth());
+		header.height = static_cast<uint32_t>(GetHeight());
+		header.channels = static_cast<uint32_t>(GetChannels());
+		header.layerCount = static_cast<uint32_t>(GetLayerCount());
+		header.levelCount = static_cast<uint32_t>(GetLevelCount());
+		header.entryCount = static_cast<uint32_t>(entries.size());
+
+		std::ofstream file(path, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		for (const auto& entry : entries)
+		{
+			const EntryHeader entryHeader{ static_cast<uint32_t>(entry.layer), static_cast<uint32_t>(entry.x),
+				static_cast<uint32_t>(entry.y), static_cast<uint32_t>(entry.width), static_cast<uint32_t>(entry.height),
+				static_cast<uint32_t>(entry.name.size()) };
+
+			file.write(reinterpret_cast<const char*>(&entryHeader), sizeof(entryHeader));
+			file.write(entry.name.data(), static_cast<std::streamsize>(entry.name.size()));
+		}
+
+		for (const auto& layer : layers)
+		{
+			for (const auto& level : layer)
+				file.write(reinterpret_cast<const char*>(level.GetPixels()), static_cast<std::streamsize>(level.GetSize()));
+		}
+
+		if (!file)
+			throw std::runtime_error(("Failed to write " + path).c_str());
+	}
+
+	//-------------------------------------------------------------------
+
+	const TextureAtlasEntry* TextureAtlas::Find(const std::string& name) const
+	{
+		const auto it = std::lower_bound(entries.begin(), entries.end(), name, [](const TextureAtlasEntry& entry, const std::string& value)
+		{
+			return entry.name < value;
+		});
+
+		return it != entries.end() && it->name == name ? &*it : nullptr;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::shared_ptr<Texture> TextureAtlas::CreateTexture(const TextureSettings& settings, const std::string& name,
+		const GpuAllocationSite site) const
+	{
+		if (GetLayerCount() != 1)
+			throw std::runtime_error((name + " has " + std::to_string(GetLayerCount()) + " layers and needs a texture array.").c_str());
+
+		return std::make_shared<Texture>(layers.front(), settings, name, site);
+	}
+
+	//-------------------------------------------------------------------
+
+	std::shared_ptr<TextureArray> TextureAtlas::CreateTextureArray(const TextureSettings& settings, const std::string& name,
+		const GpuAllocationSite site) const
+	{
+		return std::make_shared<TextureArray>(layers, settings, name, site);
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+//-------------------------------------------------------------------
+
+#include "Image.hpp"
+#include "Texture.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	// Where a packed image ended up
+	struct TextureAtlasEntry
+	{
+		// Path of the source image as the pack tool was given it, with forward slashes
+		std::string name;
+		int layer = 0;
+
+		// Texels of level 0 the image covers in its layer, without the padding around it
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+
+		// Maps the image's own texture coordinates into the layer: uv * uvScale + uvOffset
+		glm::vec2 uvScale = glm::vec2(1.0f);
+		glm::vec2 uvOffset = glm::vec2(0.0f);
+	};
+
+	// Images packed by the pack tool into the layers of one texture, so materials using any of
+	// them share a binding. A layer holds either a single image, when they all have the same size,
+	// or several images side by side with their edges repeated around them, and the entries tell
+	// materials where each image went. Coordinates of images sharing a layer must stay within
+	// [0, 1], they cannot repeat.
+	class TextureAtlas
+	{
+		// Each layer's mip chain, all the same length
+		std::vector<std::vector<Image>> layers;
+
+		// Sorted by name
+		std::vector<TextureAtlasEntry> entries;
+
+		// Rows run bottom to top, as GL expects them, rather than top to bottom
+		bool isFlippedVertically = true;
+
+	public:
+		TextureAtlas() = default;
+		TextureAtlas(std::vector<std::vector<Image>> layers, std::vector<TextureAtlasEntry> entries, bool isFlippedVertically);
+
+		// Throws when the file is not an atlas this class could have written.
+		static TextureAtlas Load(const std::string& path);
+		void Save(const std::string& path) const;
+
+		// Returns null when no image of that name was packed.
+		[[nodiscard]] const TextureAtlasEntry* Find(const std::string& name) const;
+
+		// Only for atlases of a single layer. Must be called on the thread owning the context.
+		[[nodiscard]] std::shared_ptr<Texture> CreateTexture(const TextureSettings& settings, const std::string& name,
+			GpuAllocationSite site = GpuAllocationSite::Current()) const;
+
+		// Must be called on the thread owning the context.
+		[[nodiscard]] std::shared_ptr<TextureArray> CreateTextureArray(const TextureSettings& settings, const std::string& name,
+			GpuAllocationSite site = GpuAllocationSite::Current()) const;
+
+		[[nodiscard]] const std::vector<TextureAtlasEntry>& GetEntries() const { return entries; }
+		[[nodiscard]] const std::vector<std::vector<Image>>& GetLayers() const { return layers; }
+		[[nodiscard]] bool GetIsFlippedVertically() const { return isFlippedVertically; }
+		[[nodiscard]] int GetWidth() const { return layers.front().front().GetWidth(); }
+		[[nodiscard]] int GetHeight() const { return layers.front().front().GetHeight(); }
+		[[nodiscard]] int GetChannels() const { return layers.front().front().GetChannels(); }
+		[[nodiscard]] int GetLayerCount() const { return static_cast<int>(layers.size()); }
+		[[nodiscard]] int GetLevelCount() const { return static_cast<int>(layers.front().size()); }
+	};
+}
@@ -0,0 +1,152 @@
+#include "TextureCache.hpp"
+
+//-------------------------------------------------------------------
+
+#include <iomanip>
+#include <tuple>
+
+//-------------------------------------------------------------------
+
+#include "../Utils/ContentPath.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	bool TextureCache::Key::operator<(const Key& other) const
+	{
+		return std::tie(path, wrap, filter, hasMipmaps, mipFilter, isSrgb, isFlippedVertically, isCompressedVariantPreferred)
+			< std::tie(other.path, other.wrap, other.filter, other.hasMipmaps, other.mipFilter, other.isSrgb,
+				other.isFlippedVertically, other.isCompressedVariantPreferred);
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<std::shared_ptr<Texture>> TextureCache::Load(const std::vector<TextureRequest>& requests,
+		Utils::ThreadPool& threadPool, TextureUploader* uploader, TextureStreamer* streamer)
+	{
+		std::vector<std::shared_ptr<Texture>> textures(requests.size());
+
+		TextureLoader loader(threadPool, uploader, streamer);
+
+		// Index into the loader's result for each request that missed, the same image requested
+		// twice in a batch is only loaded once
+		std::map<Key, size_t> batch;
+		std::vector<std::pair<size_t, size_t>> pending;
+
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			auto key = GetKey(requests[i]);
+			const auto found = entries.find(key);
+
+			if (found != entries.end())
+			{
+				textures[i] = found->second.lock();
+
+				if (textures[i] != nullptr)
+				{
+					hits++;
+					continue;
+				}
+			}
+
+			const auto loading = batch.find(key);
+
+			if (loading != batch.end())
+			{
+				hits++;
+				pending.emplace_back(i, loading->second);
+				continue;
+			}
+
+			misses++;
+
+			const auto index = loader.Add(key.path, requests[i].settings);
+			batch.emplace(std::move(key), index);
+			pending.emplace_back(i, index);
+		}
+
+		if (pending.empty())
+			return textures;
+
+		const auto loaded = loader.Load();
+
+		for (const auto& [request, index] : pending)
+			textures[request] = loaded[index];
+
+		for (const auto& [key, index] : batch)
+			entries[key] = loaded[index];
+
+		Prune();
+
+		return textures;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::shared_ptr<Texture> TextureCache::Find(const TextureRequest& request) const
+	{
+		const auto found = entries.find(GetKey(request));
+
+		return found != entries.end() ? found->second.lock() : nullptr;
+	}
+
+	//-------------------------------------------------------------------
+
+	void TextureCache::Prune()
+	{
+		for (auto entry = entries.begin(); entry != entries.end();)
+		{
+			if (entry->second.expired())
+				entry = entries.erase(entry);
+			else
+				++entry;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	TextureCacheStats TextureCache::GetStats() const
+	{
+		TextureCacheStats stats;
+		stats.hits = hits;
+		stats.misses = misses;
+
+		for (const auto& entry : entries)
+			if (!entry.second.expired())
+				stats.liveTextures++;
+
+		return stats;
+	}
+
+	//-------------------------------------------------------------------
+
+	void TextureCache::PrintReport(std::ostream& stream) const
+	{
+		const auto stats = GetStats();
+
+		if (stats.hits + stats.misses == 0)
+			return;
+
+		const auto flags = stream.flags();
+		const auto precision = stream.precision();
+
+		stream << std::fixed << std::setprecision(1)
+			<< "Texture cache: " << stats.hits + stats.misses << " lookups, " << stats.hits << " hits ("
+			<< stats.GetHitRate() * 100.0 << "%), " << stats.liveTextures << " textures alive" << std::endl;
+
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+
+	//-------------------------------------------------------------------
+
+	TextureCache::Key TextureCache::GetKey(const TextureRequest& request)
+	{
+		auto path = Utils::ContentPath::Normalize(request.path);
+
+		return { std::move(path), request.settings.wrap, request.settings.filter, request.settings.hasMipmaps,
+			request.settings.mipFilter, request.settings.isSrgb, request.settings.isFlippedVertically,
+			request.settings.isCompressedVariantPreferred };
+	}
+}
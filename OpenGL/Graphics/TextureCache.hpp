@@ -0,0 +1,81 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "Texture.hpp"
+#include "TextureLoader.hpp"
+#include "TextureStreamer.hpp"
+#include "TextureUploader.hpp"
+#include "../Utils/ThreadPool.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	struct TextureCacheStats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		size_t liveTextures = 0;
+
+		[[nodiscard]] double GetHitRate() const
+		{
+			const auto lookups = hits + misses;
+			return lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+		}
+	};
+
+	// Hands out shared textures keyed by normalized path and settings, so an image used in several
+	// places is decoded and uploaded once. The cache only holds weak references, a texture's GPU
+	// memory is released as soon as the last handle to it is dropped.
+	// Every method must be called on the thread owning the context.
+	class TextureCache
+	{
+		struct Key
+		{
+			std::string path;
+			TextureWrap wrap;
+			TextureFilter filter;
+			bool hasMipmaps;
+			MipFilter mipFilter;
+			bool isSrgb;
+			bool isFlippedVertically;
+			bool isCompressedVariantPreferred;
+
+			bool operator<(const Key& other) const;
+		};
+
+		std::map<Key, std::weak_ptr<Texture>> entries;
+
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+
+		static Key GetKey(const TextureRequest& request);
+
+	public:
+		// Returns one texture per request, in order. Textures still alive are shared, the rest
+		// are loaded in a single TextureLoader batch, streamed through the uploader or the streamer
+		// if given.
+		std::vector<std::shared_ptr<Texture>> Load(const std::vector<TextureRequest>& requests,
+			Utils::ThreadPool& threadPool, TextureUploader* uploader = nullptr, TextureStreamer* streamer = nullptr);
+
+		// Null when the texture is not alive, does not count as a lookup.
+		[[nodiscard]] std::shared_ptr<Texture> Find(const TextureRequest& request) const;
+
+		// Drops the entries of textures that have been released.
+		void Prune();
+
+		[[nodiscard]] TextureCacheStats GetStats() const;
+
+		void PrintReport(std::ostream& stream) const;
+	};
+}
@@ -0,0 +1,163 @@
+#include "TextureLoader.hpp"
+
+#include <filesystem>
+#include <future>
+
+#include "ImageCache.hpp"
+#include "../Utils/CpuProfiler.hpp"
+#include "../Utils/AssetPack.hpp"
+#include "../Utils/StartupTimer.hpp"
+
+namespace Graphics
+{
+	namespace
+	{
+		struct DecodedTexture
+		{
+			std::vector<Image> levels;
+			CompressedImage compressed;
+			bool isCompressed = false;
+
+			DecodedTexture() = default;
+
+			explicit DecodedTexture(std::vector<Image> levels)
+				: levels(std::move(levels))
+			{
+			}
+
+			explicit DecodedTexture(CompressedImage compressed)
+				: compressed(std::move(compressed)), isCompressed(true)
+			{
+			}
+		};
+
+		DecodedTexture Decode(const TextureRequest& request)
+		{
+			const auto& settings = request.settings;
+
+			if (settings.isCompressedVariantPreferred)
+			{
+				const auto compressedPath = std::filesystem::path(request.path).replace_extension(".ktx2");
+
+				if (Utils::AssetPack::Exists(compressedPath.string()))
+				{
+					auto compressed = CompressedImage::Load(compressedPath.string());
+
+					if (compressed.GetIsFlippedVertically() == settings.isFlippedVertically
+						&& Texture::GetIsFormatSupported(compressed.GetFormat(), compressed.GetIsSrgb()))
+						return DecodedTexture(std::move(compressed));
+				}
+			}
+
+			const MipSettings mipSettings{ settings.mipFilter, settings.isSrgb };
+
+			// Hashed and, on a cache miss, decoded from the same mapping
+			const auto source = Utils::AssetPack::Load(request.path);
+
+			if (!settings.isImageCacheEnabled)
+			{
+				auto image = Image::Decode(source.GetData(), source.GetSize(), request.path, settings.isFlippedVertically);
+
+				if (!settings.hasMipmaps)
+					return DecodedTexture({ std::move(image) });
+
+				const Utils::StartupPhase phase("Generate mipmaps " + request.path);
+
+				// Already on a worker, images are spread over the pool rather than their rows
+				return DecodedTexture(MipGenerator::Generate(image, mipSettings));
+			}
+
+			const ImageCache cache(source.GetData(), source.GetSize(), mipSettings, settings.isFlippedVertically, settings.hasMipmaps);
+
+			if (auto levels = cache.Load(); !levels.empty())
+				return DecodedTexture(std::move(levels));
+
+			auto image = Image::Decode(source.GetData(), source.GetSize(), request.path, settings.isFlippedVertically);
+			std::vector<Image> levels;
+
+			if (settings.hasMipmaps)
+			{
+				const Utils::StartupPhase phase("Generate mipmaps " + request.path);
+				levels = MipGenerator::Generate(image, mipSettings);
+			}
+			else
+				levels.push_back(std::move(image));
+
+			// Filtered first, the expanded alpha is opaque at every level
+			levels = ImageCache::Normalize(std::move(levels));
+			cache.Save(levels);
+
+			return DecodedTexture(std::move(levels));
+		}
+	}
+
+	TextureLoader::TextureLoader(Utils::ThreadPool& threadPool, TextureUploader* uploader, TextureStreamer* streamer)
+		: threadPool(threadPool), uploader(uploader), streamer(streamer)
+	{
+	}
+
+	size_t TextureLoader::Add(std::string path, const TextureSettings& settings)
+	{
+		requests.push_back({ std::move(path), settings });
+
+		return requests.size() - 1;
+	}
+
+	std::vector<std::shared_ptr<Texture>> TextureLoader::Load()
+	{
+		std::vector<std::future<DecodedTexture>> decodes;
+		decodes.reserve(requests.size());
+
+		for (const auto& request : requests)
+		{
+			decodes.push_back(threadPool.Enqueue([&request]
+			{
+				CPU_ZONE("Decode image");
+				const Utils::StartupPhase phase("Decode " + request.path);
+
+				return Decode(request);
+			}));
+		}
+
+		std::vector<std::shared_ptr<Texture>> textures;
+		textures.reserve(requests.size());
+
+		try
+		{
+			for (size_t i = 0; i < requests.size(); i++)
+			{
+				DecodedTexture decoded;
+
+				{
+					const Utils::StartupPhase phase("Wait for decode " + requests[i].path);
+					decoded = decodes[i].get();
+				}
+
+				// Compressed levels are small and come with their mipmaps, they are not worth streaming
+				if (decoded.isCompressed)
+					textures.push_back(std::make_shared<Texture>(decoded.compressed, requests[i].settings, requests[i].path));
+				else if (streamer != nullptr)
+					textures.push_back(streamer->Add(std::move(decoded.levels), requests[i].settings, requests[i].path));
+				else if (uploader != nullptr)
+					textures.push_back(uploader->Enqueue(std::move(decoded.levels), requests[i].settings, requests[i].path));
+				else
+					textures.push_back(std::make_shared<Texture>(decoded.levels, requests[i].settings, requests[i].path));
+			}
+		}
+		catch (...)
+		{
+			// The tasks reference the requests, they must not outlive them
+			for (auto& decode : decodes)
+			{
+				if (decode.valid())
+					decode.wait();
+			}
+
+			throw;
+		}
+
+		requests.clear();
+
+		return textures;
+	}
+}
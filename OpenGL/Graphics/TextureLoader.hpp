@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Texture.hpp"
+#include "TextureStreamer.hpp"
+#include "TextureUploader.hpp"
+#include "../Utils/ThreadPool.hpp"
+
+namespace Graphics
+{
+	struct TextureRequest
+	{
+		std::string path;
+		TextureSettings settings;
+	};
+
+	// Decodes every added image concurrently on the pool and uploads them on the calling thread,
+	// which must own the context. Uploads start as soon as the first image is decoded, so the
+	// decoding of the others overlaps with them. Given an uploader, the pixels are streamed in
+	// over the following frames instead, and given a streamer only their small levels are, the
+	// rest on demand. Mipmaps are generated on the workers with MipGenerator, and the decoded
+	// levels are kept in an ImageCache, so later loads map them instead of decoding. Compressed
+	// variants, see TextureSettings, are read rather than decoded and uploaded level by level.
+	class TextureLoader
+	{
+		Utils::ThreadPool& threadPool;
+		TextureUploader* uploader;
+		TextureStreamer* streamer;
+		std::vector<TextureRequest> requests;
+
+	public:
+		explicit TextureLoader(Utils::ThreadPool& threadPool, TextureUploader* uploader = nullptr,
+			TextureStreamer* streamer = nullptr);
+
+		// Returns the index of the texture in the result of Load.
+		size_t Add(std::string path, const TextureSettings& settings = {});
+
+		// Throws once every decode has finished if any of the images could not be loaded.
+		std::vector<std::shared_ptr<Texture>> Load();
+	};
+}
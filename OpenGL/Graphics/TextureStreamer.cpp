@@ -0,0 +1,222 @@
+#include "TextureStreamer.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+
+//-------------------------------------------------------------------
+
+#include "../Utils/CpuProfiler.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	TextureStreamer::TextureStreamer(TextureUploader& uploader, const uint64_t budget)
+		: uploader(uploader), budget(budget)
+	{
+		stats.budget = budget;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::shared_ptr<Texture> TextureStreamer::Add(std::vector<Image> levels, const TextureSettings& settings,
+		const std::string& name, const GpuAllocationSite site)
+	{
+		if (!settings.hasMipmaps || levels.size() <= 1)
+			return uploader.Enqueue(std::move(levels), settings, name, site);
+
+		const auto levelCount = static_cast<int>(levels.size());
+		auto tailLevel = levelCount - 1;
+
+		while (tailLevel > 0 && std::max(levels[tailLevel - 1].GetWidth(), levels[tailLevel - 1].GetHeight()) <= TAIL_SIZE)
+			tailLevel--;
+
+		auto texture = std::make_shared<Texture>(levels, tailLevel, settings, name, site);
+
+		Entry entry;
+		entry.texture = texture;
+		entry.levels = std::move(levels);
+		entry.baseLevel = tailLevel;
+		entry.tailLevel = tailLevel;
+		entry.requestedLevel = levelCount;
+		entry.lastNeededFrames.resize(static_cast<size_t>(levelCount));
+
+		// A texture that died since the last Update may have left its name behind
+		if (const auto stale = entries.find(texture->GetId()); stale != entries.end())
+		{
+			stats.residentBytes -= GetResidentSize(stale->second);
+			entries.erase(stale);
+		}
+
+		stats.residentBytes += GetResidentSize(entry);
+		entries.emplace(texture->GetId(), std::move(entry));
+
+		return texture;
+	}
+
+	//-------------------------------------------------------------------
+
+	void TextureStreamer::Request(const Texture& texture, const float level)
+	{
+		const auto it = entries.find(texture.GetId());
+
+		if (it == entries.end() || it->second.texture.lock().get() != &texture)
+			return;
+
+		auto& entry = it->second;
+		const auto levelCount = static_cast<int>(entry.levels.size());
+		const auto requestedLevel = std::clamp(static_cast<int>(std::floor(level)), 0, levelCount - 1);
+
+		for (auto i = requestedLevel; i < std::min(entry.requestedLevel, levelCount); i++)
+			entry.lastNeededFrames[i] = frame;
+
+		entry.requestedLevel = std::min(entry.requestedLevel, requestedLevel);
+	}
+
+	//-------------------------------------------------------------------
+
+	void TextureStreamer::Update()
+	{
+		CPU_ZONE("Texture streaming");
+
+		std::vector<Entry*> wanting;
+
+		for (auto it = entries.begin(); it != entries.end();)
+		{
+			auto& entry = it->second;
+			const auto texture = entry.texture.lock();
+
+			if (texture == nullptr)
+			{
+				stats.residentBytes -= GetResidentSize(entry);
+				it = entries.erase(it);
+				continue;
+			}
+
+			// The fence has passed, so no draw can sample the level before it is filled
+			if (entry.pendingLevel >= 0 && uploader.GetIsComplete(*texture))
+			{
+				texture->SetBaseLevel(entry.pendingLevel);
+				entry.baseLevel = entry.pendingLevel;
+				entry.pendingLevel = -1;
+
+				stats.streamedLevels++;
+			}
+
+			if (entry.pendingLevel < 0 && entry.requestedLevel < entry.baseLevel)
+				wanting.push_back(&entry);
+
+			++it;
+		}
+
+		// Blurriest first, a level at a time so every texture gets sharper at the same pace
+		std::stable_sort(wanting.begin(), wanting.end(), [](const Entry* a, const Entry* b)
+		{
+			return a->baseLevel - a->requestedLevel > b->baseLevel - b->requestedLevel;
+		});
+
+		stats.missingBytes = 0;
+
+		for (const auto entry : wanting)
+		{
+			const auto level = entry->baseLevel - 1;
+			const auto size = static_cast<uint64_t>(entry->levels[level].GetSize());
+
+			if (budget != 0 && stats.residentBytes + size > budget && !Evict(stats.residentBytes + size - budget, *entry))
+			{
+				for (auto i = entry->requestedLevel; i < entry->baseLevel; i++)
+					stats.missingBytes += entry->levels[i].GetSize();
+
+				continue;
+			}
+
+			const auto texture = entry->texture.lock();
+			texture->AllocateLevel(level);
+			uploader.Enqueue(texture, level, { entry->levels[level] });
+
+			entry->pendingLevel = level;
+			stats.residentBytes += size;
+		}
+
+		for (auto& [id, entry] : entries)
+			entry.requestedLevel = static_cast<int>(entry.levels.size());
+
+		frame++;
+	}
+
+	//-------------------------------------------------------------------
+
+	TextureStreamerStats TextureStreamer::GetStats() const
+	{
+		auto result = stats;
+		result.textures = entries.size();
+
+		return result;
+	}
+
+	//-------------------------------------------------------------------
+
+	float TextureStreamer::ComputeLevel(const glm::mat4& projection, const int viewportHeight, const float distance,
+		const float texelsPerUnit)
+	{
+		// How many pixels a world unit covers vertically at the distance
+		const auto pixelsPerUnit = projection[1][1] * static_cast<float>(viewportHeight) / (2.0f * std::max(distance, 0.0001f));
+
+		return std::log2(std::max(texelsPerUnit / pixelsPerUnit, 1.0f));
+	}
+
+	//-------------------------------------------------------------------
+
+	uint64_t TextureStreamer::GetResidentSize(const Entry& entry) const
+	{
+		uint64_t size = 0;
+
+		for (auto i = entry.pendingLevel >= 0 ? entry.pendingLevel : entry.baseLevel; i < static_cast<int>(entry.levels.size()); i++)
+			size += entry.levels[i].GetSize();
+
+		return size;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool TextureStreamer::Evict(const uint64_t size, const Entry& requester)
+	{
+		uint64_t freed = 0;
+
+		while (freed < size)
+		{
+			Entry* victim = nullptr;
+
+			for (auto& [id, entry] : entries)
+			{
+				if (&entry == &requester || entry.pendingLevel >= 0 || entry.baseLevel >= entry.tailLevel)
+					continue;
+
+				// Levels needed this frame stay, evicting them would only bring them back
+				const auto lastNeededFrame = entry.lastNeededFrames[entry.baseLevel];
+
+				if (lastNeededFrame >= frame)
+					continue;
+
+				if (victim == nullptr || lastNeededFrame < victim->lastNeededFrames[victim->baseLevel])
+					victim = &entry;
+			}
+
+			if (victim == nullptr)
+				return false;
+
+			const auto levelSize = static_cast<uint64_t>(victim->levels[victim->baseLevel].GetSize());
+
+			victim->texture.lock()->SetBaseLevel(victim->baseLevel + 1);
+			victim->baseLevel++;
+
+			freed += levelSize;
+			stats.residentBytes -= levelSize;
+			stats.evictedLevels++;
+		}
+
+		return true;
+	}
+}
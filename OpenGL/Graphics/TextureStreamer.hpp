@@ -0,0 +1,101 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+//-------------------------------------------------------------------
+
+#include "Image.hpp"
+#include "Texture.hpp"
+#include "TextureUploader.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	struct TextureStreamerStats
+	{
+		size_t textures = 0;
+
+		// Storage of every streamed texture's levels, including the ones still uploading
+		uint64_t residentBytes = 0;
+		uint64_t budget = 0;
+
+		// Requested levels that could not be streamed in without going over the budget
+		uint64_t missingBytes = 0;
+
+		uint64_t streamedLevels = 0;
+		uint64_t evictedLevels = 0;
+	};
+
+	// Keeps only the mip levels that are needed on the GPU. Textures start with the small levels
+	// of their chain and sample from the finest one through GL_TEXTURE_BASE_LEVEL. Every frame
+	// the renderer requests the level each texture is seen at, and Update streams the next finer
+	// level in through the uploader, blurriest textures first. When that would exceed the budget,
+	// the finest levels of the textures needed least recently are freed to make room.
+	//
+	// The whole chain stays in CPU memory. Every method must be called on the thread owning the context.
+	class TextureStreamer
+	{
+		struct Entry
+		{
+			std::weak_ptr<Texture> texture;
+			std::vector<Image> levels;
+
+			// Finest resident level, and the one being uploaded above it if any
+			int baseLevel = 0;
+			int pendingLevel = -1;
+
+			// Never evicted, streamed textures always have something to sample
+			int tailLevel = 0;
+
+			// Finest level requested this frame, the level count when none was
+			int requestedLevel = 0;
+
+			// Frame each level was last needed in, a request for a level needs the coarser ones too
+			std::vector<uint64_t> lastNeededFrames;
+		};
+
+		TextureUploader& uploader;
+		uint64_t budget;
+
+		std::map<unsigned, Entry> entries;
+		uint64_t frame = 1;
+
+		TextureStreamerStats stats;
+
+		[[nodiscard]] uint64_t GetResidentSize(const Entry& entry) const;
+		bool Evict(uint64_t size, const Entry& requester);
+
+	public:
+		// Levels this size and smaller are uploaded right away and stay resident
+		static constexpr int TAIL_SIZE = 64;
+
+		// A budget of 0 streams in every requested level and never evicts.
+		TextureStreamer(TextureUploader& uploader, uint64_t budget);
+
+		// Falls back to the uploader for textures without mipmaps.
+		std::shared_ptr<Texture> Add(std::vector<Image> levels, const TextureSettings& settings, const std::string& name,
+			GpuAllocationSite site = GpuAllocationSite::Current());
+
+		// Called while rendering, for every use of the texture. Ignores textures it does not stream.
+		void Request(const Texture& texture, float level);
+
+		// Called once per frame after rendering.
+		void Update();
+
+		[[nodiscard]] TextureStreamerStats GetStats() const;
+
+		// Level whose texels are about the size of a pixel on a surface facing the camera at the
+		// distance, given how many texels of level 0 cover a world unit on it. Surfaces seen at
+		// an angle would do with a coarser one, so it errs on the sharp side.
+		[[nodiscard]] static float ComputeLevel(const glm::mat4& projection, int viewportHeight, float distance, float texelsPerUnit);
+	};
+}
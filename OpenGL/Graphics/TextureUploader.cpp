@@ -0,0 +1,312 @@
+#include "TextureUploader.hpp"
+
+//-------------------------------------------------------------------
+
+#include <stdexcept>
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+
+//-------------------------------------------------------------------
+
+#include "GLDebug.hpp"
+#include "GLExtensions.hpp"
+#include "GpuMemoryTracker.hpp"
+#include "../Utils/CpuProfiler.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	namespace
+	{
+		// Keeps every copy aligned for the fastest memcpy and DMA paths
+		constexpr size_t ALIGNMENT = 256;
+
+		constexpr size_t FRAMES_IN_FLIGHT = 3;
+
+		size_t AlignUp(const size_t value)
+		{
+			return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	TextureUploader::TextureUploader(const uint64_t bytesPerFrame, const size_t capacity)
+		: capacity(AlignUp(capacity != 0 ? capacity : static_cast<size_t>(bytesPerFrame) * FRAMES_IN_FLIGHT)),
+		bytesPerFrame(bytesPerFrame)
+	{
+		if (bytesPerFrame == 0)
+			throw std::runtime_error("The texture upload budget must not be 0.");
+
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+		GLDebug::SetObjectLabel(GL_BUFFER, buffer, "texture upload ring");
+
+		const auto size = static_cast<GLsizeiptr>(this->capacity);
+
+		if (GLExtensions::GetHasBufferStorage())
+		{
+			constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+			GLExtensions::GetFunctions().bufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+			mapping = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags));
+		}
+		else
+		{
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+		}
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		GpuMemoryTracker::Register(GpuMemoryCategory::STAGING, buffer, this->capacity, "texture upload ring");
+	}
+
+	//-------------------------------------------------------------------
+
+	TextureUploader::~TextureUploader()
+	{
+		for (const auto& submission : submissions)
+			glDeleteSync(static_cast<GLsync>(submission.fence));
+
+		if (mapping != nullptr)
+		{
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+
+		GpuMemoryTracker::Unregister(GpuMemoryCategory::STAGING, buffer);
+		glDeleteBuffers(1, &buffer);
+	}
+
+	//-------------------------------------------------------------------
+
+	std::shared_ptr<Texture> TextureUploader::Enqueue(std::vector<Image> levels, const TextureSettings& settings,
+		const std::string& name, const GpuAllocationSite site)
+	{
+		if (levels.empty())
+			throw std::runtime_error(("No levels to upload " + name + " from.").c_str());
+
+		const auto& image = levels.front();
+
+		auto texture = std::make_shared<Texture>(image.GetWidth(), image.GetHeight(), image.GetChannels(),
+			static_cast<int>(levels.size()), settings, name, site);
+
+		// Levels the texture has no storage for are dropped
+		levels.resize(static_cast<size_t>(texture->GetLevelCount()));
+
+		Enqueue(texture, 0, std::move(levels));
+
+		return texture;
+	}
+
+	//-------------------------------------------------------------------
+
+	void TextureUploader::Enqueue(std::shared_ptr<Texture> texture, const int firstLevel, std::vector<Image> levels)
+	{
+		// Rows are never split, one has to fit in the ring and leave room for the next frame's
+		if (AlignUp(texture->GetRowSize(firstLevel)) > capacity / 2)
+			throw std::runtime_error("A texture row does not fit in the texture upload ring.");
+
+		for (const auto& level : levels)
+			stats.pendingBytes += level.GetSize();
+
+		incomplete.push_back(texture->GetId());
+		uploads.push_back({ std::move(texture), std::move(levels), firstLevel });
+	}
+
+	//-------------------------------------------------------------------
+
+	void TextureUploader::Update()
+	{
+		CPU_ZONE("Texture uploads");
+
+		Retire();
+
+		if (uploads.empty())
+			return;
+
+		if (submissions.empty())
+			head = tail = 0;
+
+		Submission submission;
+		uint64_t budget = bytesPerFrame;
+		auto isRingFull = false;
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+		while (!uploads.empty() && budget > 0)
+		{
+			auto& upload = uploads.front();
+			const auto& image = upload.levels[upload.level];
+
+			const auto textureLevel = upload.firstLevel + upload.level;
+			const auto rowSize = upload.texture->GetRowSize(textureLevel);
+			const auto rowsLeft = image.GetHeight() - upload.nextRow;
+
+			// A row larger than the budget still goes out, alone, so progress never stops
+			auto rows = static_cast<int>(std::min<uint64_t>(rowsLeft, budget / rowSize));
+
+			if (rows == 0)
+			{
+				if (budget < bytesPerFrame)
+					break;
+
+				rows = 1;
+			}
+
+			// Never asks for more than half the ring, so a whole frame of it is always in flight
+			rows = std::min(rows, static_cast<int>(capacity / 2 / rowSize));
+
+			size_t offset;
+
+			if (!Allocate(AlignUp(rows * rowSize), offset))
+			{
+				isRingFull = true;
+				break;
+			}
+
+			const auto size = rows * rowSize;
+			Write(offset, image.GetPixels() + upload.nextRow * rowSize, size);
+
+			upload.texture->SetRows(textureLevel, upload.nextRow, rows, reinterpret_cast<const void*>(offset));
+
+			upload.nextRow += rows;
+			budget -= std::min<uint64_t>(budget, size);
+
+			stats.uploadedBytes += size;
+			stats.pendingBytes -= size;
+
+			if (upload.nextRow < image.GetHeight())
+				continue;
+
+			upload.nextRow = 0;
+
+			if (++upload.level == static_cast<int>(upload.levels.size()))
+			{
+				upload.texture->GenerateMipmaps();
+				submission.completed.push_back(std::move(upload.texture));
+				uploads.pop_front();
+			}
+		}
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		if (isRingFull)
+			stats.stalledFrames++;
+
+		if (budget == bytesPerFrame && submission.completed.empty())
+			return;
+
+		submission.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		submission.end = head;
+		submissions.push_back(std::move(submission));
+
+		// Without it the fence might never reach the GPU before the next frame checks it
+		glFlush();
+	}
+
+	//-------------------------------------------------------------------
+
+	bool TextureUploader::GetIsComplete(const Texture& texture) const
+	{
+		return std::find(incomplete.begin(), incomplete.end(), texture.GetId()) == incomplete.end();
+	}
+
+	//-------------------------------------------------------------------
+
+	TextureUploaderStats TextureUploader::GetStats() const
+	{
+		auto result = stats;
+		result.pendingTextures = incomplete.size();
+
+		return result;
+	}
+
+	//-------------------------------------------------------------------
+
+	void TextureUploader::Retire()
+	{
+		while (!submissions.empty())
+		{
+			auto& submission = submissions.front();
+			const auto fence = static_cast<GLsync>(submission.fence);
+
+			const auto status = glClientWaitSync(fence, 0, 0);
+
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+				break;
+
+			glDeleteSync(fence);
+			tail = submission.end;
+
+			for (const auto& texture : submission.completed)
+			{
+				incomplete.erase(std::find(incomplete.begin(), incomplete.end(), texture->GetId()));
+				stats.completedTextures++;
+			}
+
+			submissions.pop_front();
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	bool TextureUploader::Allocate(const size_t size, size_t& offset)
+	{
+		// The bytes in flight are [tail, head), wrapping around when head is behind tail.
+		// head never catches up with tail, equal offsets mean an empty ring.
+		if (head >= tail)
+		{
+			if (capacity - head >= size)
+			{
+				offset = head;
+				head += size;
+				return true;
+			}
+
+			if (size < tail)
+			{
+				offset = 0;
+				head = size;
+				return true;
+			}
+
+			return false;
+		}
+
+		if (tail - head > size)
+		{
+			offset = head;
+			head += size;
+			return true;
+		}
+
+		return false;
+	}
+
+	//-------------------------------------------------------------------
+
+	void TextureUploader::Write(const size_t offset, const unsigned char* data, const size_t size) const
+	{
+		if (mapping != nullptr)
+		{
+			std::memcpy(mapping + offset, data, size);
+			return;
+		}
+
+		// Fences keep the GPU off this range, the driver does not have to
+		constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+
+		const auto destination = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, static_cast<GLintptr>(offset),
+			static_cast<GLsizeiptr>(size), flags);
+
+		std::memcpy(destination, data, size);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	}
+}
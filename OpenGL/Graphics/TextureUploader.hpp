@@ -0,0 +1,106 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "Image.hpp"
+#include "Texture.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Graphics
+{
+	struct TextureUploaderStats
+	{
+		size_t pendingTextures = 0;
+		uint64_t pendingBytes = 0;
+
+		uint64_t uploadedBytes = 0;
+		uint64_t completedTextures = 0;
+
+		// Frames that had work left but found the staging ring full of data the GPU had not consumed
+		uint64_t stalledFrames = 0;
+	};
+
+	// Streams textures to the GPU through a ring of pixel buffer memory. Update copies at most the
+	// per-frame budget of rows into the ring and issues glTexSubImage2D from it, so the driver reads
+	// the pixels asynchronously instead of copying them during the call. A fence per frame tells
+	// when the GPU is done with a part of the ring, the ring is never waited on.
+	//
+	// The ring is persistently mapped when the context supports buffer storage, otherwise every copy
+	// maps its range unsynchronized. Every method must be called on the thread owning the context.
+	class TextureUploader
+	{
+		struct Upload
+		{
+			std::shared_ptr<Texture> texture;
+			std::vector<Image> levels;
+
+			// Texture level of the first image
+			int firstLevel = 0;
+			int level = 0;
+			int nextRow = 0;
+		};
+
+		struct Submission
+		{
+			void* fence = nullptr;
+
+			// Ring offset after the last byte written in the frame
+			size_t end = 0;
+
+			// Textures whose last rows went out in the frame
+			std::vector<std::shared_ptr<Texture>> completed;
+		};
+
+		unsigned buffer = 0;
+		unsigned char* mapping = nullptr;
+
+		size_t capacity;
+		size_t head = 0;
+		size_t tail = 0;
+
+		uint64_t bytesPerFrame;
+
+		std::deque<Upload> uploads;
+		std::deque<Submission> submissions;
+		std::vector<unsigned> incomplete;
+
+		TextureUploaderStats stats;
+
+		void Retire();
+		bool Allocate(size_t size, size_t& offset);
+		void Write(size_t offset, const unsigned char* data, size_t size) const;
+
+	public:
+		// The ring holds a few frames of uploads, so the GPU has time to consume them.
+		explicit TextureUploader(uint64_t bytesPerFrame, size_t capacity = 0);
+		TextureUploader(const TextureUploader& other) = delete;
+		TextureUploader& operator=(const TextureUploader& other) = delete;
+		TextureUploader(TextureUploader&& other) = delete;
+		TextureUploader& operator=(TextureUploader&& other) = delete;
+		~TextureUploader();
+
+		// Creates the texture right away, its contents are undefined until GetIsComplete returns true.
+		// Levels are streamed largest first, a single level gets its mipmaps once it is complete.
+		std::shared_ptr<Texture> Enqueue(std::vector<Image> levels, const TextureSettings& settings, const std::string& name,
+			GpuAllocationSite site = GpuAllocationSite::Current());
+
+		// Streams into levels of an existing texture from firstLevel on, which must have storage.
+		void Enqueue(std::shared_ptr<Texture> texture, int firstLevel, std::vector<Image> levels);
+
+		// Called once per frame before rendering.
+		void Update();
+
+		[[nodiscard]] bool GetIsComplete(const Texture& texture) const;
+		[[nodiscard]] bool GetIsIdle() const { return uploads.empty() && submissions.empty(); }
+		[[nodiscard]] TextureUploaderStats GetStats() const;
+	};
+}
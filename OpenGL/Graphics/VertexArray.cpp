@@ -1,12 +1,21 @@
 #include "VertexArray.hpp"
 
+#include <stdexcept>
 #include <glad/glad.h>
 
+#include "GLDebug.hpp"
+#include "GLExtensions.hpp"
+
 namespace Graphics
 {
-	VertexArray::VertexArray()
+	VertexArray::VertexArray(const std::string& name)
 	{
 		glGenVertexArrays(1, &id);
+
+		// The object only exists once bound, labeling it before fails
+		Bind();
+		GLDebug::SetObjectLabel(GL_VERTEX_ARRAY, id, name);
+		Unbind();
 	}
 
 	VertexArray::VertexArray(VertexArray&& other) noexcept
@@ -47,7 +56,7 @@ namespace Graphics
 	void VertexArray::SetVertexBuffer(std::unique_ptr<VertexBuffer> vb)
 	{
 		if (vb == nullptr)
-			throw std::exception("Vertex Buffer cannot be null.");
+			throw std::runtime_error("Vertex Buffer cannot be null.");
 
 		Bind();
 
@@ -60,7 +69,7 @@ namespace Graphics
 	void VertexArray::SetElementBuffer(std::unique_ptr<ElementBuffer> eb)
 	{
 		if (eb == nullptr)
-			throw std::exception("Vertex Buffer cannot be null.");
+			throw std::runtime_error("Vertex Buffer cannot be null.");
 
 		Bind();
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include "ElementBuffer.hpp"
 #include "VertexBuffer.hpp"
@@ -17,7 +18,7 @@ namespace Graphics
 		void Delete();
 
 	public:
-		VertexArray();
+		explicit VertexArray(const std::string& name = "vertex array");
 		VertexArray(const VertexArray& other) = delete;
 		VertexArray& operator=(const VertexArray& other) = delete;
 		VertexArray(VertexArray&& other) noexcept;
@@ -31,6 +32,7 @@ namespace Graphics
 		void SetElementBuffer(std::unique_ptr<ElementBuffer> eb);
 
 		[[nodiscard]] ElementBuffer* GetEBO() { return ebo.get(); }
+		[[nodiscard]] unsigned int GetId() const { return id; }
 	};
 
 }
\ No newline at end of file
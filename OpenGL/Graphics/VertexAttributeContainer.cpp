@@ -1,5 +1,6 @@
 #include "VertexAttributeContainer.hpp"
 
+#include <stdexcept>
 #include <glad/glad.h>
 
 namespace Graphics
@@ -38,7 +39,7 @@ namespace Graphics
 
 		const std::string errorMessage = "Unhandled Vertex attribute type " + std::to_string(static_cast<int>(type));
 
-		throw std::exception(errorMessage.c_str());
+		throw std::runtime_error(errorMessage.c_str());
 	}
 
 	int GetComponentCount(const VertexAttributeType type)
@@ -61,7 +62,7 @@ namespace Graphics
 
 		const std::string errorMessage = "Unhandled Vertex attribute type " + std::to_string(static_cast<int>(type));
 
-		throw std::exception(errorMessage.c_str());
+		throw std::runtime_error(errorMessage.c_str());
 	}
 
 	int GetComponentGLType(const VertexAttributeType type)
@@ -79,7 +80,7 @@ namespace Graphics
 
 		const std::string errorMessage = "Unhandled Vertex attribute type " + std::to_string(static_cast<int>(type));
 
-		throw std::exception(errorMessage.c_str());
+		throw std::runtime_error(errorMessage.c_str());
 	}
 
 	
@@ -2,17 +2,25 @@
 
 #include <glad/glad.h>
 
+#include "GLDebug.hpp"
+#include "GLExtensions.hpp"
+#include "GpuMemoryTracker.hpp"
+
 namespace Graphics
 {
 
-	VertexBuffer::VertexBuffer(const void* data, const size_t size)
+	VertexBuffer::VertexBuffer(const void* data, const size_t size, std::string name, const GpuAllocationSite site)
 	{
 		glGenBuffers(1, &id);
 
 		Bind();
 
+		GLDebug::SetObjectLabel(GL_BUFFER, id, name);
+
 		glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
 		Unbind();
+
+		GpuMemoryTracker::Register(GpuMemoryCategory::VERTEX_BUFFER, id, size, std::move(name), site);
 	}
 
 	VertexBuffer::VertexBuffer(VertexBuffer&& other) noexcept
@@ -70,6 +78,7 @@ namespace Graphics
 
 	void VertexBuffer::Delete() const
 	{
+		GpuMemoryTracker::Unregister(GpuMemoryCategory::VERTEX_BUFFER, id);
 		glDeleteBuffers(1, &id);
 	}
 }
\ No newline at end of file
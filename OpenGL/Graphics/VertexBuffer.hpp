@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+
+#include "GpuMemoryTracker.hpp"
 #include "VertexAttributeContainer.hpp"
 
 namespace Graphics
@@ -13,7 +16,8 @@ namespace Graphics
 		void Delete() const;
 
 	public:
-		VertexBuffer(const void* data, size_t size);
+		VertexBuffer(const void* data, size_t size, std::string name = "vertex buffer",
+			GpuAllocationSite site = GpuAllocationSite::Current());
 		VertexBuffer(const VertexBuffer& other) = delete;
 		VertexAttribute& operator=(const VertexBuffer& other) = delete;
 		VertexBuffer(VertexBuffer&& other) noexcept;
@@ -2,31 +2,40 @@
 
 //-------------------------------------------------------------------
 
+#include <stdexcept>
+
+//-------------------------------------------------------------------
+
 namespace Input
 {
 	void InputManager::PressKey(const Keys key)
 	{
-		keyMap[key] = true;
+		Submit({ 0, InputEventType::KEY_PRESS, static_cast<int>(key) });
 	}
 
-	void InputManager::ReleaseKey(Keys key)
+	void InputManager::ReleaseKey(const Keys key)
 	{
-		keyMap[key] = false;
+		Submit({ 0, InputEventType::KEY_RELEASE, static_cast<int>(key) });
 	}
 
-	void InputManager::PressButton(MouseButtons button)
+	void InputManager::PressButton(const MouseButtons button)
 	{
-		buttonMap[button] = true;
+		Submit({ 0, InputEventType::BUTTON_PRESS, static_cast<int>(button) });
 	}
 
-	void InputManager::ReleaseButton(MouseButtons button)
+	void InputManager::ReleaseButton(const MouseButtons button)
 	{
-		buttonMap[button] = false;
+		Submit({ 0, InputEventType::BUTTON_RELEASE, static_cast<int>(button) });
 	}
 
-	void InputManager::Scroll(float value)
+	void InputManager::SetCursorPosition(const float x, const float y)
 	{
-		scrollValue = value;
+		Submit({ 0, InputEventType::CURSOR_POSITION, 0, glm::vec2(x, y) });
+	}
+
+	void InputManager::Scroll(const float value)
+	{
+		Submit({ 0, InputEventType::SCROLL, 0, glm::vec2(value, 0.0f) });
 	}
 
 	bool InputManager::IsKeyDown(Keys key)
@@ -39,6 +48,16 @@ namespace Input
 		return false;
 	}
 
+	bool InputManager::IsKeyPressed(const Keys key) const
+	{
+		return pressedKeys.find(key) != pressedKeys.end();
+	}
+
+	bool InputManager::ConsumeKeyPress(const Keys key)
+	{
+		return pressedKeys.erase(key) != 0;
+	}
+
 	bool InputManager::IsButtonDown(MouseButtons button)
 	{
 		const auto umit = buttonMap.find(button);
@@ -52,7 +71,129 @@ namespace Input
 	void InputManager::ResetState()
 	{
 		scrollValue = 0.0f;
+		pressedKeys.clear();
+	}
+
+	//-------------------------------------------------------------------
+
+	void InputManager::BeginStep()
+	{
+		if (replay != nullptr)
+		{
+			const auto& events = replay->GetEvents();
+
+			while (nextReplayEvent < events.size() && events[nextReplayEvent].step <= step)
+				Apply(events[nextReplayEvent++]);
+		}
+
+		step++;
+	}
+
+	//-------------------------------------------------------------------
+
+	void InputManager::StartRecording(const double fixedTimeStep)
+	{
+		recording = std::make_unique<InputRecording>(fixedTimeStep);
+		step = 0;
+
+		recording->Add({ 0, InputEventType::CURSOR_POSITION, 0, cursorPosition });
+
+		for (const auto& [key, isDown] : keyMap)
+			if (isDown)
+				recording->Add({ 0, InputEventType::KEY_PRESS, static_cast<int>(key) });
+
+		for (const auto& [button, isDown] : buttonMap)
+			if (isDown)
+				recording->Add({ 0, InputEventType::BUTTON_PRESS, static_cast<int>(button) });
+	}
+
+	InputRecording InputManager::StopRecording()
+	{
+		if (recording == nullptr)
+			throw std::runtime_error("Input is not being recorded.");
+
+		recording->SetStepCount(step);
+
+		auto result = std::move(*recording);
+		recording = nullptr;
+
+		return result;
+	}
+
+	//-------------------------------------------------------------------
+
+	void InputManager::StartReplay(InputRecording value)
+	{
+		replay = std::make_unique<InputRecording>(std::move(value));
+		nextReplayEvent = 0;
+		step = 0;
+
+		keyMap.clear();
+		buttonMap.clear();
+		pressedKeys.clear();
+		cursorPosition = glm::vec2(0.0f, 0.0f);
+		scrollValue = 0.0f;
 	}
 
+	void InputManager::StopReplay()
+	{
+		replay = nullptr;
+	}
+
+	//-------------------------------------------------------------------
 
+	void InputManager::Submit(const InputEvent& event)
+	{
+		// Live input would make the replayed session diverge
+		if (replay != nullptr)
+			return;
+
+		if (recording != nullptr)
+		{
+			auto stamped = event;
+			stamped.step = step;
+			recording->Add(stamped);
+		}
+
+		Apply(event);
+	}
+
+	void InputManager::Apply(const InputEvent& event)
+	{
+		switch (event.type)
+		{
+		case InputEventType::KEY_PRESS:
+		{
+			const auto key = static_cast<Keys>(event.code);
+			auto& isDown = keyMap[key];
+
+			// Key repeat sends more presses while held, only the first one counts
+			if (!isDown)
+				pressedKeys.insert(key);
+
+			isDown = true;
+			break;
+		}
+
+		case InputEventType::KEY_RELEASE:
+			keyMap[static_cast<Keys>(event.code)] = false;
+			break;
+
+		case InputEventType::BUTTON_PRESS:
+			buttonMap[static_cast<MouseButtons>(event.code)] = true;
+			break;
+
+		case InputEventType::BUTTON_RELEASE:
+			buttonMap[static_cast<MouseButtons>(event.code)] = false;
+			break;
+
+		case InputEventType::CURSOR_POSITION:
+			cursorPosition = event.value;
+			break;
+
+		case InputEventType::SCROLL:
+			scrollValue = event.value.x;
+			break;
+		}
+	}
 }
@@ -2,11 +2,15 @@
 
 //-------------------------------------------------------------------
 
+#include <cstdint>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <glm/glm.hpp>
 
 //-------------------------------------------------------------------
 
+#include "InputRecording.hpp"
 #include "Keys.hpp"
 #include "MouseButtons.hpp"
 
@@ -19,9 +23,22 @@ namespace Input
 		std::unordered_map<Keys, bool> keyMap;
 		std::unordered_map<MouseButtons, bool> buttonMap;
 
+		// Keys that went down since the last ResetState
+		std::unordered_set<Keys> pressedKeys;
+
 		glm::vec2 cursorPosition = glm::vec2(0.0f, 0.0f);
 		float scrollValue = 0;
 
+		// Fixed simulation steps begun since recording or replay started
+		uint32_t step = 0;
+
+		std::unique_ptr<InputRecording> recording;
+		std::unique_ptr<InputRecording> replay;
+		size_t nextReplayEvent = 0;
+
+		void Submit(const InputEvent& event);
+		void Apply(const InputEvent& event);
+
 	public:
 		void PressKey(Keys key);
 		void ReleaseKey(Keys key);
@@ -30,16 +47,33 @@ namespace Input
 		void Scroll(float value);
 
 		bool IsKeyDown(Keys key);
+		bool IsKeyPressed(Keys key) const;
+
+		// Like IsKeyPressed, but the press is only reported once.
+		bool ConsumeKeyPress(Keys key);
 		bool IsButtonDown(MouseButtons button);
-		// Possible optims : IsKeyPressed, IsButtonPressed
+		// Possible optims : IsButtonPressed
 
 		void ResetState();
+		void SetCursorPosition(float x, float y);
 
-		void SetCursorPosition(const float x, const float y)
-		{
-			cursorPosition.x = x;
-			cursorPosition.y = y;
-		}
+		// Must be called before every fixed simulation step, stamps recorded events and feeds replayed ones.
+		void BeginStep();
+
+		// Records every event from here on, starting with the keys, buttons and cursor position held now.
+		void StartRecording(double fixedTimeStep);
+		InputRecording StopRecording();
+
+		// Clears the current state and ignores live events until StopReplay, the recorded ones are
+		// applied at the start of the same steps they were first seen in.
+		void StartReplay(InputRecording value);
+		void StopReplay();
+
+		[[nodiscard]] bool GetIsRecording() const { return recording != nullptr; }
+		[[nodiscard]] bool GetIsReplaying() const { return replay != nullptr; }
+
+		// True once every step of the recording has begun
+		[[nodiscard]] bool GetIsReplayFinished() const { return replay != nullptr && step >= replay->GetStepCount(); }
 
 		[[nodiscard]] glm::vec2 GetCursorPosition() const
 		{
@@ -0,0 +1,179 @@
+#include "InputRecording.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+//-------------------------------------------------------------------
+
+namespace Input
+{
+	namespace
+	{
+		constexpr char MAGIC[4] = { 'I', 'N', 'P', 'T' };
+
+		template <typename T>
+		void Write(std::ostream& stream, const T& value)
+		{
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template <typename T>
+		T Read(std::istream& stream)
+		{
+			T value{};
+			stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+			return value;
+		}
+
+		// Most events land a few steps after the previous one, so deltas usually fit in one byte
+		void WriteVarint(std::ostream& stream, uint32_t value)
+		{
+			while (value >= 0x80)
+			{
+				stream.put(static_cast<char>((value & 0x7F) | 0x80));
+				value >>= 7;
+			}
+
+			stream.put(static_cast<char>(value));
+		}
+
+		uint32_t ReadVarint(std::istream& stream)
+		{
+			uint32_t value = 0;
+
+			for (auto shift = 0; shift < 35; shift += 7)
+			{
+				const auto byte = stream.get();
+
+				if (byte == std::char_traits<char>::eof())
+					break;
+
+				value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+
+				if ((byte & 0x80) == 0)
+					break;
+			}
+
+			return value;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	InputRecording::InputRecording(const double fixedTimeStep)
+		: fixedTimeStep(fixedTimeStep)
+	{
+	}
+
+	//-------------------------------------------------------------------
+
+	InputRecording InputRecording::Load(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+
+		if (!file)
+			throw std::runtime_error(("Could not open input recording " + path).c_str());
+
+		char magic[4] = {};
+		file.read(magic, sizeof(magic));
+
+		if (!std::equal(std::begin(magic), std::end(magic), std::begin(MAGIC)) || Read<uint32_t>(file) != VERSION)
+			throw std::runtime_error(("Unsupported input recording " + path).c_str());
+
+		InputRecording recording(Read<double>(file));
+		recording.stepCount = Read<uint32_t>(file);
+
+		const auto eventCount = Read<uint32_t>(file);
+
+		if (!file)
+			throw std::runtime_error(("Truncated input recording " + path).c_str());
+
+		recording.events.reserve(eventCount);
+
+		uint32_t step = 0;
+
+		for (uint32_t i = 0; i < eventCount; i++)
+		{
+			InputEvent event;
+			step += ReadVarint(file);
+			event.step = step;
+			event.type = static_cast<InputEventType>(Read<uint8_t>(file));
+
+			switch (event.type)
+			{
+			case InputEventType::CURSOR_POSITION:
+				event.value.x = Read<float>(file);
+				event.value.y = Read<float>(file);
+				break;
+
+			case InputEventType::SCROLL:
+				event.value.x = Read<float>(file);
+				break;
+
+			default:
+				event.code = Read<int16_t>(file);
+				break;
+			}
+
+			if (!file)
+				throw std::runtime_error(("Truncated input recording " + path).c_str());
+
+			recording.events.push_back(event);
+		}
+
+		return recording;
+	}
+
+	//-------------------------------------------------------------------
+
+	void InputRecording::Save(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::binary);
+
+		if (!file)
+			throw std::runtime_error(("Could not open " + path).c_str());
+
+		file.write(MAGIC, sizeof(MAGIC));
+		Write(file, VERSION);
+		Write(file, fixedTimeStep);
+		Write(file, stepCount);
+		Write(file, static_cast<uint32_t>(events.size()));
+
+		uint32_t step = 0;
+
+		for (const auto& event : events)
+		{
+			WriteVarint(file, event.step - step);
+			step = event.step;
+
+			Write(file, static_cast<uint8_t>(event.type));
+
+			switch (event.type)
+			{
+			case InputEventType::CURSOR_POSITION:
+				Write(file, event.value.x);
+				Write(file, event.value.y);
+				break;
+
+			case InputEventType::SCROLL:
+				Write(file, event.value.x);
+				break;
+
+			default:
+				Write(file, static_cast<int16_t>(event.code));
+				break;
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void InputRecording::Add(const InputEvent& event)
+	{
+		events.push_back(event);
+	}
+}
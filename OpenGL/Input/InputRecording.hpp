@@ -0,0 +1,65 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+//-------------------------------------------------------------------
+
+namespace Input
+{
+	enum class InputEventType : uint8_t
+	{
+		KEY_PRESS,
+		KEY_RELEASE,
+		BUTTON_PRESS,
+		BUTTON_RELEASE,
+		CURSOR_POSITION,
+		SCROLL
+	};
+
+	struct InputEvent
+	{
+		// Index of the fixed simulation step that first sees the event
+		uint32_t step = 0;
+		InputEventType type = InputEventType::KEY_PRESS;
+
+		// Key or mouse button, unused by cursor and scroll events
+		int code = 0;
+
+		// Cursor position, or the scroll offset in x
+		glm::vec2 value = glm::vec2(0.0f, 0.0f);
+	};
+
+	// Input events of a session in the order they arrived, stamped with simulation steps instead of
+	// wall clock time, so replaying them at the same fixed timestep reproduces the session exactly.
+	//
+	// File layout, little endian: "INPT", version, fixed timestep as a double, step count and event
+	// count, then per event the step delta from the previous event as a varint, the type, and a
+	// 16 bit code or one or two floats depending on the type.
+	class InputRecording
+	{
+		double fixedTimeStep = 0.0;
+		uint32_t stepCount = 0;
+		std::vector<InputEvent> events;
+
+	public:
+		static constexpr uint32_t VERSION = 1;
+
+		InputRecording() = default;
+		explicit InputRecording(double fixedTimeStep);
+
+		static InputRecording Load(const std::string& path);
+		void Save(const std::string& path) const;
+
+		void Add(const InputEvent& event);
+		void SetStepCount(const uint32_t value) { stepCount = value; }
+
+		[[nodiscard]] double GetFixedTimeStep() const { return fixedTimeStep; }
+		[[nodiscard]] uint32_t GetStepCount() const { return stepCount; }
+		[[nodiscard]] const std::vector<InputEvent>& GetEvents() const { return events; }
+	};
+}
@@ -1,12 +1,111 @@
 #include <iostream>
+#include <stdexcept>
+#include <string>
 
 #include "Applications/Application_Lighting.hpp"
+#include "Tools/AssetPacker.hpp"
+#include "Tools/BenchmarkRunner.hpp"
+#include "Tools/MicroBenchmarks.hpp"
+#include "Tools/RegressionSuite.hpp"
+#include "Tools/TextureCompressor.hpp"
+#include "Tools/TexturePacker.hpp"
+#include "Utils/AssetPack.hpp"
+#include "Utils/CpuProfiler.hpp"
+#include "Utils/StartupTimer.hpp"
 
-int main()
+int main(int argc, char** argv)
 {
+    Utils::StartupTimer::Start();
+
     try
     {
+        if (argc > 1 && std::string(argv[1]) == "bench")
+        {
+            const Tools::BenchmarkRunner runner(Tools::BenchmarkRunner::ParseArguments(argc - 2, argv + 2));
+
+            runner.Run();
+
+            return 0;
+        }
+
+        if (argc > 1 && std::string(argv[1]) == "microbench")
+        {
+            const Tools::MicroBenchmarks benchmarks(Tools::MicroBenchmarks::ParseArguments(argc - 2, argv + 2));
+
+            benchmarks.Run();
+
+            return 0;
+        }
+
+        if (argc > 1 && std::string(argv[1]) == "regress")
+        {
+            const Tools::RegressionSuite suite(Tools::RegressionSuite::ParseArguments(argc - 2, argv + 2));
+
+            return suite.Run() ? 0 : 1;
+        }
+
+        if (argc > 1 && std::string(argv[1]) == "compress")
+        {
+            const Tools::TextureCompressor compressor(Tools::TextureCompressor::ParseArguments(argc - 2, argv + 2));
+
+            compressor.Run();
+
+            return 0;
+        }
+
+        if (argc > 1 && std::string(argv[1]) == "pack")
+        {
+            const Tools::TexturePacker packer(Tools::TexturePacker::ParseArguments(argc - 2, argv + 2));
+
+            packer.Run();
+
+            return 0;
+        }
+
+        if (argc > 1 && std::string(argv[1]) == "pack-assets")
+        {
+            const Tools::AssetPacker packer(Tools::AssetPacker::ParseArguments(argc - 2, argv + 2));
+
+            packer.Run();
+
+            return 0;
+        }
+
+        Applications::RunSettings settings;
+
+        for (auto i = 1; i < argc; i++)
+        {
+            const std::string option = argv[i];
+
+            if (option == "--gl-debug")
+            {
+                Utils::Window::SetIsDebugContextEnabled(true);
+                continue;
+            }
+
+            if (i + 1 >= argc)
+                throw std::runtime_error(("Missing value for " + option).c_str());
+
+            if (option == "--trace")
+            {
+                if (!Utils::CpuProfiler::GetIsCompiledIn())
+                    throw std::runtime_error("--trace needs a build defining ENABLE_CPU_PROFILER, this one records no CPU zones.");
+
+                settings.cpuTracePath = argv[++i];
+            }
+            else if (option == "--record-input")
+                settings.inputRecordPath = argv[++i];
+            else if (option == "--replay-input")
+                settings.inputReplayPath = argv[++i];
+            else if (option == "--asset-pack")
+                Utils::AssetPack::Mount(Utils::AssetPack::Open(argv[++i]));
+            else
+                throw std::runtime_error(("Unknown option " + option).c_str());
+        }
+
+        // The window, and with it the context, is created by the constructor
         Applications::Application_Lighting app;
+        app.SetRunSettings(settings);
 
         app.Run();
 
@@ -17,4 +116,4 @@ int main()
         std::cout << ex.what() << std::endl;
         return -1;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,112 @@
+#include "AssetPacker.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+//-------------------------------------------------------------------
+
+#include "../Utils/AssetPack.hpp"
+#include "../Utils/Clock.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	AssetPacker::AssetPacker(AssetPackerSettings settings)
+		: settings(std::move(settings))
+	{
+	}
+
+	//-------------------------------------------------------------------
+
+	AssetPackerSettings AssetPacker::ParseArguments(const int argc, char** argv)
+	{
+		AssetPackerSettings settings;
+		auto hasInputs = false;
+
+		for (auto i = 0; i < argc; i++)
+		{
+			const std::string option = argv[i];
+
+			if (i + 1 >= argc)
+				throw std::runtime_error(("Missing value for " + option).c_str());
+
+			const std::string value = argv[++i];
+
+			if (option == "--output")
+				settings.outputPath = value;
+			else if (option == "--input")
+			{
+				// The first input replaces the default
+				if (!hasInputs)
+					settings.inputs.clear();
+
+				settings.inputs.push_back(value);
+				hasInputs = true;
+			}
+			else
+				throw std::runtime_error(("Unknown pack-assets option " + option).c_str());
+		}
+
+		return settings;
+	}
+
+	//-------------------------------------------------------------------
+
+	void AssetPacker::Run() const
+	{
+		const Utils::Clock clock;
+
+		std::vector<std::pair<std::string, std::string>> files;
+		uint64_t size = 0;
+
+		for (const auto& file : GetInputFiles())
+		{
+			files.emplace_back(file, file);
+			size += std::filesystem::file_size(file);
+		}
+
+		// Written next to the final pack and swapped in, so a mounted pack is never overwritten in place
+		const auto temporaryPath = settings.outputPath + ".tmp";
+		Utils::AssetPack::Write(temporaryPath, files);
+		std::filesystem::rename(temporaryPath, settings.outputPath);
+
+		const auto pack = Utils::AssetPack::Open(settings.outputPath);
+
+		std::cout << std::fixed << std::setprecision(1) << "Packed " << pack->GetFileCount() << " files, " << size / 1024 << " KB, into "
+			<< settings.outputPath << ", " << pack->GetSize() / 1024 << " KB, in " << clock.GetElapsedSeconds() * 1000.0 << " ms"
+			<< std::endl;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<std::string> AssetPacker::GetInputFiles() const
+	{
+		std::vector<std::string> files;
+
+		for (const auto& input : settings.inputs)
+		{
+			if (!std::filesystem::is_directory(input))
+			{
+				files.push_back(std::filesystem::path(input).generic_string());
+				continue;
+			}
+
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(input))
+			{
+				// Left behind by interrupted writes
+				if (entry.is_regular_file() && entry.path().extension() != ".tmp")
+					files.push_back(entry.path().generic_string());
+			}
+		}
+
+		std::sort(files.begin(), files.end());
+
+		return files;
+	}
+}
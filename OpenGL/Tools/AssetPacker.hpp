@@ -0,0 +1,36 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	struct AssetPackerSettings
+	{
+		// Files, or directories whose files are all packed, subdirectories included
+		std::vector<std::string> inputs = { "Content" };
+
+		std::string outputPath = "Content.pack";
+	};
+
+	// Builds a Utils::AssetPack from the content the applications load, so they open one mapped
+	// file at startup instead of every shader and texture on its own. Files keep the path they
+	// were found under, which is the one the applications load them by.
+	class AssetPacker
+	{
+		AssetPackerSettings settings;
+
+		[[nodiscard]] std::vector<std::string> GetInputFiles() const;
+
+	public:
+		explicit AssetPacker(AssetPackerSettings settings);
+
+		static AssetPackerSettings ParseArguments(int argc, char** argv);
+
+		void Run() const;
+	};
+}
@@ -0,0 +1,502 @@
+#include "BenchmarkRunner.hpp"
+
+//-------------------------------------------------------------------
+
+#include <stdexcept>
+#include <glad/glad.h>
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+//-------------------------------------------------------------------
+
+#include "../Applications/Application_GettingStarted.hpp"
+#include "../Applications/Application_Lighting.hpp"
+#include "../Graphics/GLDebug.hpp"
+#include "../Graphics/GLStats.hpp"
+#include "../Graphics/GpuMemoryTracker.hpp"
+#include "../Graphics/GpuProfiler.hpp"
+#include "../Utils/AssetPack.hpp"
+#include "../Utils/CpuProfiler.hpp"
+#include "../Utils/StartupTimer.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	namespace
+	{
+		constexpr size_t MAX_REPORTED_CALL_SITES = 16;
+
+		void WriteDistribution(std::ostream& stream, const char* name, const BenchmarkDistribution& distribution)
+		{
+			stream << "  \"" << name << "\": { "
+				<< "\"mean\": " << distribution.mean << ", "
+				<< "\"min\": " << distribution.min << ", "
+				<< "\"p50\": " << distribution.p50 << ", "
+				<< "\"p95\": " << distribution.p95 << ", "
+				<< "\"p99\": " << distribution.p99 << ", "
+				<< "\"max\": " << distribution.max << " }";
+		}
+
+		std::string EscapeJson(const std::string& text)
+		{
+			std::string escaped;
+
+			for (const auto character : text)
+			{
+				// Driver messages may span several lines
+				if (static_cast<unsigned char>(character) < 0x20)
+				{
+					constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+					escaped += "\\u00";
+					escaped.push_back(HEX_DIGITS[character >> 4]);
+					escaped.push_back(HEX_DIGITS[character & 0xF]);
+					continue;
+				}
+
+				if (character == '"' || character == '\\')
+					escaped.push_back('\\');
+
+				escaped.push_back(character);
+			}
+
+			return escaped;
+		}
+
+		int ParsePositiveInt(const std::string& option, const std::string& value)
+		{
+			const auto number = std::stoi(value);
+
+			if (number < 0)
+				throw std::runtime_error((option + " must not be negative.").c_str());
+
+			return number;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	BenchmarkRunner::BenchmarkRunner(BenchmarkSettings settings)
+		: settings(std::move(settings))
+	{
+	}
+
+	//-------------------------------------------------------------------
+
+	BenchmarkSettings BenchmarkRunner::ParseArguments(const int argc, char** argv)
+	{
+		BenchmarkSettings settings;
+
+		for (auto i = 0; i < argc; i++)
+		{
+			const std::string option = argv[i];
+
+			if (i + 1 >= argc)
+				throw std::runtime_error(("Missing value for " + option).c_str());
+
+			const std::string value = argv[++i];
+
+			if (option == "--app")
+				settings.application = value;
+			else if (option == "--warmup")
+				settings.warmupFrames = ParsePositiveInt(option, value);
+			else if (option == "--frames")
+				settings.measuredFrames = ParsePositiveInt(option, value);
+			else if (option == "--output")
+				settings.outputPath = value;
+			else if (option == "--call-sites")
+				settings.isCallSiteTrackingEnabled = value == "on";
+			else if (option == "--trace")
+			{
+				if (!Utils::CpuProfiler::GetIsCompiledIn())
+					throw std::runtime_error("--trace needs a build defining ENABLE_CPU_PROFILER, this one records no CPU zones.");
+
+				settings.cpuTracePath = value;
+			}
+			else if (option == "--input")
+				settings.inputReplayPath = value;
+			else if (option == "--gl-debug")
+				settings.isGLDebugEnabled = value == "on";
+			else if (option == "--asset-pack")
+				settings.assetPackPath = value;
+			else
+				throw std::runtime_error(("Unknown benchmark option " + option).c_str());
+		}
+
+		return settings;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::unique_ptr<Applications::IApplication> BenchmarkRunner::CreateApplication(const std::string& name, const Utils::WindowBackend backend)
+	{
+		if (name == "lighting")
+			return std::make_unique<Applications::Application_Lighting>(backend);
+
+		if (name == "getting-started")
+			return std::make_unique<Applications::Application_GettingStarted>(backend);
+
+		throw std::runtime_error(("Unknown application " + name).c_str());
+	}
+
+	//-------------------------------------------------------------------
+
+	void BenchmarkRunner::Run() const
+	{
+		CPU_THREAD_NAME("Benchmark");
+
+		Utils::Window::SetIsDebugContextEnabled(settings.isGLDebugEnabled);
+
+		if (!settings.assetPackPath.empty())
+			Utils::AssetPack::Mount(Utils::AssetPack::Open(settings.assetPackPath));
+
+		const auto app = CreateApplication(settings.application, Utils::WindowBackend::HEADLESS);
+
+		auto runSettings = app->GetRunSettings();
+		runSettings.isGLStatsEnabled = true;
+		runSettings.inputReplayPath = settings.inputReplayPath;
+		app->SetRunSettings(runSettings);
+
+		Graphics::GLStats::SetIsCallSiteTrackingEnabled(settings.isCallSiteTrackingEnabled);
+
+		app->BeginSession();
+
+		const auto frames = Measure(*app);
+		const auto framebufferSize = app->GetWindow().GetFramebufferSize();
+
+		if (!settings.cpuTracePath.empty())
+		{
+			std::ofstream trace(settings.cpuTracePath);
+
+			if (!trace)
+				throw std::runtime_error(("Could not open " + settings.cpuTracePath).c_str());
+
+			Utils::CpuProfiler::WriteChromeTrace(trace);
+		}
+
+		if (settings.outputPath.empty())
+		{
+			WriteReport(std::cout, framebufferSize, frames);
+		}
+		else
+		{
+			std::ofstream file(settings.outputPath);
+
+			if (!file)
+				throw std::runtime_error(("Could not open " + settings.outputPath).c_str());
+
+			WriteReport(file, framebufferSize, frames);
+		}
+
+		app->EndSession();
+
+		Graphics::GLStats::SetIsCallSiteTrackingEnabled(false);
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<BenchmarkFrame> BenchmarkRunner::Measure(Applications::IApplication& app) const
+	{
+		auto& camera = app.GetCamera();
+		const auto isReplayingInput = app.GetInputManager().GetIsReplaying();
+
+		camera.SetIsUserControlEnabled(isReplayingInput);
+
+		Graphics::GpuProfiler::SetIsEnabled(true);
+
+		std::vector<BenchmarkFrame> frames;
+		frames.reserve(settings.measuredFrames);
+
+		const auto fixedTimeStep = isReplayingInput ? app.GetRunSettings().fixedTimeStep : settings.fixedTimeStep;
+		const auto deltaTime = static_cast<float>(fixedTimeStep);
+		const auto totalFrames = settings.warmupFrames + settings.measuredFrames;
+
+		// Content uploads are not part of any frame
+		Graphics::GLStats::EndFrame();
+
+		const auto firstMeasuredFrame = Graphics::GpuProfiler::GetFrameIndex() + settings.warmupFrames;
+
+		// GPU results arrive a few frames late, extra frames at the end let the last measured ones resolve
+		const auto drainFrames = Graphics::GpuProfiler::FRAME_LATENCY + 1;
+
+		Graphics::GpuFrameTimings gpuTimings;
+
+		for (auto frame = 0; frame < totalFrames + drainFrames; frame++)
+		{
+			if (!settings.cpuTracePath.empty())
+			{
+				if (frame == settings.warmupFrames)
+					Utils::CpuProfiler::BeginCapture();
+
+				if (frame == totalFrames)
+					Utils::CpuProfiler::EndCapture();
+			}
+
+			if (!isReplayingInput)
+				MoveCameraAlongPath(camera, frame * fixedTimeStep);
+
+			const auto cpuStart = std::chrono::steady_clock::now();
+
+			app.StepFrame(deltaTime);
+
+			const auto cpuEnd = std::chrono::steady_clock::now();
+
+			if (Graphics::GpuProfiler::GetLastResolvedFrame(gpuTimings) && gpuTimings.frameIndex >= firstMeasuredFrame)
+			{
+				const auto measured = static_cast<size_t>(gpuTimings.frameIndex - firstMeasuredFrame);
+
+				if (measured < frames.size())
+				{
+					frames[measured].gpuZoneMs = gpuTimings.zoneMs;
+					frames[measured].gpuZoneRan = gpuTimings.zoneRan;
+				}
+			}
+
+			if (frame < settings.warmupFrames || frame >= totalFrames)
+				continue;
+
+			const auto glStats = Graphics::GLStats::GetLastFrame();
+
+			frames.push_back({
+				std::chrono::duration<double, std::milli>(cpuEnd - cpuStart).count(),
+				{},
+				{},
+				glStats.drawCalls,
+				glStats.stateChanges,
+				glStats.uniformUploads,
+				glStats.GetBytesUploaded()
+			});
+		}
+
+		Graphics::GpuProfiler::Release();
+		Graphics::GpuProfiler::SetIsEnabled(false);
+
+		return frames;
+	}
+
+	//-------------------------------------------------------------------
+
+	BenchmarkDistribution BenchmarkRunner::GetDistribution(std::vector<double> values)
+	{
+		BenchmarkDistribution distribution;
+
+		if (values.empty())
+			return distribution;
+
+		std::sort(values.begin(), values.end());
+
+		// Nearest-rank percentile
+		const auto percentile = [&values](const double p)
+		{
+			const auto rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(values.size())));
+			return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+		};
+
+		auto sum = 0.0;
+
+		for (const auto value : values)
+			sum += value;
+
+		distribution.mean = sum / static_cast<double>(values.size());
+		distribution.min = values.front();
+		distribution.p50 = percentile(50.0);
+		distribution.p95 = percentile(95.0);
+		distribution.p99 = percentile(99.0);
+		distribution.max = values.back();
+
+		return distribution;
+	}
+
+	//-------------------------------------------------------------------
+
+	double BenchmarkRunner::GetGpuFrameMs(const BenchmarkFrame& frame)
+	{
+		const auto zones = Graphics::GpuProfiler::GetZoneStats();
+
+		for (size_t zone = 0; zone < zones.size() && zone < frame.gpuZoneMs.size(); zone++)
+			if (zones[zone].name == Applications::IApplication::FRAME_GPU_ZONE)
+				return frame.gpuZoneMs[zone];
+
+		return -1.0;
+	}
+
+	//-------------------------------------------------------------------
+
+	void BenchmarkRunner::MoveCameraAlongPath(Utils::Camera3D& camera, const double time)
+	{
+		// Slow orbit around the origin with a gentle vertical bob, one lap every 16 seconds
+		const auto angle = time * glm::two_pi<double>() / 16.0;
+
+		const auto position = glm::vec3(
+			static_cast<float>(4.0 * std::cos(angle)),
+			static_cast<float>(1.5 * std::sin(angle * 2.0)),
+			static_cast<float>(4.0 * std::sin(angle)));
+
+		const auto front = glm::normalize(-position);
+		const auto right = glm::normalize(glm::cross(front, camera.GetWorldUp()));
+
+		camera.SetPosition(position);
+		camera.SetFront(front);
+		camera.SetRight(right);
+		camera.SetUp(glm::normalize(glm::cross(right, front)));
+	}
+
+	//-------------------------------------------------------------------
+
+	void BenchmarkRunner::WriteReport(std::ostream& stream, const glm::ivec2& framebufferSize, const std::vector<BenchmarkFrame>& frames) const
+	{
+		const auto zoneStats = Graphics::GpuProfiler::GetZoneStats();
+
+		std::vector<double> cpuTimes;
+		std::vector<std::vector<double>> zoneTimes(zoneStats.size());
+		std::vector<double> drawCalls;
+		std::vector<double> stateChanges;
+		std::vector<double> uniformUploads;
+		std::vector<double> bytesUploaded;
+		size_t gpuResolvedFrames = 0;
+
+		for (const auto& frame : frames)
+		{
+			cpuTimes.push_back(frame.cpuMs);
+
+			// Frames whose GPU results were dropped only contribute CPU timings
+			if (!frame.gpuZoneMs.empty())
+			{
+				// Zones that only run in some frames are measured over those, like the rolling average
+				for (size_t zone = 0; zone < frame.gpuZoneMs.size(); zone++)
+					if (frame.gpuZoneRan[zone])
+						zoneTimes[zone].push_back(frame.gpuZoneMs[zone]);
+
+				gpuResolvedFrames++;
+			}
+
+			drawCalls.push_back(static_cast<double>(frame.drawCalls));
+			stateChanges.push_back(static_cast<double>(frame.stateChanges));
+			uniformUploads.push_back(static_cast<double>(frame.uniformUploads));
+			bytesUploaded.push_back(static_cast<double>(frame.bytesUploaded));
+		}
+
+		const auto renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+		const auto version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+
+		stream << "{\n"
+			<< "  \"application\": \"" << EscapeJson(settings.application) << "\",\n"
+			<< "  \"renderer\": \"" << EscapeJson(renderer != nullptr ? renderer : "") << "\",\n"
+			<< "  \"version\": \"" << EscapeJson(version != nullptr ? version : "") << "\",\n"
+			<< "  \"width\": " << framebufferSize.x << ",\n"
+			<< "  \"height\": " << framebufferSize.y << ",\n"
+			<< "  \"warmupFrames\": " << settings.warmupFrames << ",\n"
+			<< "  \"measuredFrames\": " << frames.size() << ",\n"
+			<< "  \"fixedTimeStep\": " << settings.fixedTimeStep << ",\n"
+			<< "  \"gpuResolvedFrames\": " << gpuResolvedFrames << ",\n";
+
+		WriteDistribution(stream, "cpuFrameMs", GetDistribution(cpuTimes));
+		stream << ",\n";
+		for (size_t zone = 0; zone < zoneStats.size(); zone++)
+		{
+			if (zoneStats[zone].name == Applications::IApplication::FRAME_GPU_ZONE)
+			{
+				WriteDistribution(stream, "gpuFrameMs", GetDistribution(zoneTimes[zone]));
+				stream << ",\n";
+			}
+		}
+
+		stream << "  \"gpuZones\": [";
+
+		for (size_t zone = 0; zone < zoneStats.size(); zone++)
+		{
+			const auto distribution = GetDistribution(zoneTimes[zone]);
+
+			stream << (zone == 0 ? "\n" : ",\n")
+				<< "    { \"name\": \"" << EscapeJson(zoneStats[zone].name) << "\", "
+				<< "\"mean\": " << distribution.mean << ", "
+				<< "\"p50\": " << distribution.p50 << ", "
+				<< "\"p95\": " << distribution.p95 << ", "
+				<< "\"p99\": " << distribution.p99 << ", "
+				<< "\"rollingAverage\": " << zoneStats[zone].averageMs << " }";
+		}
+
+		stream << "\n  ],\n";
+		WriteDistribution(stream, "drawCalls", GetDistribution(drawCalls));
+		stream << ",\n";
+		WriteDistribution(stream, "stateChanges", GetDistribution(stateChanges));
+		stream << ",\n";
+		WriteDistribution(stream, "uniformUploads", GetDistribution(uniformUploads));
+		stream << ",\n";
+		WriteDistribution(stream, "bytesUploaded", GetDistribution(bytesUploaded));
+
+		const auto startupPhases = Utils::StartupTimer::GetPhases();
+
+		stream << ",\n  \"startup\": { \"timeToFirstFrameMs\": " << Utils::StartupTimer::GetTimeToFirstFrameMs() << ", \"phases\": [";
+
+		for (size_t i = 0; i < startupPhases.size(); i++)
+		{
+			stream << (i == 0 ? "\n" : ",\n")
+				<< "    { \"name\": \"" << EscapeJson(startupPhases[i].name) << "\", "
+				<< "\"depth\": " << startupPhases[i].depth << ", "
+				<< "\"startMs\": " << startupPhases[i].startMs << ", "
+				<< "\"wallMs\": " << startupPhases[i].wallMs << ", "
+				<< "\"cpuMs\": " << startupPhases[i].cpuMs << ", "
+				<< "\"isOnWorker\": " << (startupPhases[i].isOnWorker ? "true" : "false") << " }";
+		}
+
+		stream << "\n  ] }";
+
+		const auto gpuMemory = Graphics::GpuMemoryTracker::GetTotals();
+
+		stream << ",\n  \"gpuMemory\": { \"liveBytes\": " << gpuMemory.liveBytes
+			<< ", \"peakBytes\": " << gpuMemory.peakBytes << ", \"allocations\": " << gpuMemory.liveCount << " }";
+
+		if (Graphics::GLStats::GetIsCallSiteTrackingEnabled())
+		{
+			const auto callSites = Graphics::GLStats::GetCallSites();
+
+			stream << ",\n  \"glCallSites\": [";
+
+			for (size_t i = 0; i < callSites.size() && i < MAX_REPORTED_CALL_SITES; i++)
+			{
+				stream << (i == 0 ? "\n" : ",\n")
+					<< "    { \"function\": \"" << callSites[i].function << "\", "
+					<< "\"location\": \"" << EscapeJson(callSites[i].location) << "\", "
+					<< "\"lastFrameCalls\": " << callSites[i].lastFrameCalls << ", "
+					<< "\"totalCalls\": " << callSites[i].totalCalls << " }";
+			}
+
+			stream << "\n  ]";
+		}
+
+		if (Graphics::GLDebug::GetIsInstalled())
+		{
+			const auto debugTotals = Graphics::GLDebug::GetTotals();
+			const auto messages = Graphics::GLDebug::GetMessages();
+
+			stream << ",\n  \"glDebugMessageCounts\": {";
+
+			for (size_t category = 0; category < static_cast<size_t>(Graphics::GLDebugCategory::COUNT); category++)
+				stream << (category == 0 ? " \"" : ", \"") << Graphics::GLDebug::GetCategoryName(static_cast<Graphics::GLDebugCategory>(category))
+					<< "\": " << debugTotals.messageCounts[category];
+
+			stream << " },\n  \"glDebugMessages\": [";
+
+			for (size_t i = 0; i < messages.size(); i++)
+			{
+				stream << (i == 0 ? "\n" : ",\n")
+					<< "    { \"category\": \"" << Graphics::GLDebug::GetCategoryName(messages[i].category) << "\", "
+					<< "\"severity\": \"" << Graphics::GLDebug::GetSeverityName(messages[i].severity) << "\", "
+					<< "\"id\": " << messages[i].id << ", "
+					<< "\"count\": " << messages[i].totalCount << ", "
+					<< "\"text\": \"" << EscapeJson(messages[i].text) << "\" }";
+			}
+
+			stream << "\n  ]";
+		}
+
+		stream << "\n}" << std::endl;
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "../Applications/IApplication.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	struct BenchmarkSettings
+	{
+		std::string application = "lighting";
+		int warmupFrames = 100;
+		int measuredFrames = 500;
+		double fixedTimeStep = 1.0 / 60.0;
+
+		// Empty writes the report to standard output
+		std::string outputPath;
+
+		// Chrome trace of the measured frames, needs a build with ENABLE_CPU_PROFILER
+		std::string cpuTracePath;
+
+		// Attributes GL calls to the code making them, slows down every GL call
+		bool isCallSiteTrackingEnabled = false;
+
+		// Drives the camera with recorded input at the recording's timestep instead of the scripted path
+		std::string inputReplayPath;
+
+		// Runs on a debug context and reports the driver's messages, which slows down the driver
+		bool isGLDebugEnabled = false;
+
+		// Loads content from the pack rather than from loose files, see Utils::AssetPack
+		std::string assetPackPath;
+	};
+
+	struct BenchmarkFrame
+	{
+		double cpuMs;
+
+		// Indexed like GpuProfiler::GetZoneStats, empty when the frame's GPU queries were dropped
+		std::vector<double> gpuZoneMs;
+		std::vector<bool> gpuZoneRan;
+
+		uint64_t drawCalls;
+		uint64_t stateChanges;
+		uint64_t uniformUploads;
+		uint64_t bytesUploaded;
+	};
+
+	struct BenchmarkDistribution
+	{
+		double mean = 0.0;
+		double min = 0.0;
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+	};
+
+	// Runs an application headlessly for a fixed number of frames along a scripted camera
+	// path and reports frame timings and GL statistics as JSON.
+	class BenchmarkRunner
+	{
+		BenchmarkSettings settings;
+
+		void WriteReport(std::ostream& stream, const glm::ivec2& framebufferSize, const std::vector<BenchmarkFrame>& frames) const;
+
+	public:
+		explicit BenchmarkRunner(BenchmarkSettings settings);
+
+		static BenchmarkSettings ParseArguments(int argc, char** argv);
+		static std::unique_ptr<Applications::IApplication> CreateApplication(const std::string& name, Utils::WindowBackend backend);
+
+		// Places the camera on the benchmark path, the same time always gives the same view.
+		static void MoveCameraAlongPath(Utils::Camera3D& camera, double time);
+
+		// Nearest-rank percentiles of the values.
+		static BenchmarkDistribution GetDistribution(std::vector<double> values);
+
+		// GPU time of the IApplication frame zone, negative when the frame's GPU queries were dropped.
+		static double GetGpuFrameMs(const BenchmarkFrame& frame);
+
+		// Steps the warmup and measured frames of an application whose session has begun.
+		[[nodiscard]] std::vector<BenchmarkFrame> Measure(Applications::IApplication& app) const;
+
+		void Run() const;
+	};
+}
@@ -0,0 +1,632 @@
+#include "BlockEncoder.hpp"
+
+//-------------------------------------------------------------------
+
+#include <stdexcept>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	namespace
+	{
+		constexpr int TEXEL_COUNT = 16;
+
+		// BC7 interpolation weights for 4 bit indices, out of 64
+		constexpr int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		// ETC intensity modifiers, indexed by table and by the two bits stored per texel
+		constexpr int ETC_MODIFIERS[8][4] =
+		{
+			{ 2, 8, -2, -8 },
+			{ 5, 17, -5, -17 },
+			{ 9, 29, -9, -29 },
+			{ 13, 42, -13, -42 },
+			{ 18, 60, -18, -60 },
+			{ 24, 80, -24, -80 },
+			{ 33, 106, -33, -106 },
+			{ 47, 183, -47, -183 }
+		};
+
+		class BitWriter
+		{
+			uint8_t* output;
+			int position = 0;
+
+		public:
+			explicit BitWriter(uint8_t* output) : output(output) {}
+
+			// Least significant bit first, as BC7 expects
+			void Write(const uint32_t value, const int count)
+			{
+				for (auto i = 0; i < count; i++, position++)
+					output[position / 8] |= static_cast<uint8_t>((value >> i & 1) << position % 8);
+			}
+		};
+
+		float GetDistance(const glm::vec4& a, const glm::vec4& b)
+		{
+			const auto difference = a - b;
+			return glm::dot(difference, difference);
+		}
+
+		// Direction of greatest variance of the points, by power iteration on their covariance
+		glm::vec4 GetPrincipalAxis(const glm::vec4* points, const glm::vec4& mean)
+		{
+			glm::mat4 covariance(0.0f);
+
+			for (auto i = 0; i < TEXEL_COUNT; i++)
+			{
+				const auto difference = points[i] - mean;
+				covariance += glm::outerProduct(difference, difference);
+			}
+
+			// Starting from the column of the largest variance converges in a few iterations
+			auto largest = 0;
+
+			for (auto i = 1; i < 4; i++)
+				if (covariance[i][i] > covariance[largest][largest])
+					largest = i;
+
+			auto axis = covariance[largest];
+
+			for (auto iteration = 0; iteration < 8; iteration++)
+			{
+				const auto length = glm::length(axis);
+
+				if (length < 1e-6f)
+					return glm::vec4(0.0f);
+
+				axis = covariance * (axis / length);
+			}
+
+			const auto length = glm::length(axis);
+			return length < 1e-6f ? glm::vec4(0.0f) : axis / length;
+		}
+
+		// Endpoints of the segment along the principal axis that spans the points
+		void FitEndpoints(const glm::vec4* points, glm::vec4& endpoint0, glm::vec4& endpoint1)
+		{
+			auto mean = glm::vec4(0.0f);
+
+			for (auto i = 0; i < TEXEL_COUNT; i++)
+				mean += points[i];
+
+			mean /= static_cast<float>(TEXEL_COUNT);
+
+			const auto axis = GetPrincipalAxis(points, mean);
+
+			auto minimum = 0.0f;
+			auto maximum = 0.0f;
+
+			for (auto i = 0; i < TEXEL_COUNT; i++)
+			{
+				const auto projection = glm::dot(points[i] - mean, axis);
+				minimum = std::min(minimum, projection);
+				maximum = std::max(maximum, projection);
+			}
+
+			// Pulled in slightly, the extreme texels rarely justify the full range
+			const auto inset = (maximum - minimum) / 16.0f;
+
+			endpoint0 = glm::clamp(mean + axis * (maximum - inset), 0.0f, 255.0f);
+			endpoint1 = glm::clamp(mean + axis * (minimum + inset), 0.0f, 255.0f);
+		}
+
+		// Least squares endpoints for fixed indices, where index i interpolates weights[i] of the way
+		// from endpoint 0 to endpoint 1. Fails when every texel uses the same weight.
+		bool SolveEndpoints(const glm::vec4* points, const int* indices, const float* weights,
+			glm::vec4& endpoint0, glm::vec4& endpoint1)
+		{
+			auto a = 0.0f, b = 0.0f, c = 0.0f;
+			auto x0 = glm::vec4(0.0f), x1 = glm::vec4(0.0f);
+
+			for (auto i = 0; i < TEXEL_COUNT; i++)
+			{
+				const auto weight1 = weights[indices[i]];
+				const auto weight0 = 1.0f - weight1;
+
+				a += weight0 * weight0;
+				b += weight0 * weight1;
+				c += weight1 * weight1;
+				x0 += points[i] * weight0;
+				x1 += points[i] * weight1;
+			}
+
+			const auto determinant = a * c - b * b;
+
+			if (std::abs(determinant) < 1e-6f)
+				return false;
+
+			endpoint0 = glm::clamp((x0 * c - x1 * b) / determinant, 0.0f, 255.0f);
+			endpoint1 = glm::clamp((x1 * a - x0 * b) / determinant, 0.0f, 255.0f);
+
+			return true;
+		}
+
+		float AssignIndices(const glm::vec4* points, const glm::vec4* palette, const int paletteSize, int* indices)
+		{
+			auto error = 0.0f;
+
+			for (auto i = 0; i < TEXEL_COUNT; i++)
+			{
+				auto best = std::numeric_limits<float>::max();
+
+				for (auto j = 0; j < paletteSize; j++)
+				{
+					const auto distance = GetDistance(points[i], palette[j]);
+
+					if (distance < best)
+					{
+						best = distance;
+						indices[i] = j;
+					}
+				}
+
+				error += best;
+			}
+
+			return error;
+		}
+
+		//-------------------------------------------------------------------
+
+		uint16_t To565(const glm::vec4& color)
+		{
+			const auto r = static_cast<uint16_t>(std::lround(color.r * 31.0f / 255.0f));
+			const auto g = static_cast<uint16_t>(std::lround(color.g * 63.0f / 255.0f));
+			const auto b = static_cast<uint16_t>(std::lround(color.b * 31.0f / 255.0f));
+
+			return static_cast<uint16_t>(r << 11 | g << 5 | b);
+		}
+
+		glm::vec4 From565(const uint16_t color)
+		{
+			const auto r = color >> 11 & 31;
+			const auto g = color >> 5 & 63;
+			const auto b = color & 31;
+
+			return glm::vec4(r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2, 0.0f);
+		}
+
+		void GetBC1Palette(const uint16_t color0, const uint16_t color1, glm::vec4* palette)
+		{
+			palette[0] = From565(color0);
+			palette[1] = From565(color1);
+			palette[2] = (palette[0] * 2.0f + palette[1]) / 3.0f;
+			palette[3] = (palette[0] + palette[1] * 2.0f) / 3.0f;
+		}
+
+		void EncodeBC1Color(const uint8_t* texels, uint8_t* output)
+		{
+			constexpr float weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+			glm::vec4 points[TEXEL_COUNT];
+
+			for (auto i = 0; i < TEXEL_COUNT; i++)
+				points[i] = glm::vec4(texels[i * 4], texels[i * 4 + 1], texels[i * 4 + 2], 0.0f);
+
+			glm::vec4 endpoint0, endpoint1;
+			FitEndpoints(points, endpoint0, endpoint1);
+
+			uint16_t bestColors[2] = {};
+			int bestIndices[TEXEL_COUNT] = {};
+			auto bestError = std::numeric_limits<float>::max();
+
+			for (auto iteration = 0; iteration < 2; iteration++)
+			{
+				const uint16_t colors[2] = { To565(endpoint0), To565(endpoint1) };
+
+				glm::vec4 palette[4];
+				GetBC1Palette(colors[0], colors[1], palette);
+
+				int indices[TEXEL_COUNT];
+				const auto error = AssignIndices(points, palette, 4, indices);
+
+				if (error < bestError)
+				{
+					bestError = error;
+					std::copy(std::begin(colors), std::end(colors), bestColors);
+					std::copy(std::begin(indices), std::end(indices), bestIndices);
+				}
+
+				if (!SolveEndpoints(points, indices, weights, endpoint0, endpoint1))
+					break;
+			}
+
+			// Four color mode needs the first color to be the larger one
+			if (bestColors[0] < bestColors[1])
+			{
+				std::swap(bestColors[0], bestColors[1]);
+
+				for (auto& index : bestIndices)
+					index ^= 1;
+			}
+			else if (bestColors[0] == bestColors[1])
+			{
+				std::fill(std::begin(bestIndices), std::end(bestIndices), 0);
+			}
+
+			uint32_t indexBits = 0;
+
+			for (auto i = 0; i < TEXEL_COUNT; i++)
+				indexBits |= static_cast<uint32_t>(bestIndices[i]) << i * 2;
+
+			std::memcpy(output, &bestColors[0], 2);
+			std::memcpy(output + 2, &bestColors[1], 2);
+			std::memcpy(output + 4, &indexBits, 4);
+		}
+
+		//-------------------------------------------------------------------
+
+		void EncodeBC4(const uint8_t* texels, const int channel, uint8_t* output)
+		{
+			uint8_t minimum = 255, maximum = 0;
+
+			for (auto i = 0; i < TEXEL_COUNT; i++)
+			{
+				minimum = std::min(minimum, texels[i * 4 + channel]);
+				maximum = std::max(maximum, texels[i * 4 + channel]);
+			}
+
+			// The first value larger than the second selects the eight value mode
+			output[0] = maximum;
+			output[1] = minimum;
+
+			uint64_t indexBits = 0;
+
+			if (maximum != minimum)
+			{
+				float palette[8] = { static_cast<float>(maximum), static_cast<float>(minimum) };
+
+				for (auto i = 2; i < 8; i++)
+					palette[i] = (static_cast<float>(8 - i) * maximum + static_cast<float>(i - 1) * minimum) / 7.0f;
+
+				for (auto i = 0; i < TEXEL_COUNT; i++)
+				{
+					const auto value = static_cast<float>(texels[i * 4 + channel]);
+					auto best = 0;
+
+					for (auto j = 1; j < 8; j++)
+						if (std::abs(palette[j] - value) < std::abs(palette[best] - value))
+							best = j;
+
+					indexBits |= static_cast<uint64_t>(best) << i * 3;
+				}
+			}
+
+			for (auto i = 0; i < 6; i++)
+				output[2 + i] = static_cast<uint8_t>(indexBits >> i * 8);
+		}
+
+		//-------------------------------------------------------------------
+
+		// Splits an endpoint into 7 bit components and the shared lowest bit that best rebuilds it
+		void QuantizeBC7Endpoint(const glm::vec4& endpoint, glm::ivec4& components, int& parity)
+		{
+			auto bestError = std::numeric_limits<float>::max();
+
+			for (auto candidate = 0; candidate < 2; candidate++)
+			{
+				glm::ivec4 quantized;
+				auto error = 0.0f;
+
+				for (auto i = 0; i < 4; i++)
+				{
+					quantized[i] = std::clamp(static_cast<int>(std::lround((endpoint[i] - candidate) / 2.0f)), 0, 127);
+
+					const auto difference = static_cast<float>(quantized[i] << 1 | candidate) - endpoint[i];
+					error += difference * difference;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					components = quantized;
+					parity = candidate;
+				}
+			}
+		}
+
+		void EncodeBC7(const uint8_t* texels, uint8_t* output)
+		{
+			float weights[16];
+
+			for (auto i = 0; i < 16; i++)
+				weights[i] = static_cast<float>(BC7_WEIGHTS[i]) / 64.0f;
+
+			glm::vec4 points[TEXEL_COUNT];
+
+			for (auto i = 0; i < TEXEL_COUNT; i++)
+				points[i] = glm::vec4(texels[i * 4], texels[i * 4 + 1], texels[i * 4 + 2], texels[i * 4 + 3]);
+
+			glm::vec4 endpoint0, endpoint1;
+			FitEndpoints(points, endpoint0, endpoint1);
+
+			glm::ivec4 bestComponents[2] = { glm::ivec4(0), glm::ivec4(0) };
+			int bestParities[2] = {};
+			int bestIndices[TEXEL_COUNT] = {};
+			auto bestError = std::numeric_limits<float>::max();
+
+			for (auto iteration = 0; iteration < 2; iteration++)
+			{
+				glm::ivec4 components[2];
+				int parities[2];
+				QuantizeBC7Endpoint(endpoint0, components[0], parities[0]);
+				QuantizeBC7Endpoint(endpoint1, components[1], parities[1]);
+
+				const auto unquantized0 = components[0] << 1 | parities[0];
+				const auto unquantized1 = components[1] << 1 | parities[1];
+
+				glm::vec4 palette[16];
+
+				for (auto i = 0; i < 16; i++)
+					palette[i] = glm::vec4(((64 - BC7_WEIGHTS[i]) * unquantized0 + BC7_WEIGHTS[i] * unquantized1 + 32) >> 6);
+
+				int indices[TEXEL_COUNT];
+				const auto error = AssignIndices(points, palette, 16, indices);
+
+				if (error < bestError)
+				{
+					bestError = error;
+					std::copy(std::begin(components), std::end(components), bestComponents);
+					std::copy(std::begin(parities), std::end(parities), bestParities);
+					std::copy(std::begin(indices), std::end(indices), bestIndices);
+				}
+
+				if (!SolveEndpoints(points, indices, weights, endpoint0, endpoint1))
+					break;
+			}
+
+			// The first texel's index is stored without its top bit, which must therefore be 0
+			if (bestIndices[0] >= 8)
+			{
+				std::swap(bestComponents[0], bestComponents[1]);
+				std::swap(bestParities[0], bestParities[1]);
+
+				for (auto& index : bestIndices)
+					index = 15 - index;
+			}
+
+			std::memset(output, 0, 16);
+			BitWriter writer(output);
+
+			// Mode 6 is a 1 in bit 6
+			writer.Write(1 << 6, 7);
+
+			for (auto channel = 0; channel < 4; channel++)
+			{
+				writer.Write(static_cast<uint32_t>(bestComponents[0][channel]), 7);
+				writer.Write(static_cast<uint32_t>(bestComponents[1][channel]), 7);
+			}
+
+			writer.Write(static_cast<uint32_t>(bestParities[0]), 1);
+			writer.Write(static_cast<uint32_t>(bestParities[1]), 1);
+
+			for (auto i = 0; i < TEXEL_COUNT; i++)
+				writer.Write(static_cast<uint32_t>(bestIndices[i]), i == 0 ? 3 : 4);
+		}
+
+		//-------------------------------------------------------------------
+
+		// Best modifier table for a half block around a base color, returns the squared error
+		int FitEtcSubBlock(const glm::ivec3* texels, const glm::ivec3& base, int& table, int* indices)
+		{
+			auto bestError = std::numeric_limits<int>::max();
+
+			for (auto candidate = 0; candidate < 8; candidate++)
+			{
+				auto error = 0;
+				int candidateIndices[8];
+
+				for (auto i = 0; i < 8; i++)
+				{
+					auto best = std::numeric_limits<int>::max();
+
+					for (auto j = 0; j < 4; j++)
+					{
+						const auto color = glm::clamp(base + ETC_MODIFIERS[candidate][j], 0, 255);
+						const auto difference = color - texels[i];
+						const auto distance = difference.r * difference.r + difference.g * difference.g + difference.b * difference.b;
+
+						if (distance < best)
+						{
+							best = distance;
+							candidateIndices[i] = j;
+						}
+					}
+
+					error += best;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					table = candidate;
+					std::copy(std::begin(candidateIndices), std::end(candidateIndices), indices);
+				}
+			}
+
+			return bestError;
+		}
+
+		// Only the individual and differential modes of ETC1 are used, which ETC2 decodes the same way
+		// as long as the differential colors stay in range
+		void EncodeEtc2(const uint8_t* texels, uint8_t* output)
+		{
+			auto bestError = std::numeric_limits<int>::max();
+			uint32_t bestHigh = 0, bestLow = 0;
+
+			for (auto flip = 0; flip < 2; flip++)
+			{
+				// Two 2x4 halves side by side, or two 4x2 halves on top of each other when flipped
+				glm::ivec3 halves[2][8];
+				glm::ivec2 positions[2][8];
+				glm::vec3 averages[2] = { glm::vec3(0.0f), glm::vec3(0.0f) };
+				int counts[2] = {};
+
+				for (auto y = 0; y < 4; y++)
+				{
+					for (auto x = 0; x < 4; x++)
+					{
+						const auto half = flip != 0 ? y / 2 : x / 2;
+						const auto texel = (y * 4 + x) * 4;
+
+						halves[half][counts[half]] = { texels[texel], texels[texel + 1], texels[texel + 2] };
+						positions[half][counts[half]] = { x, y };
+						averages[half] += glm::vec3(halves[half][counts[half]]);
+						counts[half]++;
+					}
+				}
+
+				averages[0] /= 8.0f;
+				averages[1] /= 8.0f;
+
+				const auto tryMode = [&](const bool isDifferential, const glm::ivec3* quantized, const glm::ivec3* bases)
+				{
+					int tables[2];
+					int indices[2][8];
+
+					const auto error = FitEtcSubBlock(halves[0], bases[0], tables[0], indices[0])
+						+ FitEtcSubBlock(halves[1], bases[1], tables[1], indices[1]);
+
+					if (error >= bestError)
+						return;
+
+					bestError = error;
+
+					if (isDifferential)
+					{
+						const auto delta = quantized[1] - quantized[0];
+
+						bestHigh = static_cast<uint32_t>(quantized[0].r << 27 | (delta.r & 7) << 24 | quantized[0].g << 19
+							| (delta.g & 7) << 16 | quantized[0].b << 11 | (delta.b & 7) << 8);
+					}
+					else
+					{
+						bestHigh = static_cast<uint32_t>(quantized[0].r << 28 | quantized[1].r << 24 | quantized[0].g << 20
+							| quantized[1].g << 16 | quantized[0].b << 12 | quantized[1].b << 8);
+					}
+
+					bestHigh |= static_cast<uint32_t>(tables[0] << 5 | tables[1] << 2 | (isDifferential ? 2 : 0) | flip);
+					bestLow = 0;
+
+					// Texels are numbered down the columns, the index bits are split into two 16 bit planes
+					for (auto half = 0; half < 2; half++)
+					{
+						for (auto i = 0; i < 8; i++)
+						{
+							const auto bit = positions[half][i].x * 4 + positions[half][i].y;
+
+							bestLow |= static_cast<uint32_t>(indices[half][i] >> 1) << (16 + bit);
+							bestLow |= static_cast<uint32_t>(indices[half][i] & 1) << bit;
+						}
+					}
+				};
+
+				glm::ivec3 quantized[2];
+				glm::ivec3 bases[2];
+
+				for (auto half = 0; half < 2; half++)
+				{
+					quantized[half] = glm::ivec3(glm::round(averages[half] * 31.0f / 255.0f));
+					bases[half] = quantized[half] << 3 | quantized[half] >> 2;
+				}
+
+				const auto delta = quantized[1] - quantized[0];
+
+				if (glm::all(glm::greaterThanEqual(delta, glm::ivec3(-4))) && glm::all(glm::lessThanEqual(delta, glm::ivec3(3))))
+					tryMode(true, quantized, bases);
+
+				for (auto half = 0; half < 2; half++)
+				{
+					quantized[half] = glm::ivec3(glm::round(averages[half] * 15.0f / 255.0f));
+					bases[half] = quantized[half] * 17;
+				}
+
+				tryMode(false, quantized, bases);
+			}
+
+			for (auto i = 0; i < 4; i++)
+			{
+				output[i] = static_cast<uint8_t>(bestHigh >> (24 - i * 8));
+				output[4 + i] = static_cast<uint8_t>(bestLow >> (24 - i * 8));
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void BlockEncoder::EncodeBlock(const Graphics::CompressedFormat format, const uint8_t* texels, uint8_t* output)
+	{
+		switch (format)
+		{
+		case Graphics::CompressedFormat::BC1:
+			EncodeBC1Color(texels, output);
+			return;
+		case Graphics::CompressedFormat::BC3:
+			EncodeBC4(texels, 3, output);
+			EncodeBC1Color(texels, output + 8);
+			return;
+		case Graphics::CompressedFormat::BC4:
+			EncodeBC4(texels, 0, output);
+			return;
+		case Graphics::CompressedFormat::BC5:
+			EncodeBC4(texels, 0, output);
+			EncodeBC4(texels, 1, output + 8);
+			return;
+		case Graphics::CompressedFormat::BC7:
+			EncodeBC7(texels, output);
+			return;
+		case Graphics::CompressedFormat::ETC2:
+			EncodeEtc2(texels, output);
+			return;
+		}
+
+		throw std::runtime_error("Unhandled compressed format.");
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<unsigned char> BlockEncoder::EncodeLevel(const Graphics::CompressedFormat format, const unsigned char* pixels,
+		const int width, const int height, Utils::ThreadPool& threadPool)
+	{
+		const auto blocksX = (width + 3) / 4;
+		const auto blocksY = (height + 3) / 4;
+		const auto blockSize = Graphics::CompressedImage::GetBlockSize(format);
+
+		std::vector<unsigned char> output(Graphics::CompressedImage::GetLevelSize(format, width, height));
+
+		threadPool.ParallelFor(static_cast<size_t>(blocksY), [&](size_t, const size_t begin, const size_t end)
+		{
+			uint8_t texels[TEXEL_COUNT * 4];
+
+			for (auto blockY = static_cast<int>(begin); blockY < static_cast<int>(end); blockY++)
+			{
+				for (auto blockX = 0; blockX < blocksX; blockX++)
+				{
+					for (auto y = 0; y < 4; y++)
+					{
+						for (auto x = 0; x < 4; x++)
+						{
+							const auto sourceX = std::min(blockX * 4 + x, width - 1);
+							const auto sourceY = std::min(blockY * 4 + y, height - 1);
+
+							std::memcpy(texels + (y * 4 + x) * 4, pixels + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+						}
+					}
+
+					EncodeBlock(format, texels, output.data() + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize);
+				}
+			}
+		});
+
+		return output;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "../Graphics/CompressedImage.hpp"
+#include "../Utils/ThreadPool.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	// Offline encoders for the block compressed formats. They favour simplicity over the last bit
+	// of quality: each fits endpoints along the principal axis of a block's colors and refines
+	// them once by least squares, BC7 only uses its single subset mode 6 and ETC2 only the modes
+	// it shares with ETC1.
+	class BlockEncoder
+	{
+	public:
+		// Encodes 4x4 RGBA texels, row by row, into one block of the format.
+		static void EncodeBlock(Graphics::CompressedFormat format, const uint8_t* texels, uint8_t* output);
+
+		// Encodes a whole RGBA image, edge texels are repeated to fill partial blocks.
+		static std::vector<unsigned char> EncodeLevel(Graphics::CompressedFormat format, const unsigned char* pixels,
+			int width, int height, Utils::ThreadPool& threadPool);
+	};
+}
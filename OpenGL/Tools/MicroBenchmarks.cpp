@@ -0,0 +1,346 @@
+#include "MicroBenchmarks.hpp"
+
+//-------------------------------------------------------------------
+
+#include <stdexcept>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+//-------------------------------------------------------------------
+
+#include "../Graphics/VertexAttributeContainer.hpp"
+#include "../Input/InputManager.hpp"
+#include "../Utils/Camera3D.hpp"
+#include "../Utils/Clock.hpp"
+#include "../Utils/ThreadPool.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	namespace
+	{
+		constexpr Input::Keys CAMERA_KEYS[] =
+		{
+			Input::Keys::W,
+			Input::Keys::S,
+			Input::Keys::A,
+			Input::Keys::D,
+			Input::Keys::SPACE,
+			Input::Keys::LEFT_CONTROL
+		};
+
+		// Matches the object count of a busy scene rather than the ten cubes of the samples
+		constexpr size_t MODEL_MATRIX_COUNT = 1024;
+
+		double GetMedian(std::vector<double> values)
+		{
+			std::sort(values.begin(), values.end());
+
+			const auto middle = values.size() / 2;
+			return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) * 0.5;
+		}
+
+		MicroBenchmarks::Kernel CameraUpdate()
+		{
+			auto inputManager = std::make_shared<Input::InputManager>();
+			auto camera = std::make_shared<Utils::Camera3D>(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 1.0f, 0.0f), 45.0f);
+
+			inputManager->PressKey(Input::Keys::W);
+			inputManager->PressKey(Input::Keys::D);
+
+			return [inputManager, camera](const uint64_t iterations)
+			{
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					// Back and forth, so the angles stay in the range real input produces
+					const auto offset = (i & 1) != 0 ? 1.0f : -1.0f;
+					inputManager->SetCursorPosition(offset, offset);
+
+					camera->Update(1.0f / 120.0f, *inputManager);
+				}
+
+				DoNotOptimize(camera->GetFront());
+			};
+		}
+
+		MicroBenchmarks::Kernel CameraViewMatrix()
+		{
+			auto camera = std::make_shared<Utils::Camera3D>(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 1.0f, 0.0f), 45.0f);
+
+			return [camera](const uint64_t iterations)
+			{
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					const auto view = camera->GetInterpolatedViewMatrix(static_cast<float>(i & 0xFF) / 255.0f);
+					DoNotOptimize(view);
+				}
+			};
+		}
+
+		MicroBenchmarks::Kernel IsKeyDown()
+		{
+			auto inputManager = std::make_shared<Input::InputManager>();
+
+			// Some keys held, some released and some never seen, like during normal play
+			inputManager->PressKey(Input::Keys::W);
+			inputManager->PressKey(Input::Keys::A);
+			inputManager->ReleaseKey(Input::Keys::A);
+			inputManager->PressKey(Input::Keys::ESCAPE);
+			inputManager->ReleaseKey(Input::Keys::ESCAPE);
+
+			return [inputManager](const uint64_t iterations)
+			{
+				auto downCount = 0;
+
+				for (uint64_t i = 0; i < iterations; i++)
+					for (const auto key : CAMERA_KEYS)
+						downCount += inputManager->IsKeyDown(key) ? 1 : 0;
+
+				DoNotOptimize(downCount);
+			};
+		}
+
+		MicroBenchmarks::Kernel VertexAttributeContainerConstruction()
+		{
+			return [](const uint64_t iterations)
+			{
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					const Graphics::VertexAttributeContainer attributes = {
+						{ "aPos", Graphics::VertexAttributeType::VEC3F },
+						{ "aNormal", Graphics::VertexAttributeType::VEC3F },
+						{ "aTexCoords", Graphics::VertexAttributeType::VEC2F }
+					};
+
+					DoNotOptimize(attributes);
+				}
+			};
+		}
+
+		MicroBenchmarks::Kernel ModelMatrices()
+		{
+			auto positions = std::make_shared<std::vector<glm::vec3>>();
+			auto transforms = std::make_shared<std::vector<glm::mat4>>();
+
+			for (size_t i = 0; i < MODEL_MATRIX_COUNT; i++)
+			{
+				const auto angle = static_cast<float>(i) * 0.1f;
+				positions->emplace_back(std::cos(angle) * 10.0f, static_cast<float>(i % 7) - 3.0f, std::sin(angle) * 10.0f);
+			}
+
+			transforms->reserve(MODEL_MATRIX_COUNT);
+
+			// Same construction as Application_GettingStarted::BuildFramePacket
+			return [positions, transforms](const uint64_t iterations)
+			{
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					const auto elapsedTime = static_cast<double>(i) / 120.0;
+					transforms->clear();
+
+					for (const auto& position : *positions)
+					{
+						auto model = glm::translate(glm::mat4(1.0f), position);
+
+						const auto angle = std::fmod(elapsedTime * glm::radians(20.0 * position.z), glm::two_pi<double>());
+						model = glm::rotate(model, static_cast<float>(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+
+						transforms->push_back(model);
+					}
+
+					DoNotOptimize(transforms->back());
+				}
+			};
+		}
+
+		MicroBenchmarks::Kernel ParallelForDispatch()
+		{
+			auto threadPool = std::make_shared<Utils::ThreadPool>();
+
+			return [threadPool](const uint64_t iterations)
+			{
+				for (uint64_t i = 0; i < iterations; i++)
+					threadPool->ParallelFor(threadPool->GetThreadCount() + 1, [](size_t, size_t, size_t) {});
+			};
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	MicroBenchmarks::MicroBenchmarks(MicroBenchmarkSettings settings)
+		: settings(std::move(settings))
+	{
+	}
+
+	//-------------------------------------------------------------------
+
+	MicroBenchmarkSettings MicroBenchmarks::ParseArguments(const int argc, char** argv)
+	{
+		MicroBenchmarkSettings settings;
+
+		for (auto i = 0; i < argc; i++)
+		{
+			const std::string option = argv[i];
+
+			if (i + 1 >= argc)
+				throw std::runtime_error(("Missing value for " + option).c_str());
+
+			const std::string value = argv[++i];
+
+			if (option == "--filter")
+				settings.filter = value;
+			else if (option == "--samples")
+				settings.samples = std::max(std::stoi(value), 1);
+			else if (option == "--sample-ms")
+				settings.sampleMs = std::max(std::stod(value), 0.1);
+			else if (option == "--output")
+				settings.outputPath = value;
+			else
+				throw std::runtime_error(("Unknown microbenchmark option " + option).c_str());
+		}
+
+		return settings;
+	}
+
+	//-------------------------------------------------------------------
+
+	const std::vector<MicroBenchmarks::Benchmark>& MicroBenchmarks::GetBenchmarks()
+	{
+		static const std::vector<Benchmark> benchmarks =
+		{
+			{ "Camera3D::Update", CameraUpdate },
+			{ "Camera3D::GetInterpolatedViewMatrix", CameraViewMatrix },
+			{ "InputManager::IsKeyDown x6", IsKeyDown },
+			{ "VertexAttributeContainer construction", VertexAttributeContainerConstruction },
+			{ "Model matrices x1024", ModelMatrices },
+			{ "ThreadPool::ParallelFor empty", ParallelForDispatch }
+		};
+
+		return benchmarks;
+	}
+
+	//-------------------------------------------------------------------
+
+	void MicroBenchmarks::Run() const
+	{
+		std::vector<MicroBenchmarkResult> results;
+
+		for (const auto& benchmark : GetBenchmarks())
+		{
+			if (!settings.filter.empty() && benchmark.name.find(settings.filter) == std::string::npos)
+				continue;
+
+			results.push_back(Measure(benchmark));
+
+			const auto& result = results.back();
+
+			std::cout << std::left << std::setw(40) << result.name << std::right << std::fixed << std::setprecision(2)
+				<< std::setw(12) << result.medianNs << " ns"
+				<< "  +-" << std::setw(5) << result.medianAbsoluteDeviationNs / result.medianNs * 100.0 << "%"
+				<< "  min " << result.minNs << " ns"
+				<< "  (" << result.iterationsPerSample << " x " << settings.samples << ")" << std::endl;
+		}
+
+		if (settings.outputPath.empty())
+			return;
+
+		std::ofstream file(settings.outputPath);
+
+		if (!file)
+			throw std::runtime_error(("Could not open " + settings.outputPath).c_str());
+
+		WriteReport(file, results);
+	}
+
+	//-------------------------------------------------------------------
+
+	MicroBenchmarkResult MicroBenchmarks::Measure(const Benchmark& benchmark) const
+	{
+		const auto kernel = benchmark.setup();
+
+		const auto timeSample = [&kernel](const uint64_t iterations)
+		{
+			const Utils::Clock clock;
+			kernel(iterations);
+			return static_cast<double>(clock.GetElapsedNanoseconds());
+		};
+
+		// Doubles the iteration count until a sample is long enough to time reliably, then
+		// scales it to the requested sample duration
+		const auto targetNs = settings.sampleMs * 1e6;
+		uint64_t iterations = 1;
+		auto elapsedNs = timeSample(iterations);
+
+		while (elapsedNs < targetNs * 0.1 && iterations < (uint64_t(1) << 40))
+		{
+			iterations *= 2;
+			elapsedNs = timeSample(iterations);
+		}
+
+		iterations = std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(iterations) * targetNs / std::max(elapsedNs, 1.0)));
+
+		// Warms caches, branch predictors and the CPU clock up to speed
+		timeSample(iterations);
+
+		std::vector<double> samples;
+		samples.reserve(settings.samples);
+
+		for (auto sample = 0; sample < settings.samples; sample++)
+			samples.push_back(timeSample(iterations) / static_cast<double>(iterations));
+
+		MicroBenchmarkResult result;
+		result.name = benchmark.name;
+		result.iterationsPerSample = iterations;
+		result.medianNs = GetMedian(samples);
+		result.minNs = *std::min_element(samples.begin(), samples.end());
+		result.maxNs = *std::max_element(samples.begin(), samples.end());
+
+		std::vector<double> deviations;
+		deviations.reserve(samples.size());
+
+		for (const auto sample : samples)
+			deviations.push_back(std::abs(sample - result.medianNs));
+
+		result.medianAbsoluteDeviationNs = GetMedian(deviations);
+
+		return result;
+	}
+
+	//-------------------------------------------------------------------
+
+	void MicroBenchmarks::WriteReport(std::ostream& stream, const std::vector<MicroBenchmarkResult>& results)
+	{
+		stream << "[";
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const auto& result = results[i];
+
+			stream << (i == 0 ? "\n" : ",\n")
+				<< "  { \"name\": \"" << result.name << "\", "
+				<< "\"iterationsPerSample\": " << result.iterationsPerSample << ", "
+				<< "\"medianNs\": " << result.medianNs << ", "
+				<< "\"minNs\": " << result.minNs << ", "
+				<< "\"maxNs\": " << result.maxNs << ", "
+				<< "\"medianAbsoluteDeviationNs\": " << result.medianAbsoluteDeviationNs << " }";
+		}
+
+		stream << "\n]" << std::endl;
+	}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	__declspec(noinline) void EscapePointer(const volatile char* pointer)
+	{
+		// The volatile store is a side effect interprocedural optimization cannot prove away
+		static const volatile char* volatile sink;
+		sink = pointer;
+	}
+#endif
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	struct MicroBenchmarkSettings
+	{
+		// Only benchmarks whose name contains this run, empty runs all
+		std::string filter;
+
+		// Timed samples per benchmark, the first calibrated sample is always discarded as warmup
+		int samples = 25;
+
+		// Iterations per sample are calibrated so each sample takes about this long
+		double sampleMs = 10.0;
+
+		// Empty writes a table to standard output only
+		std::string outputPath;
+	};
+
+	struct MicroBenchmarkResult
+	{
+		std::string name;
+		uint64_t iterationsPerSample = 0;
+
+		// Per iteration, over all samples. The median and its absolute deviation are reported
+		// rather than mean and standard deviation, so a few preempted samples do not skew them.
+		double medianNs = 0.0;
+		double minNs = 0.0;
+		double maxNs = 0.0;
+		double medianAbsoluteDeviationNs = 0.0;
+	};
+
+	// Times CPU hot paths in isolation, without a window or GL context, so optimizations of
+	// them can be measured. New kernels are added to the list in MicroBenchmarks.cpp.
+	class MicroBenchmarks
+	{
+	public:
+		// Runs the given number of iterations of the measured code.
+		using Kernel = std::function<void(uint64_t iterations)>;
+
+		// Builds the state a kernel works on, outside of the timed region.
+		using Setup = std::function<Kernel()>;
+
+		struct Benchmark
+		{
+			std::string name;
+			Setup setup;
+		};
+
+	private:
+		MicroBenchmarkSettings settings;
+
+		[[nodiscard]] MicroBenchmarkResult Measure(const Benchmark& benchmark) const;
+
+		static void WriteReport(std::ostream& stream, const std::vector<MicroBenchmarkResult>& results);
+
+	public:
+		explicit MicroBenchmarks(MicroBenchmarkSettings settings);
+
+		static MicroBenchmarkSettings ParseArguments(int argc, char** argv);
+
+		[[nodiscard]] static const std::vector<Benchmark>& GetBenchmarks();
+
+		void Run() const;
+	};
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	// Never inlined, so even with whole program optimization MSVC has to assume the pointed-to value is read
+	__declspec(noinline) void EscapePointer(const volatile char* pointer);
+#endif
+
+	// Keeps the compiler from discarding a computation whose result is otherwise unused.
+	template <typename T>
+	void DoNotOptimize(const T& value)
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		EscapePointer(&reinterpret_cast<const volatile char&>(value));
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+}
@@ -0,0 +1,376 @@
+#include "RegressionSuite.hpp"
+
+//-------------------------------------------------------------------
+
+#include <stdexcept>
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+//-------------------------------------------------------------------
+
+#include "../Graphics/GpuProfiler.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	namespace
+	{
+		// Timings this small are dominated by noise, an increase has to exceed them as well
+		constexpr auto TIMING_NOISE_MS = 0.05;
+
+		bool IsTimingMetric(const std::string& name)
+		{
+			return name.find("Ms") != std::string::npos;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	RegressionSuite::RegressionSuite(RegressionSettings settings)
+		: settings(std::move(settings))
+	{
+	}
+
+	//-------------------------------------------------------------------
+
+	RegressionSettings RegressionSuite::ParseArguments(const int argc, char** argv)
+	{
+		RegressionSettings settings;
+		settings.benchmark.warmupFrames = 30;
+		settings.benchmark.measuredFrames = 200;
+
+		for (auto i = 0; i < argc; i++)
+		{
+			const std::string option = argv[i];
+
+			if (option == "--record")
+			{
+				settings.isRecording = true;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+				throw std::runtime_error(("Missing value for " + option).c_str());
+
+			const std::string value = argv[++i];
+
+			if (option == "--app")
+				settings.applications = { value };
+			else if (option == "--baselines")
+				settings.baselineDirectory = value;
+			else if (option == "--image-tolerance")
+				settings.imageTolerance = std::stod(value);
+			else if (option == "--pixel-tolerance")
+				settings.differingPixelTolerance = std::stod(value);
+			else if (option == "--threshold")
+				settings.metricThreshold = std::stod(value);
+			else if (option == "--frames")
+				settings.benchmark.measuredFrames = std::stoi(value);
+			else
+				throw std::runtime_error(("Unknown regression option " + option).c_str());
+		}
+
+		return settings;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool RegressionSuite::Run() const
+	{
+		if (settings.isRecording)
+			std::filesystem::create_directories(settings.baselineDirectory);
+
+		auto isPassing = true;
+
+		for (const auto& application : settings.applications)
+		{
+			const auto isApplicationPassing = RunApplication(application);
+
+			std::cout << (isApplicationPassing ? "PASS " : "FAIL ") << application << std::endl;
+
+			isPassing = isPassing && isApplicationPassing;
+		}
+
+		return isPassing;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool RegressionSuite::RunApplication(const std::string& application) const
+	{
+		const auto basePath = (std::filesystem::path(settings.baselineDirectory) / application).string();
+		const auto imagePath = basePath + ".ppm";
+		const auto metricsPath = basePath + ".baseline";
+
+		const auto app = BenchmarkRunner::CreateApplication(application, Utils::WindowBackend::HEADLESS);
+
+		auto runSettings = app->GetRunSettings();
+		runSettings.isGLStatsEnabled = true;
+		app->SetRunSettings(runSettings);
+
+		app->BeginSession();
+
+		auto& camera = app->GetCamera();
+		camera.SetIsUserControlEnabled(false);
+
+		// The simulation only advances through fixed steps, so the captured frame is reproducible
+		for (auto frame = 0; frame <= settings.captureFrame; frame++)
+		{
+			BenchmarkRunner::MoveCameraAlongPath(camera, frame * settings.benchmark.fixedTimeStep);
+			app->StepFrame(static_cast<float>(settings.benchmark.fixedTimeStep));
+		}
+
+		const auto image = ReadFramebuffer(app->GetWindow().GetFramebufferSize());
+		const auto metrics = GetMetrics(BenchmarkRunner(settings.benchmark).Measure(*app));
+
+		app->EndSession();
+
+		if (settings.isRecording)
+		{
+			SaveImage(imagePath, image);
+			SaveMetrics(metricsPath, metrics);
+
+			std::cout << "Recorded " << imagePath << " and " << metricsPath << std::endl;
+			return true;
+		}
+
+		Image reference;
+
+		if (!LoadImage(imagePath, reference))
+		{
+			std::cout << "Missing reference image for " << application << ", create it with --record" << std::endl;
+			return false;
+		}
+
+		const auto isImagePassing = CompareImages(application, reference, image);
+
+		if (!isImagePassing)
+			SaveImage(basePath + ".actual.ppm", image);
+
+		// Timings depend on the host, so metric baselines are recorded on each machine rather than committed
+		Metrics baseline;
+
+		if (!LoadMetrics(metricsPath, baseline))
+		{
+			std::cout << "No metric baselines for " << application << ", skipped comparing them, record them with --record" << std::endl;
+			return isImagePassing;
+		}
+
+		return CompareMetrics(application, baseline, metrics) && isImagePassing;
+	}
+
+	//-------------------------------------------------------------------
+
+	RegressionSuite::Image RegressionSuite::ReadFramebuffer(const glm::ivec2& size)
+	{
+		Image image;
+		image.width = size.x;
+		image.height = size.y;
+		image.pixels.resize(static_cast<size_t>(size.x) * size.y * 3);
+
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, size.x, size.y, GL_RGB, GL_UNSIGNED_BYTE, image.pixels.data());
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+		// GL returns the bottom row first
+		const auto rowSize = static_cast<size_t>(size.x) * 3;
+
+		for (auto row = 0; row < size.y / 2; row++)
+			std::swap_ranges(image.pixels.begin() + row * rowSize, image.pixels.begin() + (row + 1) * rowSize,
+				image.pixels.begin() + (size.y - 1 - row) * rowSize);
+
+		return image;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool RegressionSuite::LoadImage(const std::string& path, Image& image)
+	{
+		std::ifstream file(path, std::ios::binary);
+
+		if (!file)
+			return false;
+
+		std::string magic;
+		int maxValue = 0;
+
+		file >> magic >> image.width >> image.height >> maxValue;
+
+		if (magic != "P6" || maxValue != 255 || image.width <= 0 || image.height <= 0)
+			throw std::runtime_error(("Unsupported reference image " + path).c_str());
+
+		// Exactly one whitespace character separates the header from the pixels
+		file.get();
+
+		image.pixels.resize(static_cast<size_t>(image.width) * image.height * 3);
+		file.read(reinterpret_cast<char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size()));
+
+		if (!file)
+			throw std::runtime_error(("Truncated reference image " + path).c_str());
+
+		return true;
+	}
+
+	//-------------------------------------------------------------------
+
+	void RegressionSuite::SaveImage(const std::string& path, const Image& image)
+	{
+		std::ofstream file(path, std::ios::binary);
+
+		if (!file)
+			throw std::runtime_error(("Could not open " + path).c_str());
+
+		file << "P6\n" << image.width << " " << image.height << "\n255\n";
+		file.write(reinterpret_cast<const char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size()));
+	}
+
+	//-------------------------------------------------------------------
+
+	RegressionSuite::Metrics RegressionSuite::GetMetrics(const std::vector<BenchmarkFrame>& frames)
+	{
+		std::vector<double> cpuTimes;
+		std::vector<double> gpuTimes;
+		std::vector<double> drawCalls;
+		std::vector<double> stateChanges;
+		std::vector<double> uniformUploads;
+		std::vector<double> bytesUploaded;
+
+		for (const auto& frame : frames)
+		{
+			cpuTimes.push_back(frame.cpuMs);
+			drawCalls.push_back(static_cast<double>(frame.drawCalls));
+			stateChanges.push_back(static_cast<double>(frame.stateChanges));
+			uniformUploads.push_back(static_cast<double>(frame.uniformUploads));
+			bytesUploaded.push_back(static_cast<double>(frame.bytesUploaded));
+
+			const auto gpuMs = BenchmarkRunner::GetGpuFrameMs(frame);
+
+			if (gpuMs >= 0.0)
+				gpuTimes.push_back(gpuMs);
+		}
+
+		const auto cpu = BenchmarkRunner::GetDistribution(cpuTimes);
+		const auto gpu = BenchmarkRunner::GetDistribution(gpuTimes);
+
+		return {
+			{ "cpuFrameMsP50", cpu.p50 },
+			{ "cpuFrameMsP95", cpu.p95 },
+			{ "gpuFrameMsP50", gpu.p50 },
+			{ "gpuFrameMsP95", gpu.p95 },
+			{ "drawCalls", BenchmarkRunner::GetDistribution(drawCalls).mean },
+			{ "stateChanges", BenchmarkRunner::GetDistribution(stateChanges).mean },
+			{ "uniformUploads", BenchmarkRunner::GetDistribution(uniformUploads).mean },
+			{ "bytesUploaded", BenchmarkRunner::GetDistribution(bytesUploaded).mean }
+		};
+	}
+
+	//-------------------------------------------------------------------
+
+	bool RegressionSuite::LoadMetrics(const std::string& path, Metrics& metrics)
+	{
+		std::ifstream file(path);
+
+		if (!file)
+			return false;
+
+		std::string name;
+		double value;
+
+		while (file >> name >> value)
+			metrics[name] = value;
+
+		return true;
+	}
+
+	//-------------------------------------------------------------------
+
+	void RegressionSuite::SaveMetrics(const std::string& path, const Metrics& metrics)
+	{
+		std::ofstream file(path);
+
+		if (!file)
+			throw std::runtime_error(("Could not open " + path).c_str());
+
+		for (const auto& [name, value] : metrics)
+			file << name << " " << value << "\n";
+	}
+
+	//-------------------------------------------------------------------
+
+	bool RegressionSuite::CompareImages(const std::string& application, const Image& reference, const Image& actual) const
+	{
+		if (reference.width != actual.width || reference.height != actual.height)
+		{
+			std::cout << application << ": image is " << actual.width << "x" << actual.height
+				<< ", reference is " << reference.width << "x" << reference.height << std::endl;
+			return false;
+		}
+
+		auto squaredError = 0.0;
+		size_t differingPixels = 0;
+
+		for (size_t pixel = 0; pixel < actual.pixels.size(); pixel += 3)
+		{
+			auto largestDifference = 0;
+
+			for (size_t channel = pixel; channel < pixel + 3; channel++)
+			{
+				const auto difference = std::abs(static_cast<int>(actual.pixels[channel]) - reference.pixels[channel]);
+
+				squaredError += static_cast<double>(difference) * difference;
+				largestDifference = std::max(largestDifference, difference);
+			}
+
+			if (largestDifference > PIXEL_DIFFERENCE_LEVELS)
+				differingPixels++;
+		}
+
+		const auto rootMeanSquare = std::sqrt(squaredError / static_cast<double>(actual.pixels.size()));
+		const auto differingFraction = static_cast<double>(differingPixels) / static_cast<double>(actual.pixels.size() / 3);
+
+		const auto isPassing = rootMeanSquare <= settings.imageTolerance && differingFraction <= settings.differingPixelTolerance;
+
+		std::cout << application << ": image rms " << rootMeanSquare << " (limit " << settings.imageTolerance << "), "
+			<< differingFraction * 100.0 << "% pixels differ (limit " << settings.differingPixelTolerance * 100.0 << "%)" << std::endl;
+
+		return isPassing;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool RegressionSuite::CompareMetrics(const std::string& application, const Metrics& baseline, const Metrics& actual) const
+	{
+		auto isPassing = true;
+
+		for (const auto& [name, value] : actual)
+		{
+			const auto found = baseline.find(name);
+
+			if (found == baseline.end())
+			{
+				std::cout << application << ": " << name << " " << value << " has no baseline" << std::endl;
+				continue;
+			}
+
+			auto limit = found->second * (1.0 + settings.metricThreshold);
+
+			if (IsTimingMetric(name))
+				limit += TIMING_NOISE_MS;
+
+			const auto isMetricPassing = value <= limit;
+
+			std::cout << application << ": " << name << " " << value << " (baseline " << found->second << ")"
+				<< (isMetricPassing ? "" : " REGRESSED") << std::endl;
+
+			isPassing = isPassing && isMetricPassing;
+		}
+
+		return isPassing;
+	}
+}
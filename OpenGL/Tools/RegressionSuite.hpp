@@ -0,0 +1,85 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <map>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "BenchmarkRunner.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	struct RegressionSettings
+	{
+		std::vector<std::string> applications = { "lighting", "getting-started" };
+
+		// Reference images and metric baselines, one pair of files per application. The images,
+		// recorded on llvmpipe, are committed. Metrics are only compared once recorded on the host.
+		std::string baselineDirectory = "Regression";
+
+		// Overwrites the baselines with the current results instead of comparing against them
+		bool isRecording = false;
+
+		// Frame captured for the image comparison, stepped at the benchmark's fixed timestep
+		int captureFrame = 60;
+
+		// Largest root mean square channel error allowed, in 8 bit levels
+		double imageTolerance = 1.5;
+
+		// Largest fraction of pixels allowed to differ by more than PIXEL_DIFFERENCE_LEVELS
+		double differingPixelTolerance = 0.002;
+
+		// Relative increase over the baseline that fails a metric
+		double metricThreshold = 0.15;
+
+		BenchmarkSettings benchmark;
+	};
+
+	// Renders fixed frames of each application headlessly and compares them with stored
+	// reference images, then measures frame timings and GL counts against stored baselines.
+	// Meant to run on a software rasterizer such as llvmpipe, so results do not depend on the
+	// GPU or driver of the machine running it.
+	class RegressionSuite
+	{
+		struct Image
+		{
+			int width = 0;
+			int height = 0;
+
+			// Tightly packed RGB rows, top row first
+			std::vector<unsigned char> pixels;
+		};
+
+		using Metrics = std::map<std::string, double>;
+
+		RegressionSettings settings;
+
+		static Image ReadFramebuffer(const glm::ivec2& size);
+		static bool LoadImage(const std::string& path, Image& image);
+		static void SaveImage(const std::string& path, const Image& image);
+
+		static Metrics GetMetrics(const std::vector<BenchmarkFrame>& frames);
+		static bool LoadMetrics(const std::string& path, Metrics& metrics);
+		static void SaveMetrics(const std::string& path, const Metrics& metrics);
+
+		[[nodiscard]] bool CompareImages(const std::string& application, const Image& reference, const Image& actual) const;
+		[[nodiscard]] bool CompareMetrics(const std::string& application, const Metrics& baseline, const Metrics& actual) const;
+
+		[[nodiscard]] bool RunApplication(const std::string& application) const;
+
+	public:
+		static constexpr int PIXEL_DIFFERENCE_LEVELS = 16;
+
+		explicit RegressionSuite(RegressionSettings settings);
+
+		static RegressionSettings ParseArguments(int argc, char** argv);
+
+		// Returns true when every application matched its baselines, or when recording.
+		[[nodiscard]] bool Run() const;
+	};
+}
@@ -0,0 +1,246 @@
+#include "TextureCompressor.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+//-------------------------------------------------------------------
+
+#include "BlockEncoder.hpp"
+#include "../Graphics/GpuMemoryTracker.hpp"
+#include "../Utils/Clock.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	namespace
+	{
+		// Spreads the image's channels over RGBA, the encoders always read four
+		std::vector<unsigned char> ExpandToRgba(const Graphics::Image& image)
+		{
+			const auto texelCount = static_cast<size_t>(image.GetWidth()) * image.GetHeight();
+			const auto channels = image.GetChannels();
+			const auto source = image.GetPixels();
+
+			std::vector<unsigned char> pixels(texelCount * 4);
+
+			for (size_t i = 0; i < texelCount; i++)
+			{
+				unsigned char texel[4] = { 0, 0, 0, 255 };
+
+				for (auto channel = 0; channel < channels; channel++)
+					texel[channel] = source[i * channels + channel];
+
+				std::copy(std::begin(texel), std::end(texel), pixels.begin() + static_cast<std::ptrdiff_t>(i * 4));
+			}
+
+			return pixels;
+		}
+
+		Graphics::CompressedFormat ParseFormat(const std::string& name)
+		{
+			for (const auto format : { Graphics::CompressedFormat::BC1, Graphics::CompressedFormat::BC3, Graphics::CompressedFormat::BC4,
+				Graphics::CompressedFormat::BC5, Graphics::CompressedFormat::BC7, Graphics::CompressedFormat::ETC2 })
+			{
+				if (name == Graphics::CompressedImage::GetFormatName(format))
+					return format;
+			}
+
+			throw std::runtime_error(("Unknown compressed format " + name).c_str());
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	TextureCompressor::TextureCompressor(TextureCompressorSettings settings)
+		: settings(std::move(settings))
+	{
+		if (this->settings.format != "auto")
+			ParseFormat(this->settings.format);
+	}
+
+	//-------------------------------------------------------------------
+
+	TextureCompressorSettings TextureCompressor::ParseArguments(const int argc, char** argv)
+	{
+		TextureCompressorSettings settings;
+		auto hasInputs = false;
+
+		for (auto i = 0; i < argc; i++)
+		{
+			const std::string option = argv[i];
+
+			if (option == "--srgb")
+			{
+				settings.isSrgb = true;
+				continue;
+			}
+
+			if (option == "--linear")
+			{
+				settings.isLinear = true;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+				throw std::runtime_error(("Missing value for " + option).c_str());
+
+			const std::string value = argv[++i];
+
+			if (option == "--format")
+				settings.format = value;
+			else if (option == "--mip-filter")
+				settings.mipFilter = Graphics::MipGenerator::ParseFilter(value);
+			else if (option == "--flip")
+				settings.isFlippedVertically = value == "on";
+			else if (option == "--output")
+				settings.outputDirectory = value;
+			else if (option == "--input")
+			{
+				// The first input replaces the default
+				if (!hasInputs)
+					settings.inputs.clear();
+
+				settings.inputs.push_back(value);
+				hasInputs = true;
+			}
+			else
+				throw std::runtime_error(("Unknown compress option " + option).c_str());
+		}
+
+		return settings;
+	}
+
+	//-------------------------------------------------------------------
+
+	Graphics::CompressedImage TextureCompressor::Compress(const Graphics::Image& image, Utils::ThreadPool& threadPool) const
+	{
+		const auto format = GetFormat(image, ExpandToRgba(image));
+		const auto isColor = format != Graphics::CompressedFormat::BC4 && format != Graphics::CompressedFormat::BC5;
+
+		const Graphics::MipSettings mipSettings{ settings.mipFilter, isColor && !settings.isLinear };
+
+		std::vector<Graphics::CompressedLevel> levels;
+		auto data = std::make_shared<std::vector<unsigned char>>();
+
+		for (const auto& level : Graphics::MipGenerator::Generate(image, mipSettings, &threadPool))
+		{
+			const auto pixels = ExpandToRgba(level);
+			const auto blocks = BlockEncoder::EncodeLevel(format, pixels.data(), level.GetWidth(), level.GetHeight(), threadPool);
+
+			levels.push_back({ level.GetWidth(), level.GetHeight(), data->size(), blocks.size() });
+			data->insert(data->end(), blocks.begin(), blocks.end());
+		}
+
+		const auto isSrgb = settings.isSrgb && isColor;
+
+		return { format, isSrgb, settings.isFlippedVertically, std::move(levels),
+			std::shared_ptr<const unsigned char>(data, data->data()) };
+	}
+
+	//-------------------------------------------------------------------
+
+	void TextureCompressor::Run() const
+	{
+		Utils::ThreadPool threadPool;
+
+		uint64_t totalBefore = 0;
+		uint64_t totalAfter = 0;
+
+		for (const auto& input : GetInputFiles())
+		{
+			const Utils::Clock clock;
+
+			const auto image = Graphics::Image::Load(input, settings.isFlippedVertically);
+			const auto compressed = Compress(image, threadPool);
+
+			auto outputPath = std::filesystem::path(input).replace_extension(".ktx2");
+
+			if (!settings.outputDirectory.empty())
+			{
+				std::filesystem::create_directories(settings.outputDirectory);
+				outputPath = std::filesystem::path(settings.outputDirectory) / outputPath.filename();
+			}
+
+			compressed.Save(outputPath.string());
+
+			// Against what the texture loader would upload for the source image
+			const auto before = Graphics::GpuMemoryTracker::GetTextureSize(image.GetWidth(), image.GetHeight(), image.GetChannels(), true);
+			const auto after = compressed.GetSize();
+
+			totalBefore += before;
+			totalAfter += after;
+
+			std::cout << std::fixed << std::setprecision(1) << input << " -> " << outputPath.string() << ": "
+				<< Graphics::CompressedImage::GetFormatName(compressed.GetFormat()) << (compressed.GetIsSrgb() ? " srgb " : " ")
+				<< compressed.GetWidth() << "x" << compressed.GetHeight() << ", " << compressed.GetLevels().size() << " levels, "
+				<< before / 1024 << " KB -> " << after / 1024 << " KB ("
+				<< static_cast<double>(before) / static_cast<double>(after) << "x) in "
+				<< clock.GetElapsedSeconds() * 1000.0 << " ms" << std::endl;
+		}
+
+		if (totalAfter > 0)
+			std::cout << "Total " << totalBefore / 1024 << " KB -> " << totalAfter / 1024 << " KB" << std::endl;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<std::string> TextureCompressor::GetInputFiles() const
+	{
+		std::vector<std::string> files;
+
+		for (const auto& input : settings.inputs)
+		{
+			if (!std::filesystem::is_directory(input))
+			{
+				files.push_back(input);
+				continue;
+			}
+
+			for (const auto& entry : std::filesystem::directory_iterator(input))
+			{
+				const auto extension = entry.path().extension().string();
+
+				if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg"))
+					files.push_back(entry.path().generic_string());
+			}
+		}
+
+		std::sort(files.begin(), files.end());
+
+		return files;
+	}
+
+	//-------------------------------------------------------------------
+
+	Graphics::CompressedFormat TextureCompressor::GetFormat(const Graphics::Image& image, const std::vector<unsigned char>& pixels) const
+	{
+		auto isOpaque = true;
+
+		for (size_t i = 3; i < pixels.size() && isOpaque; i += 4)
+			isOpaque = pixels[i] == 255;
+
+		if (settings.format != "auto")
+		{
+			const auto format = ParseFormat(settings.format);
+
+			if (!isOpaque && (format == Graphics::CompressedFormat::BC1 || format == Graphics::CompressedFormat::ETC2))
+				std::cout << "Warning: " << settings.format << " drops the transparency of the image" << std::endl;
+
+			return format;
+		}
+
+		if (image.GetChannels() == 1)
+			return Graphics::CompressedFormat::BC4;
+
+		if (image.GetChannels() == 2)
+			return Graphics::CompressedFormat::BC5;
+
+		return isOpaque ? Graphics::CompressedFormat::BC1 : Graphics::CompressedFormat::BC3;
+	}
+}
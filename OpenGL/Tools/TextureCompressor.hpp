@@ -0,0 +1,64 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "../Graphics/CompressedImage.hpp"
+#include "../Graphics/Image.hpp"
+#include "../Graphics/MipGenerator.hpp"
+#include "../Utils/ThreadPool.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	struct TextureCompressorSettings
+	{
+		// bc1, bc3, bc4, bc5, bc7, etc2, or auto, which picks BC4 or BC5 for one and two channel
+		// images, BC3 for images with transparency and BC1 for the rest
+		std::string format = "auto";
+
+		// Marks color data as sRGB encoded, so sampling converts it to linear
+		bool isSrgb = false;
+
+		Graphics::MipFilter mipFilter = Graphics::MipFilter::KAISER;
+
+		// Filters the mipmaps of color images as they are stored rather than in linear light,
+		// for data such as normal maps
+		bool isLinear = false;
+
+		// Stores rows bottom to top, the order the applications load images in
+		bool isFlippedVertically = true;
+
+		// Files, or directories whose .png and .jpg files are all compressed
+		std::vector<std::string> inputs = { "Content/Textures" };
+
+		// Empty writes each .ktx2 file next to its source, where the texture loader looks for it
+		std::string outputDirectory;
+	};
+
+	// Encodes images and their full mip chains into block compressed KTX2 files, offline, so the
+	// applications neither decode PNGs nor generate mipmaps at load time and use 4 to 8 times less
+	// video memory for them.
+	class TextureCompressor
+	{
+		TextureCompressorSettings settings;
+
+		[[nodiscard]] std::vector<std::string> GetInputFiles() const;
+		[[nodiscard]] Graphics::CompressedFormat GetFormat(const Graphics::Image& image, const std::vector<unsigned char>& pixels) const;
+
+	public:
+		explicit TextureCompressor(TextureCompressorSettings settings);
+
+		static TextureCompressorSettings ParseArguments(int argc, char** argv);
+
+		// Compresses one image, the chain ends with a 1x1 level.
+		[[nodiscard]] Graphics::CompressedImage Compress(const Graphics::Image& image, Utils::ThreadPool& threadPool) const;
+
+		void Run() const;
+	};
+}
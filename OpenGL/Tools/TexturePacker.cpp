@@ -0,0 +1,556 @@
+#include "TexturePacker.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+//-------------------------------------------------------------------
+
+#include "../Utils/Clock.hpp"
+#include "../Utils/ContentPath.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	namespace
+	{
+		// Layers every context supports
+		constexpr size_t MAX_ARRAY_LAYERS = 256;
+
+		const char* GetChannelName(const int channels)
+		{
+			static const char* names[] = { "r", "rg", "rgb", "rgba" };
+
+			return names[channels - 1];
+		}
+
+		int AlignUp(const int value, const int alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		// Mip levels that keep at least a texel of padding around each image
+		int GetAtlasLevelCount(const int padding)
+		{
+			auto levelCount = 1;
+
+			while (2 << (levelCount - 1) <= padding)
+				levelCount++;
+
+			return levelCount;
+		}
+
+		// Bottom left skyline packing, each rectangle goes where its top ends up lowest, leftmost on ties
+		class SkylinePacker
+		{
+			struct Node
+			{
+				int x;
+				int y;
+				int width;
+			};
+
+			int width;
+			int height;
+
+			// Covers the whole width, left to right
+			std::vector<Node> nodes;
+
+		public:
+			SkylinePacker(const int width, const int height)
+				: width(width), height(height), nodes{ { 0, 0, width } }
+			{
+			}
+
+			bool Insert(const int rectWidth, const int rectHeight, int& x, int& y)
+			{
+				auto best = nodes.size();
+				auto bestTop = height + 1;
+
+				for (size_t i = 0; i < nodes.size() && nodes[i].x + rectWidth <= width; i++)
+				{
+					// Rests on the highest node it spans
+					auto top = 0;
+					auto covered = 0;
+
+					for (auto j = i; covered < rectWidth; j++)
+					{
+						top = std::max(top, nodes[j].y);
+						covered += nodes[j].width;
+					}
+
+					if (top + rectHeight <= height && top + rectHeight < bestTop)
+					{
+						best = i;
+						bestTop = top + rectHeight;
+					}
+				}
+
+				if (best == nodes.size())
+					return false;
+
+				x = nodes[best].x;
+				y = bestTop - rectHeight;
+
+				nodes.insert(nodes.begin() + static_cast<std::ptrdiff_t>(best), { x, bestTop, rectWidth });
+
+				for (auto i = best + 1; i < nodes.size() && nodes[i].x < x + rectWidth;)
+				{
+					const auto overlap = x + rectWidth - nodes[i].x;
+
+					if (overlap < nodes[i].width)
+					{
+						nodes[i].x += overlap;
+						nodes[i].width -= overlap;
+						break;
+					}
+
+					nodes.erase(nodes.begin() + static_cast<std::ptrdiff_t>(i));
+				}
+
+				for (size_t i = 0; i + 1 < nodes.size();)
+				{
+					if (nodes[i].y == nodes[i + 1].y)
+					{
+						nodes[i].width += nodes[i + 1].width;
+						nodes.erase(nodes.begin() + static_cast<std::ptrdiff_t>(i + 1));
+					}
+					else
+						i++;
+				}
+
+				return true;
+			}
+		};
+	}
+
+	//-------------------------------------------------------------------
+
+	TexturePacker::TexturePacker(TexturePackerSettings settings)
+		: settings(std::move(settings))
+	{
+		const auto& s = this->settings;
+
+		if (s.mode != "auto" && s.mode != "array" && s.mode != "atlas")
+			throw std::runtime_error(("Unknown pack mode " + s.mode).c_str());
+
+		if (s.atlasSize <= 0 || (s.atlasSize & (s.atlasSize - 1)) != 0)
+			throw std::runtime_error("The atlas size must be a power of two.");
+
+		if (s.maxSize <= 0 || s.padding < 0
+			|| AlignUp(s.maxSize + 2 * s.padding, 1 << (GetAtlasLevelCount(s.padding) - 1)) > s.atlasSize)
+			throw std::runtime_error("Images of the largest size to pack do not fit an atlas with their padding.");
+	}
+
+	//-------------------------------------------------------------------
+
+	TexturePackerSettings TexturePacker::ParseArguments(const int argc, char** argv)
+	{
+		TexturePackerSettings settings;
+		auto hasInputs = false;
+		auto hasLinearInputs = false;
+
+		for (auto i = 0; i < argc; i++)
+		{
+			const std::string option = argv[i];
+
+			if (option == "--linear")
+			{
+				settings.isLinear = true;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+				throw std::runtime_error(("Missing value for " + option).c_str());
+
+			const std::string value = argv[++i];
+
+			if (option == "--mode")
+				settings.mode = value;
+			else if (option == "--max-size")
+				settings.maxSize = std::stoi(value);
+			else if (option == "--atlas-size")
+				settings.atlasSize = std::stoi(value);
+			else if (option == "--padding")
+				settings.padding = std::stoi(value);
+			else if (option == "--mip-filter")
+				settings.mipFilter = Graphics::MipGenerator::ParseFilter(value);
+			else if (option == "--flip")
+				settings.isFlippedVertically = value == "on";
+			else if (option == "--output")
+				settings.outputDirectory = value;
+			else if (option == "--input")
+			{
+				// The first input replaces the default
+				if (!hasInputs)
+					settings.inputs.clear();
+
+				settings.inputs.push_back(value);
+				hasInputs = true;
+			}
+			else if (option == "--linear-input")
+			{
+				// Like inputs, the first one replaces the default
+				if (!hasLinearInputs)
+					settings.linearInputs.clear();
+
+				settings.linearInputs.push_back(value);
+				hasLinearInputs = true;
+			}
+			else
+				throw std::runtime_error(("Unknown pack option " + option).c_str());
+		}
+
+		return settings;
+	}
+
+	//-------------------------------------------------------------------
+
+	void TexturePacker::Run() const
+	{
+		Utils::ThreadPool threadPool;
+
+		const Utils::Clock clock;
+
+		std::vector<std::future<Graphics::Image>> loads;
+		const auto files = GetInputFiles();
+
+		for (const auto& file : files)
+		{
+			loads.push_back(threadPool.Enqueue([&file, isFlippedVertically = settings.isFlippedVertically]
+			{
+				return Graphics::Image::Load(file, isFlippedVertically);
+			}));
+		}
+
+		std::vector<Source> sources;
+
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			auto image = loads[i].get();
+
+			if (std::max(image.GetWidth(), image.GetHeight()) > settings.maxSize)
+			{
+				std::cout << files[i] << ": " << image.GetWidth() << "x" << image.GetHeight() << ", too large to pack" << std::endl;
+				continue;
+			}
+
+			sources.push_back({ files[i], std::move(image), GetIsLinear(files[i]) });
+		}
+
+		std::vector<std::pair<std::string, std::vector<const Source*>>> arrays;
+
+		// Keyed by channel count and whether the images are filtered as stored
+		std::map<std::pair<int, bool>, std::vector<const Source*>> atlases;
+
+		std::map<std::tuple<int, int, int>, std::vector<const Source*>> sizes;
+
+		for (const auto& source : sources)
+			sizes[{ source.image.GetChannels(), source.image.GetWidth(), source.image.GetHeight() }].push_back(&source);
+
+		for (const auto& [size, group] : sizes)
+		{
+			const auto [channels, width, height] = size;
+
+			if (settings.mode == "atlas" || group.size() < 2)
+			{
+				for (const auto source : group)
+					atlases[{ channels, source->isLinear }].push_back(source);
+
+				continue;
+			}
+
+			const auto name = std::string("array_") + GetChannelName(channels) + "_" + std::to_string(width) + "x" + std::to_string(height);
+
+			for (size_t first = 0; first < group.size(); first += MAX_ARRAY_LAYERS)
+			{
+				const auto last = std::min(first + MAX_ARRAY_LAYERS, group.size());
+				const auto suffix = group.size() > MAX_ARRAY_LAYERS ? "_" + std::to_string(first / MAX_ARRAY_LAYERS) : "";
+
+				arrays.emplace_back(name + suffix, std::vector<const Source*>(group.begin() + static_cast<std::ptrdiff_t>(first),
+					group.begin() + static_cast<std::ptrdiff_t>(last)));
+			}
+		}
+
+		std::vector<std::pair<std::string, Graphics::TextureAtlas>> packs;
+		std::vector<const Source*> unpacked;
+
+		for (const auto& [name, group] : arrays)
+			packs.emplace_back(name, PackArray(group, threadPool));
+
+		for (const auto& [key, group] : atlases)
+		{
+			const auto [channels, isLinear] = key;
+
+			if (settings.mode == "array" || group.size() < 2)
+			{
+				unpacked.insert(unpacked.end(), group.begin(), group.end());
+				continue;
+			}
+
+			packs.emplace_back(std::string("atlas_") + GetChannelName(channels) + (isLinear ? "_linear" : ""), PackAtlas(group, threadPool));
+		}
+
+		if (!packs.empty())
+			std::filesystem::create_directories(settings.outputDirectory);
+
+		size_t packedCount = 0;
+
+		for (const auto& [name, atlas] : packs)
+		{
+			const auto path = (std::filesystem::path(settings.outputDirectory) / (name + ".atlas")).generic_string();
+			atlas.Save(path);
+
+			uint64_t size = 0;
+			uint64_t usedArea = 0;
+
+			for (const auto& layer : atlas.GetLayers())
+			{
+				for (const auto& level : layer)
+					size += level.GetSize();
+			}
+
+			for (const auto& entry : atlas.GetEntries())
+				usedArea += static_cast<uint64_t>(entry.width) * entry.height;
+
+			const auto area = static_cast<uint64_t>(atlas.GetWidth()) * atlas.GetHeight() * atlas.GetLayerCount();
+
+			std::cout << std::fixed << std::setprecision(1) << path << ": " << atlas.GetEntries().size() << " textures, "
+				<< atlas.GetLayerCount() << (atlas.GetLayerCount() == 1 ? " layer of " : " layers of ")
+				<< atlas.GetWidth() << "x" << atlas.GetHeight() << " " << GetChannelName(atlas.GetChannels()) << ", "
+				<< atlas.GetLevelCount() << " levels, " << size / 1024 << " KB, "
+				<< 100.0 * static_cast<double>(usedArea) / static_cast<double>(area) << "% used" << std::endl;
+
+			std::cout << std::setprecision(6);
+
+			for (const auto& entry : atlas.GetEntries())
+			{
+				std::cout << "  " << entry.name << ": layer " << entry.layer << ", scale " << entry.uvScale.x << " " << entry.uvScale.y
+					<< ", offset " << entry.uvOffset.x << " " << entry.uvOffset.y << std::endl;
+			}
+
+			packedCount += atlas.GetEntries().size();
+		}
+
+		for (const auto source : unpacked)
+			std::cout << source->name << ": nothing to pack it with" << std::endl;
+
+		std::cout << std::fixed << std::setprecision(1) << "Packed " << packedCount << " textures into " << packs.size() << ", left "
+			<< unpacked.size() << " alone, in " << clock.GetElapsedSeconds() * 1000.0 << " ms" << std::endl;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<std::string> TexturePacker::GetInputFiles() const
+	{
+		std::vector<std::string> files;
+
+		for (const auto& input : settings.inputs)
+		{
+			if (!std::filesystem::is_directory(input))
+			{
+				files.push_back(std::filesystem::path(input).generic_string());
+				continue;
+			}
+
+			for (const auto& entry : std::filesystem::directory_iterator(input))
+			{
+				const auto extension = entry.path().extension().string();
+
+				if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg"))
+					files.push_back(entry.path().generic_string());
+			}
+		}
+
+		std::sort(files.begin(), files.end());
+
+		return files;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool TexturePacker::GetIsLinear(const std::string& file) const
+	{
+		if (settings.isLinear)
+			return true;
+
+		const auto path = Utils::ContentPath::Normalize(file);
+
+		return std::any_of(settings.linearInputs.begin(), settings.linearInputs.end(), [&path](const std::string& input)
+		{
+			const auto linearPath = Utils::ContentPath::Normalize(input);
+
+			return path == linearPath || path.starts_with(linearPath + "/");
+		});
+	}
+
+	//-------------------------------------------------------------------
+
+	Graphics::TextureAtlas TexturePacker::PackArray(const std::vector<const Source*>& sources, Utils::ThreadPool& threadPool) const
+	{
+		std::vector<std::vector<Graphics::Image>> layers;
+		std::vector<Graphics::TextureAtlasEntry> entries;
+
+		for (const auto source : sources)
+		{
+			Graphics::TextureAtlasEntry entry;
+			entry.name = source->name;
+			entry.layer = static_cast<int>(layers.size());
+			entry.width = source->image.GetWidth();
+			entry.height = source->image.GetHeight();
+
+			entries.push_back(std::move(entry));
+			// Each layer has its own mip chain, so color and data images can share an array
+			const Graphics::MipSettings mipSettings{ settings.mipFilter, !source->isLinear };
+			layers.push_back(Graphics::MipGenerator::Generate(source->image, mipSettings, &threadPool));
+		}
+
+		return { std::move(layers), std::move(entries), settings.isFlippedVertically };
+	}
+
+	//-------------------------------------------------------------------
+
+	Graphics::TextureAtlas TexturePacker::PackAtlas(const std::vector<const Source*>& sources, Utils::ThreadPool& threadPool) const
+	{
+		// Box filtered levels of rectangles aligned to this only ever average texels of the same rectangle
+		const auto levelCount = GetAtlasLevelCount(settings.padding);
+		const auto alignment = 1 << (levelCount - 1);
+
+		struct Placement
+		{
+			const Source* source;
+			int width;
+			int height;
+
+			int layer = 0;
+			int x = 0;
+			int y = 0;
+		};
+
+		std::vector<Placement> placements;
+		uint64_t area = 0;
+		auto largest = 0;
+
+		for (const auto source : sources)
+		{
+			const auto width = AlignUp(source->image.GetWidth() + 2 * settings.padding, alignment);
+			const auto height = AlignUp(source->image.GetHeight() + 2 * settings.padding, alignment);
+
+			placements.push_back({ source, width, height });
+			area += static_cast<uint64_t>(width) * height;
+			largest = std::max({ largest, width, height });
+		}
+
+		// Tallest first leaves the flattest skyline
+		std::stable_sort(placements.begin(), placements.end(), [](const Placement& a, const Placement& b)
+		{
+			return a.height != b.height ? a.height > b.height : a.width > b.width;
+		});
+
+		const auto pack = [&placements](const int width, const int height)
+		{
+			std::vector<SkylinePacker> packers;
+
+			for (auto& placement : placements)
+			{
+				placement.layer = 0;
+
+				while (placement.layer < static_cast<int>(packers.size())
+					&& !packers[placement.layer].Insert(placement.width, placement.height, placement.x, placement.y))
+					placement.layer++;
+
+				if (placement.layer == static_cast<int>(packers.size()))
+				{
+					packers.emplace_back(width, height);
+					packers.back().Insert(placement.width, placement.height, placement.x, placement.y);
+				}
+			}
+
+			return static_cast<int>(packers.size());
+		};
+
+		// The smallest layer, square or twice as wide, that holds every image, or as many layers of
+		// the largest as it takes
+		auto width = 1;
+		auto height = 1;
+
+		const auto grow = [&width, &height]
+		{
+			if (width == height)
+				width *= 2;
+			else
+				height *= 2;
+		};
+
+		while (width < largest || height < largest || static_cast<uint64_t>(width) * height < area)
+			grow();
+
+		while (height < settings.atlasSize && pack(width, height) > 1)
+			grow();
+
+		width = std::min(width, settings.atlasSize);
+		height = std::min(height, settings.atlasSize);
+		const auto layerCount = pack(width, height);
+
+		const auto channels = sources.front()->image.GetChannels();
+		std::vector<std::vector<unsigned char>> pixels(layerCount, std::vector<unsigned char>(static_cast<size_t>(width) * height * channels));
+		std::vector<Graphics::TextureAtlasEntry> entries;
+
+		for (const auto& placement : placements)
+		{
+			const auto& image = placement.source->image;
+			auto& layer = pixels[placement.layer];
+
+			// The padding repeats the image's edges, so filtering near them samples the image itself
+			for (auto y = 0; y < placement.height; y++)
+			{
+				const auto sourceY = std::clamp(y - settings.padding, 0, image.GetHeight() - 1);
+
+				for (auto x = 0; x < placement.width; x++)
+				{
+					const auto sourceX = std::clamp(x - settings.padding, 0, image.GetWidth() - 1);
+
+					std::memcpy(layer.data() + ((static_cast<size_t>(placement.y) + y) * width + placement.x + x) * channels,
+						image.GetPixels() + (static_cast<size_t>(sourceY) * image.GetWidth() + sourceX) * channels, channels);
+				}
+			}
+
+			Graphics::TextureAtlasEntry entry;
+			entry.name = placement.source->name;
+			entry.layer = placement.layer;
+			entry.x = placement.x + settings.padding;
+			entry.y = placement.y + settings.padding;
+			entry.width = image.GetWidth();
+			entry.height = image.GetHeight();
+
+			entries.push_back(std::move(entry));
+		}
+
+		// Grouped so every image of an atlas is filtered the same way
+		const Graphics::MipSettings mipSettings{ Graphics::MipFilter::BOX, !sources.front()->isLinear };
+
+		std::vector<std::vector<Graphics::Image>> layers;
+
+		for (auto& layer : pixels)
+		{
+			auto data = std::make_shared<std::vector<unsigned char>>(std::move(layer));
+			const Graphics::Image image(width, height, channels, std::shared_ptr<const unsigned char>(data, data->data()));
+
+			auto levels = Graphics::MipGenerator::Generate(image, mipSettings, &threadPool);
+			levels.resize(static_cast<size_t>(levelCount));
+
+			layers.push_back(std::move(levels));
+		}
+
+		return { std::move(layers), std::move(entries), settings.isFlippedVertically };
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "../Graphics/Image.hpp"
+#include "../Graphics/MipGenerator.hpp"
+#include "../Graphics/TextureAtlas.hpp"
+#include "../Utils/ThreadPool.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Tools
+{
+	struct TexturePackerSettings
+	{
+		// array, atlas, or auto, which puts images sharing their size and channel count into arrays
+		// and packs the rest into atlases
+		std::string mode = "auto";
+
+		// Images larger than this either way are left out
+		int maxSize = 512;
+
+		// Largest atlas layer, atlases that need more space get more layers
+		int atlasSize = 2048;
+
+		// Texels of edge repeated around each image in an atlas. Atlases get mipmaps down to the
+		// level where it shrinks to a single texel, so images never bleed into each other.
+		int padding = 8;
+
+		// Atlases always filter with a box, the only filter that keeps to the images' own texels
+		Graphics::MipFilter mipFilter = Graphics::MipFilter::KAISER;
+
+		// Filters the mipmaps of every image as stored rather than in linear light
+		bool isLinear = false;
+
+		// Files, or directories whose images all, hold data such as specular or normal maps rather
+		// than color, so their mipmaps are filtered as stored. Arrays give each layer its own
+		// filtering, atlases only hold images filtered the same way.
+		std::vector<std::string> linearInputs = { "Content/Textures/container2_specular.png" };
+
+		// Stores rows bottom to top, the order the applications load images in
+		bool isFlippedVertically = true;
+
+		// Files, or directories whose .png and .jpg files are all packed
+		std::vector<std::string> inputs = { "Content/Textures" };
+
+		std::string outputDirectory = "Content/Textures/Packed";
+	};
+
+	// Packs small textures offline into texture arrays and atlases, so materials using any of the
+	// textures of a pack share a single binding instead of switching textures between draws. Each
+	// pack is written to a .atlas file along with the table that tells materials where each
+	// texture went, see Graphics::TextureAtlas.
+	class TexturePacker
+	{
+		TexturePackerSettings settings;
+
+		struct Source
+		{
+			std::string name;
+			Graphics::Image image;
+			bool isLinear = false;
+		};
+
+		[[nodiscard]] std::vector<std::string> GetInputFiles() const;
+		[[nodiscard]] bool GetIsLinear(const std::string& file) const;
+
+		[[nodiscard]] Graphics::TextureAtlas PackArray(const std::vector<const Source*>& sources, Utils::ThreadPool& threadPool) const;
+		[[nodiscard]] Graphics::TextureAtlas PackAtlas(const std::vector<const Source*>& sources, Utils::ThreadPool& threadPool) const;
+
+	public:
+		explicit TexturePacker(TexturePackerSettings settings);
+
+		static TexturePackerSettings ParseArguments(int argc, char** argv);
+
+		void Run() const;
+	};
+}
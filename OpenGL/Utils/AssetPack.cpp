@@ -0,0 +1,265 @@
+#include "AssetPack.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+//-------------------------------------------------------------------
+
+#include "ContentPath.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	namespace
+	{
+		constexpr char MAGIC[4] = { 'A', 'P', 'A', 'K' };
+		constexpr uint32_t VERSION = 1;
+
+		// Followed by the entries, sorted by path, then by the paths, then by the files
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint64_t entryCount;
+			uint64_t pathsOffset;
+			uint64_t pathsSize;
+		};
+
+		std::mutex mountMutex;
+		std::shared_ptr<const AssetPack> mounted;
+
+		void Append(std::vector<unsigned char>& bytes, const void* data, const size_t size)
+		{
+			const auto begin = static_cast<const unsigned char*>(data);
+			bytes.insert(bytes.end(), begin, begin + size);
+		}
+	}
+
+	struct AssetPack::Entry
+	{
+		uint64_t offset;
+		uint64_t size;
+		uint32_t pathOffset;
+		uint32_t pathLength;
+	};
+
+	//-------------------------------------------------------------------
+
+	Asset::Asset(std::shared_ptr<const MappedFile> file, const std::span<const unsigned char> bytes)
+		: file(std::move(file)), bytes(bytes)
+	{
+	}
+
+	//-------------------------------------------------------------------
+
+	std::shared_ptr<const unsigned char> Asset::GetPointer(const size_t offset) const
+	{
+		return { file, bytes.data() + offset };
+	}
+
+	//-------------------------------------------------------------------
+
+	std::shared_ptr<const AssetPack> AssetPack::Open(const std::string& path)
+	{
+		auto file = MappedFile::Open(path);
+
+		if (file == nullptr)
+			throw std::runtime_error(("Failed to open asset pack " + path).c_str());
+
+		const auto fail = [&path](const std::string& reason)
+		{
+			return std::runtime_error(("Failed to load asset pack " + path + ": " + reason).c_str());
+		};
+
+		Header header{};
+
+		if (file->GetSize() < sizeof(header))
+			throw fail("truncated header");
+
+		std::memcpy(&header, file->GetData(), sizeof(header));
+
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+			throw fail("not an asset pack");
+
+		const auto size = static_cast<uint64_t>(file->GetSize());
+
+		if (header.entryCount > (size - sizeof(header)) / sizeof(Entry) || header.pathsOffset != sizeof(header) + header.entryCount * sizeof(Entry)
+			|| header.pathsSize > size - header.pathsOffset)
+			throw fail("truncated index");
+
+		const auto pack = std::make_shared<AssetPack>();
+		pack->file = std::move(file);
+		pack->entries = reinterpret_cast<const Entry*>(pack->file->GetData() + sizeof(header));
+		pack->entryCount = static_cast<size_t>(header.entryCount);
+
+		// Checked once here, so lookups can trust the index
+		for (size_t i = 0; i < pack->entryCount; i++)
+		{
+			const auto& entry = pack->entries[i];
+
+			if (entry.pathOffset > header.pathsSize || entry.pathLength > header.pathsSize - entry.pathOffset
+				|| entry.offset % ALIGNMENT != 0 || entry.offset > size || entry.size > size - entry.offset)
+				throw fail("entry " + std::to_string(i) + " is out of bounds");
+
+			if (i > 0 && !(pack->GetPath(pack->entries[i - 1]) < pack->GetPath(entry)))
+				throw fail("the index is not sorted");
+		}
+
+		return pack;
+	}
+
+	//-------------------------------------------------------------------
+
+	void AssetPack::Write(const std::string& path, const std::vector<std::pair<std::string, std::string>>& files)
+	{
+		std::vector<std::pair<std::string, std::string>> sorted;
+
+		for (const auto& [packPath, sourcePath] : files)
+			sorted.emplace_back(ContentPath::Normalize(packPath), sourcePath);
+
+		std::sort(sorted.begin(), sorted.end());
+
+		for (size_t i = 1; i < sorted.size(); i++)
+		{
+			if (sorted[i].first == sorted[i - 1].first)
+				throw std::runtime_error(("Two files would be packed as " + sorted[i].first).c_str());
+		}
+
+		std::vector<unsigned char> paths;
+		std::vector<Entry> entries;
+
+		for (const auto& [packPath, sourcePath] : sorted)
+		{
+			entries.push_back({ 0, 0, static_cast<uint32_t>(paths.size()), static_cast<uint32_t>(packPath.size()) });
+			Append(paths, packPath.data(), packPath.size());
+		}
+
+		Header header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.entryCount = entries.size();
+		header.pathsOffset = sizeof(header) + entries.size() * sizeof(Entry);
+		header.pathsSize = paths.size();
+
+		auto offset = header.pathsOffset + paths.size();
+
+		for (size_t i = 0; i < sorted.size(); i++)
+		{
+			entries[i].offset = (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+			entries[i].size = std::filesystem::file_size(sorted[i].second);
+			offset = entries[i].offset + entries[i].size;
+		}
+
+		std::vector<unsigned char> index;
+		Append(index, &header, sizeof(header));
+		Append(index, entries.data(), entries.size() * sizeof(Entry));
+		Append(index, paths.data(), paths.size());
+
+		std::ofstream file(path, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+
+		for (size_t i = 0; i < sorted.size(); i++)
+		{
+			std::ifstream source(sorted[i].second, std::ios::binary);
+
+			if (!source)
+				throw std::runtime_error(("Failed to open " + sorted[i].second).c_str());
+
+			// Pads up to the file's page
+			const std::vector<char> padding(static_cast<size_t>(entries[i].offset) - static_cast<size_t>(file.tellp()));
+			file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+			// Inserting an empty file would fail the stream
+			if (entries[i].size > 0)
+				file << source.rdbuf();
+
+			if (static_cast<uint64_t>(file.tellp()) != entries[i].offset + entries[i].size)
+				throw std::runtime_error((sorted[i].second + " changed while it was packed.").c_str());
+		}
+
+		if (!file)
+			throw std::runtime_error(("Failed to write " + path).c_str());
+	}
+
+	//-------------------------------------------------------------------
+
+	std::optional<Asset> AssetPack::Find(const std::string_view path) const
+	{
+		const auto normalized = ContentPath::Normalize(path);
+		const auto end = entries + entryCount;
+
+		const auto it = std::lower_bound(entries, end, normalized, [this](const Entry& entry, const std::string& value)
+		{
+			return GetPath(entry) < value;
+		});
+
+		if (it == end || GetPath(*it) != normalized)
+			return std::nullopt;
+
+		return Asset(file, { file->GetData() + it->offset, static_cast<size_t>(it->size) });
+	}
+
+	//-------------------------------------------------------------------
+
+	void AssetPack::Mount(std::shared_ptr<const AssetPack> pack)
+	{
+		std::lock_guard lock(mountMutex);
+		mounted = std::move(pack);
+	}
+
+	//-------------------------------------------------------------------
+
+	std::shared_ptr<const AssetPack> AssetPack::GetMounted()
+	{
+		std::lock_guard lock(mountMutex);
+		return mounted;
+	}
+
+	//-------------------------------------------------------------------
+
+	Asset AssetPack::Load(const std::string& path)
+	{
+		if (const auto pack = GetMounted())
+		{
+			if (auto asset = pack->Find(path))
+				return std::move(*asset);
+		}
+
+		auto file = MappedFile::Open(path);
+
+		if (file != nullptr)
+			return { file, { file->GetData(), file->GetSize() } };
+
+		// Mapping fails for empty files
+		if (std::filesystem::is_regular_file(path))
+			return {};
+
+		throw std::runtime_error(("Failed to open " + path).c_str());
+	}
+
+	//-------------------------------------------------------------------
+
+	bool AssetPack::Exists(const std::string& path)
+	{
+		if (const auto pack = GetMounted(); pack != nullptr && pack->Find(path))
+			return true;
+
+		return std::filesystem::is_regular_file(path);
+	}
+
+	//-------------------------------------------------------------------
+
+	std::string_view AssetPack::GetPath(const Entry& entry) const
+	{
+		const auto paths = reinterpret_cast<const char*>(file->GetData()) + sizeof(Header) + entryCount * sizeof(Entry);
+
+		return { paths + entry.pathOffset, entry.pathLength };
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "MappedFile.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	// The bytes of a file, mapped rather than read. They stay valid as long as the asset, or a
+	// pointer from GetPointer, lives.
+	class Asset
+	{
+		std::shared_ptr<const MappedFile> file;
+		std::span<const unsigned char> bytes;
+
+	public:
+		Asset() = default;
+		Asset(std::shared_ptr<const MappedFile> file, std::span<const unsigned char> bytes);
+
+		[[nodiscard]] const unsigned char* GetData() const { return bytes.data(); }
+		[[nodiscard]] size_t GetSize() const { return bytes.size(); }
+		[[nodiscard]] std::span<const unsigned char> GetBytes() const { return bytes; }
+		[[nodiscard]] std::string_view GetText() const { return { reinterpret_cast<const char*>(bytes.data()), bytes.size() }; }
+
+		// Shares ownership of the mapping, for data that keeps pointing into it.
+		[[nodiscard]] std::shared_ptr<const unsigned char> GetPointer(size_t offset = 0) const;
+	};
+
+	// Files packed into one by the pack-assets tool, opened once and mapped. An index of the
+	// files' paths, sorted so lookups are a binary search, is followed by the files, each starting
+	// on a page boundary so the OS maps in only the pages of the files that are used.
+	//
+	// One pack can be mounted for the whole process. Loaders read through Load, which returns the
+	// mounted pack's copy of a file and falls back to the file system for files it does not have.
+	class AssetPack
+	{
+		struct Entry;
+
+		std::shared_ptr<const MappedFile> file;
+		const Entry* entries = nullptr;
+		size_t entryCount = 0;
+
+		[[nodiscard]] std::string_view GetPath(const Entry& entry) const;
+
+	public:
+		static constexpr size_t ALIGNMENT = 4096;
+
+		// Throws when the file is not a pack this class could have written.
+		[[nodiscard]] static std::shared_ptr<const AssetPack> Open(const std::string& path);
+
+		// Takes the path each file gets in the pack and the path to read it from.
+		static void Write(const std::string& path, const std::vector<std::pair<std::string, std::string>>& files);
+
+		// Returns nothing when the pack has no file with the path.
+		[[nodiscard]] std::optional<Asset> Find(std::string_view path) const;
+
+		[[nodiscard]] size_t GetFileCount() const { return entryCount; }
+		[[nodiscard]] size_t GetSize() const { return file->GetSize(); }
+
+		// Null unmounts. Mount before loading starts, loads running meanwhile may use either pack.
+		static void Mount(std::shared_ptr<const AssetPack> pack);
+		[[nodiscard]] static std::shared_ptr<const AssetPack> GetMounted();
+
+		// Safe to call from any thread. Throws when the file is neither in the mounted pack nor on disk.
+		[[nodiscard]] static Asset Load(const std::string& path);
+		[[nodiscard]] static bool Exists(const std::string& path);
+	};
+}
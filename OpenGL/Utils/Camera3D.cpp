@@ -3,6 +3,8 @@
 #include <glm/ext/matrix_transform.hpp>
 #include <algorithm>
 
+#include "CpuProfiler.hpp"
+
 namespace Utils
 {
 	Camera3D::Camera3D(const glm::vec3 position, const glm::vec3 worldUp, const float maxZoom)
@@ -11,6 +13,13 @@ namespace Utils
 		  zoom(maxZoom), maxZoom(maxZoom), isUserControlEnabled(true), 
 		  previousCursorPosition(0.0f)
 	{
+		right = glm::normalize(glm::cross(front, worldUp));
+		up = glm::normalize(glm::cross(right, front));
+
+		previousPosition = position;
+		previousFront = front;
+		previousUp = up;
+		previousZoom = zoom;
 	}
 
 	glm::mat4 Camera3D::GetViewMatrix() const
@@ -18,8 +27,34 @@ namespace Utils
 		return glm::lookAt(position, position + front, up);
 	}
 
+	glm::mat4 Camera3D::GetInterpolatedViewMatrix(const float alpha) const
+	{
+		const auto interpolatedPosition = GetInterpolatedPosition(alpha);
+		const auto interpolatedFront = glm::normalize(glm::mix(previousFront, front, alpha));
+		const auto interpolatedUp = glm::normalize(glm::mix(previousUp, up, alpha));
+
+		return glm::lookAt(interpolatedPosition, interpolatedPosition + interpolatedFront, interpolatedUp);
+	}
+
+	glm::vec3 Camera3D::GetInterpolatedPosition(const float alpha) const
+	{
+		return glm::mix(previousPosition, position, alpha);
+	}
+
+	float Camera3D::GetInterpolatedZoom(const float alpha) const
+	{
+		return glm::mix(previousZoom, zoom, alpha);
+	}
+
 	void Camera3D::Update(float deltaTime, Input::InputManager& inputManager)
 	{
+		CPU_FUNCTION_ZONE();
+
+		previousPosition = position;
+		previousFront = front;
+		previousUp = up;
+		previousZoom = zoom;
+
 		if (!isUserControlEnabled)
 			return;
 
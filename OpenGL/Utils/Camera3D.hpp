@@ -14,6 +14,12 @@ namespace Utils
 		glm::vec3 right;
 		glm::vec3 worldUp;
 
+		// State at the start of the last Update, used to interpolate between simulation steps
+		glm::vec3 previousPosition;
+		glm::vec3 previousFront;
+		glm::vec3 previousUp;
+		float previousZoom;
+
 		float yaw;
 		float pitch;
 
@@ -44,6 +50,11 @@ namespace Utils
 
 		[[nodiscard]] glm::mat4 GetViewMatrix() const;
 
+		// Blends the state before and after the last Update, alpha 0 gives the previous state.
+		[[nodiscard]] glm::mat4 GetInterpolatedViewMatrix(float alpha) const;
+		[[nodiscard]] glm::vec3 GetInterpolatedPosition(float alpha) const;
+		[[nodiscard]] float GetInterpolatedZoom(float alpha) const;
+
 		[[nodiscard]] bool GetIsUserControlEnabled() const { return isUserControlEnabled; }
 		[[nodiscard]] glm::vec3 GetPosition() const { return position; }
 		[[nodiscard]] glm::vec3 GetFront() const { return front; }
@@ -0,0 +1,32 @@
+#include "Clock.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	Clock::Clock()
+		: startTime(Now())
+	{
+	}
+
+	//-------------------------------------------------------------------
+
+	void Clock::Restart()
+	{
+		startTime = Now();
+	}
+
+	//-------------------------------------------------------------------
+
+	int64_t Clock::GetElapsedNanoseconds() const
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Now() - startTime).count();
+	}
+
+	//-------------------------------------------------------------------
+
+	double Clock::GetElapsedSeconds() const
+	{
+		return static_cast<double>(GetElapsedNanoseconds()) * 1e-9;
+	}
+}
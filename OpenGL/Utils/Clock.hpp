@@ -0,0 +1,33 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdint>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	// Monotonic high resolution clock. Time is kept as integer nanoseconds so it does not
+	// lose precision however long the process has been running.
+	class Clock
+	{
+	public:
+		using TimePoint = std::chrono::steady_clock::time_point;
+
+	private:
+		TimePoint startTime;
+
+	public:
+		Clock();
+
+		void Restart();
+
+		[[nodiscard]] int64_t GetElapsedNanoseconds() const;
+		[[nodiscard]] double GetElapsedSeconds() const;
+		[[nodiscard]] TimePoint GetStartTime() const { return startTime; }
+
+		[[nodiscard]] static TimePoint Now() { return std::chrono::steady_clock::now(); }
+	};
+}
@@ -0,0 +1,120 @@
+#include "ContentHash.hpp"
+
+//-------------------------------------------------------------------
+
+#include <cstring>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	namespace
+	{
+		constexpr uint64_t PRIME1 = 11400714785074694791ull;
+		constexpr uint64_t PRIME2 = 14029467366897019727ull;
+		constexpr uint64_t PRIME3 = 1609587929392839161ull;
+		constexpr uint64_t PRIME4 = 9650029242287828579ull;
+		constexpr uint64_t PRIME5 = 2870177450012600261ull;
+
+		uint64_t RotateLeft(const uint64_t value, const int bits)
+		{
+			return value << bits | value >> (64 - bits);
+		}
+
+		uint64_t Read64(const unsigned char* bytes)
+		{
+			uint64_t value;
+			std::memcpy(&value, bytes, sizeof(value));
+
+			return value;
+		}
+
+		uint32_t Read32(const unsigned char* bytes)
+		{
+			uint32_t value;
+			std::memcpy(&value, bytes, sizeof(value));
+
+			return value;
+		}
+
+		uint64_t Round(uint64_t accumulator, const uint64_t input)
+		{
+			accumulator += input * PRIME2;
+			accumulator = RotateLeft(accumulator, 31);
+
+			return accumulator * PRIME1;
+		}
+
+		uint64_t MergeRound(uint64_t accumulator, const uint64_t value)
+		{
+			accumulator ^= Round(0, value);
+
+			return accumulator * PRIME1 + PRIME4;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	uint64_t ContentHash::Compute(const void* data, const size_t size, const uint64_t seed)
+	{
+		auto bytes = static_cast<const unsigned char*>(data);
+		const auto end = bytes + size;
+
+		uint64_t hash;
+
+		if (size >= 32)
+		{
+			// Four independent lanes of 8 bytes keep the multipliers busy
+			uint64_t lanes[4] = { seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1 };
+
+			for (; end - bytes >= 32; bytes += 32)
+			{
+				for (auto i = 0; i < 4; i++)
+					lanes[i] = Round(lanes[i], Read64(bytes + i * 8));
+			}
+
+			hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+
+			for (const auto lane : lanes)
+				hash = MergeRound(hash, lane);
+		}
+		else
+			hash = seed + PRIME5;
+
+		hash += size;
+
+		for (; end - bytes >= 8; bytes += 8)
+			hash = RotateLeft(hash ^ Round(0, Read64(bytes)), 27) * PRIME1 + PRIME4;
+
+		if (end - bytes >= 4)
+		{
+			hash = RotateLeft(hash ^ Read32(bytes) * PRIME1, 23) * PRIME2 + PRIME3;
+			bytes += 4;
+		}
+
+		for (; bytes < end; bytes++)
+			hash = RotateLeft(hash ^ *bytes * PRIME5, 11) * PRIME1;
+
+		hash ^= hash >> 33;
+		hash *= PRIME2;
+		hash ^= hash >> 29;
+		hash *= PRIME3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::string ContentHash::ToString(const uint64_t hash)
+	{
+		static constexpr char digits[] = "0123456789abcdef";
+
+		std::string result(16, '0');
+
+		for (auto i = 0; i < 16; i++)
+			result[i] = digits[hash >> (60 - i * 4) & 0xF];
+
+		return result;
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	// XXH64, a fast non cryptographic 64 bit hash that tells contents apart, not a checksum
+	// against tampering. Runs at several gigabytes per second.
+	class ContentHash
+	{
+	public:
+		[[nodiscard]] static uint64_t Compute(const void* data, size_t size, uint64_t seed = 0);
+
+		// Sixteen lowercase hex digits
+		[[nodiscard]] static std::string ToString(uint64_t hash);
+	};
+}
@@ -0,0 +1,20 @@
+#include "ContentPath.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <filesystem>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	std::string ContentPath::Normalize(const std::string_view path)
+	{
+		// Backslashes are only separators to std::filesystem on Windows
+		std::string normalized(path);
+		std::replace(normalized.begin(), normalized.end(), '\\', '/');
+
+		return std::filesystem::path(normalized).lexically_normal().generic_string();
+	}
+}
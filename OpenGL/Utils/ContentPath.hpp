@@ -0,0 +1,20 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <string>
+#include <string_view>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	// Spelling of content paths used as keys, so every way of naming a file maps to one entry
+	class ContentPath
+	{
+	public:
+		// "Content/Textures/../Textures/a.png" and "Content\Textures\a.png" both become
+		// "Content/Textures/a.png", on every platform.
+		[[nodiscard]] static std::string Normalize(std::string_view path);
+	};
+}
@@ -0,0 +1,259 @@
+#include "CpuProfiler.hpp"
+
+//-------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	namespace
+	{
+		struct Event
+		{
+			const char* name;
+			int64_t beginTime;
+			int64_t endTime;
+		};
+
+		struct ThreadBuffer
+		{
+			unsigned threadId = 0;
+			std::string name;
+
+			// Capture the events belong to, a stale buffer is reset by its thread on the next record
+			std::atomic<uint64_t> capture{ 0 };
+			std::atomic<size_t> eventCount{ 0 };
+			std::unique_ptr<Event[]> events = std::make_unique<Event[]>(CpuProfiler::EVENTS_PER_THREAD);
+
+			// Cleared when the owning thread exits, guarded by the registry mutex
+			bool isInUse = true;
+		};
+
+		std::atomic<bool> isCapturing = false;
+		std::atomic<uint64_t> currentCapture = 0;
+		std::atomic<uint64_t> droppedEventCount = 0;
+		int64_t captureBeginTime = 0;
+
+		// Only taken when a thread records for the first time, when naming threads and when exporting
+		std::mutex registryMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+
+		// Hands the buffer back when its thread exits, so thread pools created later reuse it
+		struct ThreadBufferOwner
+		{
+			ThreadBuffer* buffer = nullptr;
+
+			~ThreadBufferOwner()
+			{
+				if (buffer == nullptr)
+					return;
+
+				std::lock_guard lock(registryMutex);
+				buffer->isInUse = false;
+			}
+		};
+
+		thread_local ThreadBufferOwner threadBufferOwner;
+
+		ThreadBuffer& GetThreadBuffer()
+		{
+			if (threadBufferOwner.buffer == nullptr)
+			{
+				std::lock_guard lock(registryMutex);
+
+				// A buffer holding events of the current capture keeps them until they are exported
+				const auto capture = currentCapture.load();
+				ThreadBuffer* buffer = nullptr;
+
+				for (const auto& candidate : threadBuffers)
+				{
+					if (!candidate->isInUse && (candidate->capture.load() != capture || candidate->eventCount.load() == 0))
+					{
+						buffer = candidate.get();
+						break;
+					}
+				}
+
+				if (buffer == nullptr)
+				{
+					buffer = threadBuffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+					buffer->threadId = static_cast<unsigned>(threadBuffers.size());
+				}
+
+				buffer->name = "Thread " + std::to_string(buffer->threadId);
+				buffer->eventCount = 0;
+				buffer->isInUse = true;
+
+				threadBufferOwner.buffer = buffer;
+			}
+
+			return *threadBufferOwner.buffer;
+		}
+
+		void WriteJsonString(std::ostream& stream, const char* text)
+		{
+			stream << '"';
+
+			for (; *text != '\0'; text++)
+			{
+				if (*text == '"' || *text == '\\')
+					stream << '\\';
+
+				stream << *text;
+			}
+
+			stream << '"';
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	bool CpuProfiler::GetIsCompiledIn()
+	{
+#ifdef ENABLE_CPU_PROFILER
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	//-------------------------------------------------------------------
+
+	void CpuProfiler::BeginCapture()
+	{
+		captureBeginTime = Now();
+		droppedEventCount = 0;
+		currentCapture++;
+		isCapturing = true;
+	}
+
+	//-------------------------------------------------------------------
+
+	void CpuProfiler::EndCapture()
+	{
+		isCapturing = false;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool CpuProfiler::GetIsCapturing()
+	{
+		return isCapturing.load(std::memory_order_relaxed);
+	}
+
+	//-------------------------------------------------------------------
+
+	uint64_t CpuProfiler::GetDroppedEventCount()
+	{
+		return droppedEventCount;
+	}
+
+	//-------------------------------------------------------------------
+
+	void CpuProfiler::SetThreadName(const char* name)
+	{
+		auto& buffer = GetThreadBuffer();
+
+		std::lock_guard lock(registryMutex);
+		buffer.name = name;
+	}
+
+	//-------------------------------------------------------------------
+
+	void CpuProfiler::Record(const char* name, const int64_t beginNanoseconds, const int64_t endNanoseconds)
+	{
+		if (!isCapturing.load(std::memory_order_relaxed))
+			return;
+
+		auto& buffer = GetThreadBuffer();
+
+		const auto capture = currentCapture.load(std::memory_order_relaxed);
+
+		if (buffer.capture.load(std::memory_order_relaxed) != capture)
+		{
+			buffer.eventCount.store(0, std::memory_order_relaxed);
+			buffer.capture.store(capture, std::memory_order_release);
+		}
+
+		const auto count = buffer.eventCount.load(std::memory_order_relaxed);
+
+		if (count == EVENTS_PER_THREAD)
+		{
+			droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer.events[count] = { name, beginNanoseconds, endNanoseconds };
+		buffer.eventCount.store(count + 1, std::memory_order_release);
+	}
+
+	//-------------------------------------------------------------------
+
+	void CpuProfiler::WriteChromeTrace(std::ostream& stream)
+	{
+		std::lock_guard lock(registryMutex);
+
+		const auto capture = currentCapture.load();
+
+		const auto flags = stream.flags();
+		const auto precision = stream.precision();
+
+		stream << std::fixed << std::setprecision(3);
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		auto isFirst = true;
+
+		const auto separate = [&stream, &isFirst]
+		{
+			stream << (isFirst ? "\n" : ",\n");
+			isFirst = false;
+		};
+
+		for (const auto& buffer : threadBuffers)
+		{
+			separate();
+			stream << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":";
+			WriteJsonString(stream, buffer->name.c_str());
+			stream << "}}";
+
+			// Buffers that recorded nothing during the capture still hold events of an older one
+			if (buffer->capture.load(std::memory_order_acquire) != capture)
+				continue;
+
+			const auto count = buffer->eventCount.load(std::memory_order_acquire);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const auto& event = buffer->events[i];
+
+				// Chrome traces are in microseconds
+				separate();
+				stream << "{\"ph\":\"X\",\"name\":";
+				WriteJsonString(stream, event.name);
+				stream << ",\"pid\":1,\"tid\":" << buffer->threadId
+					<< ",\"ts\":" << static_cast<double>(event.beginTime - captureBeginTime) * 1e-3
+					<< ",\"dur\":" << static_cast<double>(event.endTime - event.beginTime) * 1e-3 << "}";
+			}
+		}
+
+		stream << "\n]}" << std::endl;
+
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+
+	//-------------------------------------------------------------------
+
+	int64_t CpuProfiler::Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
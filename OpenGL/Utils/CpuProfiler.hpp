@@ -0,0 +1,74 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <ostream>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	// Records scoped CPU zones into one buffer per thread. A buffer is only ever written by
+	// its own thread and publishes events with an atomic count, so recording takes no locks.
+	// Zones are only recorded between BeginCapture and EndCapture, a full buffer drops events.
+	// Buffers of exited threads are handed to new threads once their events are out of date.
+	class CpuProfiler
+	{
+	public:
+		static constexpr size_t EVENTS_PER_THREAD = 1 << 16;
+
+		// Whether the zone macros record anything, they only do in builds defining ENABLE_CPU_PROFILER.
+		[[nodiscard]] static bool GetIsCompiledIn();
+
+		// Starts a new capture, events of the previous one are discarded.
+		static void BeginCapture();
+		static void EndCapture();
+
+		[[nodiscard]] static bool GetIsCapturing();
+		[[nodiscard]] static uint64_t GetDroppedEventCount();
+
+		// Names the calling thread in exported traces.
+		static void SetThreadName(const char* name);
+
+		static void Record(const char* name, int64_t beginNanoseconds, int64_t endNanoseconds);
+
+		// Writes the last capture in the Chrome trace event format, readable by chrome://tracing
+		// and Perfetto. Must not be called while capturing.
+		static void WriteChromeTrace(std::ostream& stream);
+
+		[[nodiscard]] static int64_t Now();
+	};
+
+	class CpuZone
+	{
+		const char* name;
+		int64_t beginTime;
+
+	public:
+		// The name must outlive the capture, string literals are the intended use.
+		explicit CpuZone(const char* name) : name(name), beginTime(CpuProfiler::Now()) {}
+		~CpuZone() { CpuProfiler::Record(name, beginTime, CpuProfiler::Now()); }
+
+		CpuZone(const CpuZone& other) = delete;
+		CpuZone& operator=(const CpuZone& other) = delete;
+		CpuZone(CpuZone&& other) = delete;
+		CpuZone& operator=(CpuZone&& other) = delete;
+	};
+}
+
+//-------------------------------------------------------------------
+
+// The macros compile to nothing unless ENABLE_CPU_PROFILER is defined, so instrumentation can
+// stay in hot paths of builds that do not profile.
+#ifdef ENABLE_CPU_PROFILER
+#define CPU_PROFILER_CONCAT_INNER(a, b) a##b
+#define CPU_PROFILER_CONCAT(a, b) CPU_PROFILER_CONCAT_INNER(a, b)
+#define CPU_ZONE(name) const Utils::CpuZone CPU_PROFILER_CONCAT(cpuZone, __LINE__)(name)
+#define CPU_FUNCTION_ZONE() CPU_ZONE(__FUNCTION__)
+#define CPU_THREAD_NAME(name) Utils::CpuProfiler::SetThreadName(name)
+#else
+#define CPU_ZONE(name) ((void)0)
+#define CPU_FUNCTION_ZONE() ((void)0)
+#define CPU_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,85 @@
+#include "FrameLimiter.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	FrameLimiter::FrameLimiter(const double targetFrameRate)
+		: frameDuration(0), nextFrameTime(Clock::Now())
+	{
+		SetTargetFrameRate(targetFrameRate);
+	}
+
+	//-------------------------------------------------------------------
+
+	void FrameLimiter::SetTargetFrameRate(const double targetFrameRate)
+	{
+		frameDuration = targetFrameRate > 0.0
+			? std::chrono::nanoseconds(static_cast<int64_t>(1e9 / targetFrameRate))
+			: std::chrono::nanoseconds(0);
+
+		nextFrameTime = Clock::Now() + frameDuration;
+	}
+
+	//-------------------------------------------------------------------
+
+	void FrameLimiter::Wait()
+	{
+		if (!GetIsEnabled())
+			return;
+
+		const auto now = Clock::Now();
+
+		// Fell more than a frame behind, start pacing again from now instead of
+		// rushing through the missed frames
+		if (now > nextFrameTime + frameDuration)
+			nextFrameTime = now;
+		else
+			PreciseSleepUntil(nextFrameTime);
+
+		nextFrameTime += frameDuration;
+	}
+
+	//-------------------------------------------------------------------
+
+	void FrameLimiter::PreciseSleepUntil(const Clock::TimePoint deadline)
+	{
+		using Milliseconds = std::chrono::duration<double, std::milli>;
+
+		auto remainingMs = Milliseconds(deadline - Clock::Now()).count();
+
+		while (remainingMs > sleepEstimateMs)
+		{
+			const auto sleepStart = Clock::Now();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			const auto sleptMs = Milliseconds(Clock::Now() - sleepStart).count();
+
+			remainingMs -= sleptMs;
+
+			sleepSamples++;
+			const auto delta = sleptMs - sleepMeanMs;
+			sleepMeanMs += delta / static_cast<double>(sleepSamples);
+			sleepM2 += delta * (sleptMs - sleepMeanMs);
+
+			const auto deviation = std::sqrt(sleepM2 / static_cast<double>(sleepSamples - 1));
+			sleepEstimateMs = sleepMeanMs + deviation;
+
+			// Keep adapting if the scheduler behaviour changes over a long session
+			if (sleepSamples > 1000)
+			{
+				sleepSamples = 1;
+				sleepMeanMs = sleepEstimateMs;
+				sleepM2 = 0.0;
+			}
+		}
+
+		while (Clock::Now() < deadline)
+			std::this_thread::yield();
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include "Clock.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	// Paces frames to a target rate. Most of the wait is spent sleeping, only the last
+	// stretch, sized from how much the OS has been oversleeping, is spent spinning.
+	class FrameLimiter
+	{
+		std::chrono::nanoseconds frameDuration;
+		Clock::TimePoint nextFrameTime;
+
+		// Running estimate of how long a 1 ms sleep really takes (Welford's algorithm)
+		double sleepEstimateMs = 5.0;
+		double sleepMeanMs = 5.0;
+		double sleepM2 = 0.0;
+		int64_t sleepSamples = 1;
+
+		void PreciseSleepUntil(Clock::TimePoint deadline);
+
+	public:
+		// A target frame rate of 0 or less disables limiting.
+		explicit FrameLimiter(double targetFrameRate = 0.0);
+
+		void SetTargetFrameRate(double targetFrameRate);
+
+		// Blocks until the next frame is due.
+		void Wait();
+
+		[[nodiscard]] bool GetIsEnabled() const { return frameDuration.count() > 0; }
+	};
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	struct LightData
+	{
+		glm::vec3 position;
+		glm::vec3 ambient;
+		glm::vec3 diffuse;
+		glm::vec3 specular;
+	};
+
+	// Everything the render thread needs to draw one frame. A packet is filled on the
+	// update thread and is not touched by it again until the render thread hands it back.
+	struct FramePacket
+	{
+		uint64_t frameIndex = 0;
+		std::chrono::steady_clock::time_point submitTime;
+
+		// Simulation time and how far the frame lies between the last two simulation steps
+		double elapsedTime = 0.0;
+		float interpolation = 1.0f;
+
+		glm::ivec2 framebufferSize = glm::ivec2(0);
+
+		// Time the update thread spent simulating and building this packet
+		float updateMs = 0.0f;
+		bool isOverlayVisible = false;
+
+		glm::mat4 view = glm::mat4(1.0f);
+		glm::mat4 projection = glm::mat4(1.0f);
+		glm::vec3 viewPosition = glm::vec3(0.0f);
+
+		std::vector<glm::mat4> transforms;
+		std::vector<LightData> lights;
+	};
+}
@@ -0,0 +1,220 @@
+#include "FramePipeline.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+
+//-------------------------------------------------------------------
+
+#include "CpuProfiler.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	FramePipeline::FramePipeline(const bool isThreaded, const size_t packetCount, Callback onRenderThreadStart,
+		RenderCallback renderFrame, Callback onRenderThreadStop)
+		: packets(isThreaded ? std::max<size_t>(packetCount, 2) : 1),
+		  onRenderThreadStart(std::move(onRenderThreadStart)),
+		  renderFrame(std::move(renderFrame)),
+		  onRenderThreadStop(std::move(onRenderThreadStop)),
+		  isThreaded(isThreaded)
+	{
+		for (size_t i = 0; i < packets.size(); i++)
+			freePackets.push(i);
+
+		if (isThreaded)
+			renderThread = std::thread(&FramePipeline::RenderLoop, this);
+	}
+
+	//-------------------------------------------------------------------
+
+	FramePipeline::~FramePipeline()
+	{
+		try
+		{
+			Stop();
+		}
+		catch (...)
+		{
+			// Already unwinding or the error was reported through Stop before
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	FramePacket& FramePipeline::BeginFrame()
+	{
+		CPU_ZONE("Wait for free packet");
+
+		std::unique_lock lock(mutex);
+
+		freeCondition.wait(lock, [this] { return !freePackets.empty() || renderError != nullptr; });
+
+		RethrowRenderError();
+
+		writePacket = freePackets.front();
+		freePackets.pop();
+
+		return packets[writePacket];
+	}
+
+	//-------------------------------------------------------------------
+
+	void FramePipeline::SubmitFrame()
+	{
+		auto& packet = packets[writePacket];
+
+		packet.frameIndex = nextFrameIndex++;
+		packet.submitTime = std::chrono::steady_clock::now();
+
+		if (packet.frameIndex == 0)
+		{
+			std::lock_guard lock(mutex);
+			firstSubmitTime = packet.submitTime;
+		}
+
+		if (!isThreaded)
+		{
+			RenderPacket(packet);
+			freePackets.push(writePacket);
+			return;
+		}
+
+		{
+			std::lock_guard lock(mutex);
+			readyPackets.push(writePacket);
+		}
+
+		readyCondition.notify_one();
+	}
+
+	//-------------------------------------------------------------------
+
+	void FramePipeline::Stop()
+	{
+		if (!renderThread.joinable())
+			return;
+
+		{
+			std::lock_guard lock(mutex);
+			isStopping = true;
+		}
+
+		readyCondition.notify_one();
+		renderThread.join();
+
+		std::lock_guard lock(mutex);
+		RethrowRenderError();
+	}
+
+	//-------------------------------------------------------------------
+
+	FramePipelineStats FramePipeline::GetStats()
+	{
+		std::lock_guard lock(mutex);
+
+		FramePipelineStats stats;
+		stats.framesRendered = framesRendered;
+		stats.maxLatencyMs = maxLatencyMs;
+
+		if (framesRendered == 0)
+			return stats;
+
+		stats.averageLatencyMs = totalLatencyMs / static_cast<double>(framesRendered);
+
+		const std::chrono::duration<double> elapsed = lastCompleteTime - firstSubmitTime;
+
+		if (elapsed.count() > 0.0)
+			stats.framesPerSecond = static_cast<double>(framesRendered) / elapsed.count();
+
+		return stats;
+	}
+
+	//-------------------------------------------------------------------
+
+	void FramePipeline::RenderLoop()
+	{
+		CPU_THREAD_NAME("Render");
+
+		try
+		{
+			onRenderThreadStart();
+
+			while (true)
+			{
+				size_t index;
+
+				{
+					std::unique_lock lock(mutex);
+					readyCondition.wait(lock, [this] { return isStopping || !readyPackets.empty(); });
+
+					if (readyPackets.empty())
+						break;
+
+					index = readyPackets.front();
+					readyPackets.pop();
+				}
+
+				RenderPacket(packets[index]);
+
+				{
+					std::lock_guard lock(mutex);
+					freePackets.push(index);
+				}
+
+				freeCondition.notify_one();
+			}
+
+			onRenderThreadStop();
+		}
+		catch (...)
+		{
+			{
+				std::lock_guard lock(mutex);
+				renderError = std::current_exception();
+			}
+
+			freeCondition.notify_one();
+
+			try
+			{
+				onRenderThreadStop();
+			}
+			catch (...)
+			{
+				// The first error is the one worth reporting
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void FramePipeline::RenderPacket(const FramePacket& packet)
+	{
+		renderFrame(packet);
+
+		const auto completeTime = std::chrono::steady_clock::now();
+		const std::chrono::duration<double, std::milli> latency = completeTime - packet.submitTime;
+
+		std::lock_guard lock(mutex);
+
+		framesRendered++;
+		totalLatencyMs += latency.count();
+		maxLatencyMs = std::max(maxLatencyMs, latency.count());
+		lastCompleteTime = completeTime;
+	}
+
+	//-------------------------------------------------------------------
+
+	void FramePipeline::RethrowRenderError()
+	{
+		if (renderError == nullptr)
+			return;
+
+		const auto error = renderError;
+		renderError = nullptr;
+
+		std::rethrow_exception(error);
+	}
+}
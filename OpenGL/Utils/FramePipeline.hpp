@@ -0,0 +1,86 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+#include "FramePacket.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	struct FramePipelineStats
+	{
+		uint64_t framesRendered = 0;
+		double averageLatencyMs = 0.0;
+		double maxLatencyMs = 0.0;
+		double framesPerSecond = 0.0;
+	};
+
+	// Hands frame packets from the update thread to a render thread that owns the GL context.
+	// With N packets the update thread can run up to N - 1 frames ahead of the one being
+	// submitted, so 2 gives classic double buffering. When threading is disabled every
+	// packet is rendered on the submitting thread as soon as it is submitted.
+	class FramePipeline
+	{
+		using Callback = std::function<void()>;
+		using RenderCallback = std::function<void(const FramePacket&)>;
+
+		std::vector<FramePacket> packets;
+		std::queue<size_t> freePackets;
+		std::queue<size_t> readyPackets;
+		size_t writePacket = 0;
+
+		Callback onRenderThreadStart;
+		RenderCallback renderFrame;
+		Callback onRenderThreadStop;
+
+		const bool isThreaded;
+		bool isStopping = false;
+		uint64_t nextFrameIndex = 0;
+
+		std::thread renderThread;
+		std::mutex mutex;
+		std::condition_variable freeCondition;
+		std::condition_variable readyCondition;
+		std::exception_ptr renderError;
+
+		uint64_t framesRendered = 0;
+		double totalLatencyMs = 0.0;
+		double maxLatencyMs = 0.0;
+		std::chrono::steady_clock::time_point firstSubmitTime;
+		std::chrono::steady_clock::time_point lastCompleteTime;
+
+		void RenderLoop();
+		void RenderPacket(const FramePacket& packet);
+		void RethrowRenderError();
+
+	public:
+		FramePipeline(bool isThreaded, size_t packetCount, Callback onRenderThreadStart,
+			RenderCallback renderFrame, Callback onRenderThreadStop);
+		FramePipeline(const FramePipeline& other) = delete;
+		FramePipeline& operator=(const FramePipeline& other) = delete;
+		FramePipeline(FramePipeline&& other) = delete;
+		FramePipeline& operator=(FramePipeline&& other) = delete;
+		~FramePipeline();
+
+		// Blocks until a packet is free and returns it for the caller to fill.
+		FramePacket& BeginFrame();
+		void SubmitFrame();
+
+		// Renders every packet already submitted and joins the render thread.
+		void Stop();
+
+		[[nodiscard]] FramePipelineStats GetStats();
+		[[nodiscard]] bool GetIsThreaded() const { return isThreaded; }
+	};
+}
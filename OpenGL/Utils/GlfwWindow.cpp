@@ -0,0 +1,269 @@
+#include "GlfwWindow.hpp"
+
+//-------------------------------------------------------------------
+
+#include <stdexcept>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+//-------------------------------------------------------------------
+
+#include "../Applications/IApplication.hpp"
+#include "../Graphics/GLExtensions.hpp"
+#include "StartupTimer.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	GlfwWindow::GlfwWindow(const char* title, int width, int height)
+	{
+		if (width <= 0)
+			throw std::runtime_error("Screen width must be a positive integer.");
+
+		if (height <= 0)
+			throw std::runtime_error("Screen height must be a positive integer.");
+
+		{
+			const StartupPhase phase("Initialize GLFW");
+
+			if (glfwInit() != GLFW_TRUE)
+				throw std::runtime_error("Failed to initialize GLFW.");
+		}
+
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+		glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GetIsDebugContextEnabled() ? GLFW_TRUE : GLFW_FALSE);
+
+		{
+			const StartupPhase phase("Create window and context");
+			window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+		}
+
+		if (window == nullptr)
+		{
+			glfwTerminate();
+			throw std::runtime_error("Failed to create GLFW window");
+		}
+
+		MakeContextCurrent();
+
+		const StartupPhase phase("Load GL entry points");
+
+		if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+		{
+			glfwTerminate();
+			throw std::runtime_error("Failed to initialize GLAD");
+		}
+
+		Graphics::GLExtensions::Load((GLADloadproc)glfwGetProcAddress);
+
+		glViewport(0, 0, width, height);
+	}
+
+	//-------------------------------------------------------------------
+
+	GlfwWindow::~GlfwWindow()
+	{
+		glfwTerminate();
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::MakeContextCurrent() const
+	{
+		glfwMakeContextCurrent(window);
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::ReleaseContext() const
+	{
+		glfwMakeContextCurrent(nullptr);
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::SwapBuffers() const
+	{
+		glfwSwapBuffers(window);
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::SetSwapInterval(const int interval) const
+	{
+		// Applies to the context current on the calling thread
+		glfwSwapInterval(interval);
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::PollEvents()
+	{
+		glfwPollEvents();
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::ActivateInputFor(Applications::IApplication* app) const
+	{
+		glfwSetWindowUserPointer(window, app);
+
+		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+		glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
+		glfwSetKeyCallback(window, KeyCallback);
+		glfwSetMouseButtonCallback(window, MouseButtonCallback);
+		glfwSetCursorPosCallback(window, CursorPosCallback);
+		glfwSetScrollCallback(window, ScrollCallback);
+	}
+
+	//-------------------------------------------------------------------
+
+	bool GlfwWindow::GetShouldClose() const
+	{
+		return glfwWindowShouldClose(window);
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::SetShouldClose(bool value) const
+	{
+		glfwSetWindowShouldClose(window, value);
+	}
+
+	//-------------------------------------------------------------------
+
+	double GlfwWindow::GetElapsedTime() const
+	{
+		return glfwGetTime();
+	}
+
+	//-------------------------------------------------------------------
+
+	glm::vec2 GlfwWindow::GetSize() const
+	{
+		int width = 0;
+		int height = 0;
+		glfwGetWindowSize(window, &width, &height);
+		return glm::vec2(width, height);
+	}
+
+	//-------------------------------------------------------------------
+
+	glm::ivec2 GlfwWindow::GetFramebufferSize() const
+	{
+		int width = 0;
+		int height = 0;
+		glfwGetFramebufferSize(window, &width, &height);
+		return glm::ivec2(width, height);
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::FramebufferSizeCallback(GLFWwindow* window, const int width, const int height)
+	{
+		// The context may be owned by the render thread, which sets the viewport from the frame packet instead
+		if (glfwGetCurrentContext() == window)
+			glViewport(0, 0, width, height);
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::KeyCallback(GLFWwindow* window, int key, int scanCode, int action, int mods)
+	{
+		const auto userDataPointer = glfwGetWindowUserPointer(window);
+
+		if (userDataPointer == nullptr)
+			throw GetUserPointerNullException();
+
+		const auto app = static_cast<Applications::IApplication*>(userDataPointer);
+		const auto ourKey = static_cast<Input::Keys>(key);
+
+		switch (action)
+		{
+		case GLFW_PRESS:
+		case GLFW_REPEAT:
+		{
+			app->GetInputManager().PressKey(ourKey);
+			break;
+		}
+		case GLFW_RELEASE:
+		{
+			app->GetInputManager().ReleaseKey(ourKey);
+		}
+		default:
+			break;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::CursorPosCallback(GLFWwindow* window, double x, double y)
+	{
+		const auto userDataPointer = glfwGetWindowUserPointer(window);
+
+		if (userDataPointer == nullptr)
+			throw GetUserPointerNullException();
+
+		const auto app = static_cast<Applications::IApplication*>(userDataPointer);
+
+		app->GetInputManager().SetCursorPosition(static_cast<float>(x), static_cast<float>(y));
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+	{
+		const auto userDataPointer = glfwGetWindowUserPointer(window);
+
+		if (userDataPointer == nullptr)
+			throw GetUserPointerNullException();
+
+		const auto app = static_cast<Applications::IApplication*>(userDataPointer);
+		const auto ourButton = static_cast<Input::MouseButtons>(button);
+
+		switch (action)
+		{
+		case GLFW_PRESS:
+		case GLFW_REPEAT:
+		{
+			app->GetInputManager().PressButton(ourButton);
+			break;
+		}
+		case GLFW_RELEASE:
+		{
+			app->GetInputManager().ReleaseButton(ourButton);
+		}
+		default:
+			break;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void GlfwWindow::ScrollCallback(GLFWwindow* window, double x, double y)
+	{
+		const auto userDataPointer = glfwGetWindowUserPointer(window);
+
+		if (userDataPointer == nullptr)
+			throw GetUserPointerNullException();
+
+		const auto app = static_cast<Applications::IApplication*>(userDataPointer);
+
+		app->GetInputManager().Scroll(static_cast<float>(y));
+	}
+
+	//-------------------------------------------------------------------
+
+	std::runtime_error GlfwWindow::GetUserPointerNullException()
+	{
+		return std::runtime_error("GLFW user data pointer cannot be null.");
+	}
+
+	//-------------------------------------------------------------------
+
+}
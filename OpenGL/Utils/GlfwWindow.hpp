@@ -0,0 +1,47 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <stdexcept>
+
+//-------------------------------------------------------------------
+
+#include "Window.hpp"
+
+//-------------------------------------------------------------------
+
+struct GLFWwindow;
+
+namespace Utils
+{
+	class GlfwWindow : public Window
+	{
+		GLFWwindow* window;
+
+		static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
+		static void KeyCallback(GLFWwindow* window, int key, int scanCode, int action, int mods);
+		static void CursorPosCallback(GLFWwindow* window, double x, double y);
+		static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+		static void ScrollCallback(GLFWwindow* window, double x, double y);
+
+		static std::runtime_error GetUserPointerNullException();
+	
+	public:
+		GlfwWindow(const char* title, int width, int height);
+		~GlfwWindow() override;
+
+		void MakeContextCurrent() const override;
+		void ReleaseContext() const override;
+		void SwapBuffers() const override;
+		void SetSwapInterval(int interval) const override;
+		void PollEvents() override;
+		void ActivateInputFor(Applications::IApplication* app) const override;
+
+		[[nodiscard]] bool GetShouldClose() const override;
+		void SetShouldClose(bool value) const override;
+
+		[[nodiscard]] double GetElapsedTime() const override;
+		[[nodiscard]] glm::vec2 GetSize() const override;
+		[[nodiscard]] glm::ivec2 GetFramebufferSize() const override;
+	};
+}
@@ -0,0 +1,289 @@
+#include "HeadlessWindow.hpp"
+
+//-------------------------------------------------------------------
+
+#include <stdexcept>
+#include <glad/glad.h>
+
+#ifdef _WIN32
+#include <GLFW/glfw3.h>
+#else
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+//-------------------------------------------------------------------
+
+#include "../Graphics/GLDebug.hpp"
+#include "../Graphics/GLExtensions.hpp"
+#include "../Graphics/GpuMemoryTracker.hpp"
+#include "StartupTimer.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+#ifdef _WIN32
+	struct HeadlessWindow::Context
+	{
+		GLFWwindow* window = nullptr;
+	};
+#else
+	struct HeadlessWindow::Context
+	{
+		EGLDisplay display = EGL_NO_DISPLAY;
+		EGLContext context = EGL_NO_CONTEXT;
+	};
+#endif
+
+	//-------------------------------------------------------------------
+
+	HeadlessWindow::HeadlessWindow(const int width, const int height)
+		: context(std::make_unique<Context>()), size(width, height)
+	{
+		if (width <= 0)
+			throw std::runtime_error("Screen width must be a positive integer.");
+
+		if (height <= 0)
+			throw std::runtime_error("Screen height must be a positive integer.");
+
+		{
+			const StartupPhase phase("Create context");
+			CreateContext();
+		}
+
+		{
+			const StartupPhase phase("Create offscreen framebuffer");
+			CreateFramebuffer();
+		}
+
+		glViewport(0, 0, width, height);
+	}
+
+	//-------------------------------------------------------------------
+
+	HeadlessWindow::~HeadlessWindow()
+	{
+		DeleteFramebuffer();
+		DestroyContext();
+	}
+
+	//-------------------------------------------------------------------
+
+#ifdef _WIN32
+
+	void HeadlessWindow::CreateContext()
+	{
+		if (glfwInit() != GLFW_TRUE)
+			throw std::runtime_error("Failed to initialize GLFW.");
+
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GetIsDebugContextEnabled() ? GLFW_TRUE : GLFW_FALSE);
+
+		// Only provides the context, everything is drawn into the offscreen framebuffer
+		context->window = glfwCreateWindow(1, 1, "", nullptr, nullptr);
+
+		if (context->window == nullptr)
+		{
+			glfwTerminate();
+			throw std::runtime_error("Failed to create hidden GLFW window");
+		}
+
+		MakeContextCurrent();
+
+		if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+		{
+			glfwTerminate();
+			throw std::runtime_error("Failed to initialize GLAD");
+		}
+
+		Graphics::GLExtensions::Load((GLADloadproc)glfwGetProcAddress);
+	}
+
+	//-------------------------------------------------------------------
+
+	void HeadlessWindow::DestroyContext()
+	{
+		glfwTerminate();
+	}
+
+	//-------------------------------------------------------------------
+
+	void HeadlessWindow::MakeContextCurrent() const
+	{
+		glfwMakeContextCurrent(context->window);
+	}
+
+	//-------------------------------------------------------------------
+
+	void HeadlessWindow::ReleaseContext() const
+	{
+		glfwMakeContextCurrent(nullptr);
+	}
+
+#else
+
+	void HeadlessWindow::CreateContext()
+	{
+		// Prefer Mesa's surfaceless platform, it needs neither a display server nor a GPU
+		const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+			eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+		if (getPlatformDisplay != nullptr)
+			context->display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+		if (context->display == EGL_NO_DISPLAY)
+			context->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+		if (context->display == EGL_NO_DISPLAY || eglInitialize(context->display, nullptr, nullptr) != EGL_TRUE)
+			throw std::runtime_error("Failed to initialize EGL.");
+
+		if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE)
+		{
+			DestroyContext();
+			throw std::runtime_error("EGL does not support desktop OpenGL.");
+		}
+
+		// No surface will ever be created, so any surface type will do (the default asks for windows)
+		constexpr EGLint configAttributes[] =
+		{
+			EGL_SURFACE_TYPE, 0,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_NONE
+		};
+
+		EGLConfig config;
+		EGLint configCount = 0;
+
+		if (eglChooseConfig(context->display, configAttributes, &config, 1, &configCount) != EGL_TRUE || configCount == 0)
+		{
+			DestroyContext();
+			throw std::runtime_error("Failed to choose an EGL config.");
+		}
+
+		const EGLint contextAttributes[] =
+		{
+			EGL_CONTEXT_MAJOR_VERSION, 3,
+			EGL_CONTEXT_MINOR_VERSION, 3,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_CONTEXT_OPENGL_DEBUG, GetIsDebugContextEnabled() ? EGL_TRUE : EGL_FALSE,
+			EGL_NONE
+		};
+
+		context->context = eglCreateContext(context->display, config, EGL_NO_CONTEXT, contextAttributes);
+
+		if (context->context == EGL_NO_CONTEXT)
+		{
+			DestroyContext();
+			throw std::runtime_error("Failed to create EGL context");
+		}
+
+		MakeContextCurrent();
+
+		if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+		{
+			DestroyContext();
+			throw std::runtime_error("Failed to initialize GLAD");
+		}
+
+		Graphics::GLExtensions::Load((GLADloadproc)eglGetProcAddress);
+	}
+
+	//-------------------------------------------------------------------
+
+	void HeadlessWindow::DestroyContext()
+	{
+		if (context->display == EGL_NO_DISPLAY)
+			return;
+
+		eglMakeCurrent(context->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+		if (context->context != EGL_NO_CONTEXT)
+			eglDestroyContext(context->display, context->context);
+
+		eglTerminate(context->display);
+
+		context->context = EGL_NO_CONTEXT;
+		context->display = EGL_NO_DISPLAY;
+	}
+
+	//-------------------------------------------------------------------
+
+	void HeadlessWindow::MakeContextCurrent() const
+	{
+		// Surfaceless, the offscreen framebuffer is the only render target
+		if (eglMakeCurrent(context->display, EGL_NO_SURFACE, EGL_NO_SURFACE, context->context) != EGL_TRUE)
+			throw std::runtime_error("Failed to make the EGL context current.");
+	}
+
+	//-------------------------------------------------------------------
+
+	void HeadlessWindow::ReleaseContext() const
+	{
+		eglMakeCurrent(context->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	}
+
+#endif
+
+	//-------------------------------------------------------------------
+
+	void HeadlessWindow::CreateFramebuffer()
+	{
+		glGenRenderbuffers(1, &colorBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size.x, size.y);
+
+		glGenRenderbuffers(1, &depthBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, size.x, size.y);
+
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		Graphics::GLDebug::SetObjectLabel(GL_RENDERBUFFER, colorBuffer, "headless color buffer");
+		Graphics::GLDebug::SetObjectLabel(GL_RENDERBUFFER, depthBuffer, "headless depth buffer");
+
+		// RGBA8 and DEPTH24_STENCIL8 both take four bytes per pixel
+		const auto bufferSize = static_cast<uint64_t>(size.x) * size.y * 4;
+
+		Graphics::GpuMemoryTracker::Register(Graphics::GpuMemoryCategory::RENDER_TARGET, colorBuffer, bufferSize, "headless color buffer");
+		Graphics::GpuMemoryTracker::Register(Graphics::GpuMemoryCategory::RENDER_TARGET, depthBuffer, bufferSize, "headless depth buffer");
+
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+		Graphics::GLDebug::SetObjectLabel(GL_FRAMEBUFFER, framebuffer, "headless framebuffer");
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			DeleteFramebuffer();
+			DestroyContext();
+			throw std::runtime_error("Offscreen framebuffer is incomplete.");
+		}
+
+		// Stays bound for the lifetime of the window, nothing else ever binds a framebuffer
+	}
+
+	//-------------------------------------------------------------------
+
+	void HeadlessWindow::DeleteFramebuffer()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		Graphics::GpuMemoryTracker::Unregister(Graphics::GpuMemoryCategory::RENDER_TARGET, colorBuffer);
+		Graphics::GpuMemoryTracker::Unregister(Graphics::GpuMemoryCategory::RENDER_TARGET, depthBuffer);
+
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(1, &colorBuffer);
+		glDeleteRenderbuffers(1, &depthBuffer);
+
+		framebuffer = 0;
+		colorBuffer = 0;
+		depthBuffer = 0;
+	}
+}
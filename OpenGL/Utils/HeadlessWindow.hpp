@@ -0,0 +1,55 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include "Clock.hpp"
+#include "Window.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	// Renders into an offscreen framebuffer of a fixed size without any visible surface.
+	// Uses a surfaceless EGL context, which Mesa serves with llvmpipe on hosts without a GPU,
+	// and a hidden GLFW window on Windows where EGL is not available.
+	class HeadlessWindow : public Window
+	{
+		struct Context;
+
+		std::unique_ptr<Context> context;
+		glm::ivec2 size;
+
+		unsigned framebuffer = 0;
+		unsigned colorBuffer = 0;
+		unsigned depthBuffer = 0;
+
+		mutable bool shouldClose = false;
+		Clock clock;
+
+		void CreateContext();
+		void DestroyContext();
+		void CreateFramebuffer();
+		void DeleteFramebuffer();
+
+	public:
+		static constexpr int DESKTOP_WIDTH = 1920;
+		static constexpr int DESKTOP_HEIGHT = 1080;
+
+		HeadlessWindow(int width, int height);
+		~HeadlessWindow() override;
+
+		void MakeContextCurrent() const override;
+		void ReleaseContext() const override;
+		void SwapBuffers() const override {}
+		void SetSwapInterval(int) const override {}
+		void PollEvents() override {}
+		void ActivateInputFor(Applications::IApplication*) const override {}
+
+		[[nodiscard]] bool GetShouldClose() const override { return shouldClose; }
+		void SetShouldClose(const bool value) const override { shouldClose = value; }
+
+		[[nodiscard]] double GetElapsedTime() const override { return clock.GetElapsedSeconds(); }
+		[[nodiscard]] glm::vec2 GetSize() const override { return glm::vec2(size); }
+		[[nodiscard]] glm::ivec2 GetFramebufferSize() const override { return size; }
+	};
+}
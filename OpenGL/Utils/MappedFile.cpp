@@ -0,0 +1,92 @@
+#include "MappedFile.hpp"
+
+//-------------------------------------------------------------------
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	MappedFile::~MappedFile()
+	{
+#ifdef _WIN32
+		if (data != nullptr)
+			UnmapViewOfFile(data);
+
+		if (mapping != nullptr)
+			CloseHandle(mapping);
+
+		if (file != nullptr)
+			CloseHandle(file);
+#else
+		if (data != nullptr)
+			munmap(const_cast<unsigned char*>(data), size);
+
+		if (file >= 0)
+			close(file);
+#endif
+	}
+
+	//-------------------------------------------------------------------
+
+	std::shared_ptr<const MappedFile> MappedFile::Open(const std::string& path)
+	{
+		std::shared_ptr<MappedFile> result(new MappedFile());
+
+#ifdef _WIN32
+		const auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+			return nullptr;
+
+		result->file = file;
+
+		LARGE_INTEGER size;
+
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+			return nullptr;
+
+		result->size = static_cast<size_t>(size.QuadPart);
+		result->mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (result->mapping == nullptr)
+			return nullptr;
+
+		result->data = static_cast<const unsigned char*>(MapViewOfFile(result->mapping, FILE_MAP_READ, 0, 0, 0));
+
+		if (result->data == nullptr)
+			return nullptr;
+#else
+		result->file = open(path.c_str(), O_RDONLY);
+
+		if (result->file < 0)
+			return nullptr;
+
+		struct stat status {};
+
+		if (fstat(result->file, &status) != 0 || status.st_size == 0)
+			return nullptr;
+
+		const auto data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, result->file, 0);
+
+		if (data == MAP_FAILED)
+			return nullptr;
+
+		result->data = static_cast<const unsigned char*>(data);
+		result->size = static_cast<size_t>(status.st_size);
+#endif
+
+		return result;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	// A whole file mapped read only into memory. Pages are read in by the OS on first access and
+	// shared with every other mapping of the file, so nothing is copied until it is used.
+	class MappedFile
+	{
+#ifdef _WIN32
+		void* file = nullptr;
+		void* mapping = nullptr;
+#else
+		int file = -1;
+#endif
+
+		const unsigned char* data = nullptr;
+		size_t size = 0;
+
+		MappedFile() = default;
+
+	public:
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+		MappedFile(MappedFile&& other) = delete;
+		MappedFile& operator=(MappedFile&& other) = delete;
+		~MappedFile();
+
+		// Returns null when the file does not exist, is empty or cannot be mapped.
+		[[nodiscard]] static std::shared_ptr<const MappedFile> Open(const std::string& path);
+
+		[[nodiscard]] const unsigned char* GetData() const { return data; }
+		[[nodiscard]] size_t GetSize() const { return size; }
+
+		// Shares ownership of the mapping, which stays alive as long as any such pointer does.
+		[[nodiscard]] static std::shared_ptr<const unsigned char> GetPointer(const std::shared_ptr<const MappedFile>& file, size_t offset)
+		{
+			return { file, file->data + offset };
+		}
+	};
+}
@@ -0,0 +1,223 @@
+#include "StartupTimer.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <ctime>
+#endif
+
+//-------------------------------------------------------------------
+
+#include <atomic>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+//-------------------------------------------------------------------
+
+#include "Clock.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	namespace
+	{
+		constexpr auto NO_PHASE = std::numeric_limits<size_t>::max();
+
+		struct PhaseRecord
+		{
+			StartupPhaseTiming timing;
+			int64_t cpuStart = 0;
+		};
+
+		std::mutex mutex;
+
+		Clock startupClock;
+		std::atomic<bool> isRunning = false;
+		std::thread::id startThread;
+		double timeToFirstFrameMs = 0.0;
+
+		std::vector<PhaseRecord> phases;
+
+		// Phases nest per thread, a worker's phases start at the top level
+		thread_local int depth = 0;
+
+		double ToMilliseconds(const int64_t nanoseconds)
+		{
+			return static_cast<double>(nanoseconds) * 1e-6;
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void StartupTimer::Start()
+	{
+		const std::lock_guard lock(mutex);
+
+		phases.clear();
+		timeToFirstFrameMs = 0.0;
+		startThread = std::this_thread::get_id();
+		startupClock.Restart();
+		isRunning = true;
+	}
+
+	//-------------------------------------------------------------------
+
+	void StartupTimer::MarkFirstFrame()
+	{
+		// Called every frame, only the first call needs the lock
+		if (!isRunning.load(std::memory_order_relaxed))
+			return;
+
+		const std::lock_guard lock(mutex);
+
+		if (!isRunning)
+			return;
+
+		timeToFirstFrameMs = ToMilliseconds(startupClock.GetElapsedNanoseconds());
+		isRunning = false;
+	}
+
+	//-------------------------------------------------------------------
+
+	bool StartupTimer::GetIsRunning()
+	{
+		return isRunning;
+	}
+
+	//-------------------------------------------------------------------
+
+	double StartupTimer::GetTimeToFirstFrameMs()
+	{
+		const std::lock_guard lock(mutex);
+		return timeToFirstFrameMs;
+	}
+
+	//-------------------------------------------------------------------
+
+	std::vector<StartupPhaseTiming> StartupTimer::GetPhases()
+	{
+		const std::lock_guard lock(mutex);
+
+		std::vector<StartupPhaseTiming> result;
+		result.reserve(phases.size());
+
+		for (const auto& phase : phases)
+			result.push_back(phase.timing);
+
+		return result;
+	}
+
+	//-------------------------------------------------------------------
+
+	void StartupTimer::PrintReport(std::ostream& stream)
+	{
+		const auto timings = GetPhases();
+		const auto total = GetTimeToFirstFrameMs();
+
+		if (total <= 0.0)
+			return;
+
+		const auto flags = stream.flags();
+		const auto precision = stream.precision();
+
+		stream << std::fixed << std::setprecision(1)
+			<< "Startup took " << total << " ms to the first frame" << std::endl
+			<< "      wall ms     cpu ms   share  phase" << std::endl;
+
+		auto attributedMs = 0.0;
+
+		for (const auto& timing : timings)
+		{
+			stream << std::setw(13) << timing.wallMs << std::setw(11) << timing.cpuMs
+				<< std::setw(7) << timing.wallMs / total * 100.0 << "%  "
+				<< std::string(static_cast<size_t>(timing.depth) * 2, ' ')
+				<< (timing.isOnWorker ? "[worker] " : "") << timing.name << std::endl;
+
+			if (timing.depth == 0 && !timing.isOnWorker)
+				attributedMs += timing.wallMs;
+		}
+
+		// Includes the first frame itself and GL work the driver deferred until then
+		if (total > attributedMs)
+			stream << std::setw(13) << total - attributedMs << std::setw(11) << "" << std::setw(7)
+				<< (total - attributedMs) / total * 100.0 << "%  (outside any phase)" << std::endl;
+
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+
+	//-------------------------------------------------------------------
+
+	int64_t StartupTimer::GetProcessCpuNanoseconds()
+	{
+#ifdef _WIN32
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+
+		if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+			return 0;
+
+		const auto toTicks = [](const FILETIME& time)
+		{
+			return static_cast<int64_t>(time.dwHighDateTime) << 32 | time.dwLowDateTime;
+		};
+
+		// FILETIME counts 100 ns ticks
+		return (toTicks(kernelTime) + toTicks(userTime)) * 100;
+#else
+		timespec time{};
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+
+		return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+#endif
+	}
+
+	//-------------------------------------------------------------------
+
+	size_t StartupTimer::BeginPhase(std::string name)
+	{
+		const auto cpuStart = GetProcessCpuNanoseconds();
+
+		const std::lock_guard lock(mutex);
+
+		if (!isRunning)
+			return NO_PHASE;
+
+		PhaseRecord record;
+		record.timing.name = std::move(name);
+		record.timing.depth = depth++;
+		record.timing.isOnWorker = std::this_thread::get_id() != startThread;
+		record.timing.startMs = ToMilliseconds(startupClock.GetElapsedNanoseconds());
+		record.cpuStart = cpuStart;
+
+		phases.push_back(std::move(record));
+
+		return phases.size() - 1;
+	}
+
+	//-------------------------------------------------------------------
+
+	void StartupTimer::EndPhase(const size_t phase)
+	{
+		if (phase == NO_PHASE)
+			return;
+
+		const auto cpuEnd = GetProcessCpuNanoseconds();
+
+		const std::lock_guard lock(mutex);
+
+		depth--;
+
+		// Start may have cleared the phases in the meantime
+		if (phase >= phases.size())
+			return;
+
+		auto& record = phases[phase];
+		record.timing.wallMs = ToMilliseconds(startupClock.GetElapsedNanoseconds()) - record.timing.startMs;
+		record.timing.cpuMs = ToMilliseconds(cpuEnd - record.cpuStart);
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	struct StartupPhaseTiming
+	{
+		std::string name;
+
+		// Nesting level, phases of level n + 1 run inside the preceding phase of level n
+		int depth = 0;
+
+		double startMs = 0.0;
+		double wallMs = 0.0;
+
+		// Process time, includes every thread, so it exceeds wallMs when work runs in parallel
+		// and falls behind it while waiting on the driver or the disk
+		double cpuMs = 0.0;
+
+		// Ran on a thread other than the one that called Start, overlapping the phases there
+		bool isOnWorker = false;
+	};
+
+	// Splits the time from Start to the first presented frame into named, possibly nested phases.
+	// Phases begun after the first frame are ignored, so resources created later cost nothing.
+	class StartupTimer
+	{
+	public:
+		// Marks the beginning of startup, called first thing in main.
+		static void Start();
+
+		// Ends startup, only the first call has an effect.
+		static void MarkFirstFrame();
+
+		[[nodiscard]] static bool GetIsRunning();
+		[[nodiscard]] static double GetTimeToFirstFrameMs();
+		[[nodiscard]] static std::vector<StartupPhaseTiming> GetPhases();
+
+		static void PrintReport(std::ostream& stream);
+
+		// Process CPU time consumed so far.
+		[[nodiscard]] static int64_t GetProcessCpuNanoseconds();
+
+		static size_t BeginPhase(std::string name);
+		static void EndPhase(size_t phase);
+	};
+
+	class StartupPhase
+	{
+		size_t phase;
+
+	public:
+		explicit StartupPhase(std::string name) : phase(StartupTimer::BeginPhase(std::move(name))) {}
+		~StartupPhase() { StartupTimer::EndPhase(phase); }
+
+		StartupPhase(const StartupPhase& other) = delete;
+		StartupPhase& operator=(const StartupPhase& other) = delete;
+		StartupPhase(StartupPhase&& other) = delete;
+		StartupPhase& operator=(StartupPhase&& other) = delete;
+	};
+}
@@ -0,0 +1,123 @@
+#include "ThreadPool.hpp"
+
+//-------------------------------------------------------------------
+
+#include <algorithm>
+
+//-------------------------------------------------------------------
+
+#include "CpuProfiler.hpp"
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	ThreadPool::ThreadPool(unsigned threadCount)
+	{
+		// hardware_concurrency is allowed to report 0 when it cannot tell
+		threadCount = std::max(threadCount, 1u);
+
+		workers.reserve(threadCount);
+
+		for (auto i = 0u; i < threadCount; i++)
+			workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+
+	//-------------------------------------------------------------------
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(mutex);
+			isStopping = true;
+		}
+
+		condition.notify_all();
+
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	//-------------------------------------------------------------------
+
+	void ThreadPool::WorkerLoop()
+	{
+		CPU_THREAD_NAME("Worker");
+
+		while (true)
+		{
+			std::function<void()> task;
+
+			{
+				std::unique_lock lock(mutex);
+				condition.wait(lock, [this] { return isStopping || !tasks.empty(); });
+
+				if (isStopping && tasks.empty())
+					return;
+
+				task = std::move(tasks.front());
+				tasks.pop();
+			}
+
+			task();
+		}
+	}
+
+	//-------------------------------------------------------------------
+
+	void ThreadPool::ParallelFor(const size_t count, const std::function<void(size_t chunk, size_t begin, size_t end)>& body)
+	{
+		if (count == 0)
+			return;
+
+		const auto chunkCount = std::min<size_t>(count, workers.size() + 1);
+		const auto chunkSize = (count + chunkCount - 1) / chunkCount;
+
+		std::vector<std::future<void>> pending;
+		pending.reserve(chunkCount - 1);
+
+		for (size_t chunk = 1; chunk < chunkCount; chunk++)
+		{
+			const auto begin = chunk * chunkSize;
+			const auto end = std::min(begin + chunkSize, count);
+
+			if (begin >= end)
+				break;
+
+			pending.push_back(Enqueue([&body, chunk, begin, end]
+			{
+				CPU_ZONE("ParallelFor chunk");
+				body(chunk, begin, end);
+			}));
+		}
+
+		// Every chunk must finish before returning since they all reference body
+		std::exception_ptr error;
+
+		try
+		{
+			CPU_ZONE("ParallelFor chunk");
+			body(0, 0, std::min(chunkSize, count));
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+
+		for (auto& future : pending)
+		{
+			try
+			{
+				future.get();
+			}
+			catch (...)
+			{
+				if (!error)
+					error = std::current_exception();
+			}
+		}
+
+		if (error)
+			std::rethrow_exception(error);
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+//-------------------------------------------------------------------
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//-------------------------------------------------------------------
+
+namespace Utils
+{
+	class ThreadPool
+	{
+		std::vector<std::thread> workers;
+		std::queue<std::function<void()>> tasks;
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool isStopping = false;
+
+		void WorkerLoop();
+
+	public:
+		explicit ThreadPool(unsigned threadCount = std::thread::hardware_concurrency());
+		ThreadPool(const ThreadPool& other) = delete;
+		ThreadPool& operator=(const ThreadPool& other) = delete;
+		ThreadPool(ThreadPool&& other) = delete;
+		ThreadPool& operator=(ThreadPool&& other) = delete;
+		~ThreadPool();
+
+		template <typename Function>
+		std::future<std::invoke_result_t<Function>> Enqueue(Function&& function)
+		{
+			using Result = std::invoke_result_t<Function>;
+
+			auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+			auto future = task->get_future();
+
+			{
+				std::lock_guard lock(mutex);
+				tasks.emplace([task] { (*task)(); });
+			}
+
+			condition.notify_one();
+
+			return future;
+		}
+
+		// Splits [0, count) into at most one chunk per worker plus one for the calling thread
+		// and blocks until every chunk has run. The chunk index passed to the body is stable
+		// for a given count and thread count, so it can be used to order the results.
+		void ParallelFor(size_t count, const std::function<void(size_t chunk, size_t begin, size_t end)>& body);
+
+		[[nodiscard]] unsigned GetThreadCount() const { return static_cast<unsigned>(workers.size()); }
+	};
+}
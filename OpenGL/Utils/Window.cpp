@@ -2,226 +2,81 @@
 
 //-------------------------------------------------------------------
 
-#include <glad/glad.h>
+#include <stdexcept>
 #include <GLFW/glfw3.h>
 
 //-------------------------------------------------------------------
 
-#include "../Applications/IApplication.hpp"
+#include "GlfwWindow.hpp"
+#include "HeadlessWindow.hpp"
+#include "StartupTimer.hpp"
 
 //-------------------------------------------------------------------
 
 namespace Utils
 {
-	Window::Window(const char* title, int width, int height)
+	namespace
 	{
-		if (width <= 0)
-			throw std::exception("Screen width must be a positive integer.");
-
-		if (height <= 0)
-			throw std::exception("Screen height must be a positive integer.");
-
-		if (glfwInit() != GLFW_TRUE)
-			throw std::exception("Failed to initialize GLFW.");
-
-		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-
-		window = glfwCreateWindow(width, height, "LearnOpenGL", nullptr, nullptr);
-
-		if (window == nullptr)
-		{
-			glfwTerminate();
-			throw std::exception("Failed to create GLFW window");
-		}
-
-		InitOpenGL();
-
-		if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-		{
-			glfwTerminate();
-			throw std::exception("Failed to initialize GLAD");
-		}
-
-		glViewport(0, 0, width, height);
-	}
-
-	//-------------------------------------------------------------------
-
-	Window::~Window()
-	{
-		glfwTerminate();
-	}
-
-	//-------------------------------------------------------------------
-
-	void Window::InitOpenGL() const
-	{
-		glfwMakeContextCurrent(window);
-	}
-
-	//-------------------------------------------------------------------
-
-	void Window::SwapBuffers() const
-	{
-		glfwSwapBuffers(window);
-	}
-
-	//-------------------------------------------------------------------
-
-	void Window::PollEvents()
-	{
-		glfwPollEvents();
-	}
-
-	//-------------------------------------------------------------------
-
-	void Window::ActivateInputFor(Applications::IApplication* app) const
-	{
-		glfwSetWindowUserPointer(window, app);
-
-		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-		glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
-		glfwSetKeyCallback(window, KeyCallback);
-		glfwSetMouseButtonCallback(window, MouseButtonCallback);
-		glfwSetCursorPosCallback(window, CursorPosCallback);
-		glfwSetScrollCallback(window, ScrollCallback);
-	}
-
-	//-------------------------------------------------------------------
-
-	bool Window::GetShouldClose() const
-	{
-		return glfwWindowShouldClose(window);
-	}
-
-	//-------------------------------------------------------------------
-
-	void Window::SetShouldClose(bool value) const
-	{
-		glfwSetWindowShouldClose(window, value);
-	}
-
-	//-------------------------------------------------------------------
-
-	float Window::GetElapsedTime() const
-	{
-		return static_cast<float>(glfwGetTime());
+		bool isDebugContextEnabled = false;
 	}
 
 	//-------------------------------------------------------------------
 
-	glm::vec2 Window::GetSize() const
+	std::unique_ptr<Window> Window::Create(const WindowBackend backend, const char* title, const int width, const int height)
 	{
-		int width = 0;
-		int height = 0;
-		glfwGetWindowSize(window, &width, &height);
-		return glm::vec2(width, height);
-	}
-
-	//-------------------------------------------------------------------
+		const StartupPhase phase("Create window");
 
-	void Window::FramebufferSizeCallback(GLFWwindow* window, const int width, const int height)
-	{
-		glViewport(0, 0, width, height);
-	}
-
-	//-------------------------------------------------------------------
-
-	void Window::KeyCallback(GLFWwindow* window, int key, int scanCode, int action, int mods)
-	{
-		const auto userDataPointer = glfwGetWindowUserPointer(window);
-
-		if (userDataPointer == nullptr)
-			throw GetUserPointerNullException();
-
-		const auto app = static_cast<Applications::IApplication*>(userDataPointer);
-		const auto ourKey = static_cast<Input::Keys>(key);
-
-		switch (action)
-		{
-		case GLFW_PRESS:
-		case GLFW_REPEAT:
-		{
-			app->GetInputManager().PressKey(ourKey);
-			break;
-		}
-		case GLFW_RELEASE:
+		switch (backend)
 		{
-			app->GetInputManager().ReleaseKey(ourKey);
-		}
-		default:
-			break;
+		case WindowBackend::GLFW:
+#ifdef DISABLE_GLFW_WINDOW
+			(void)title;
+			throw std::runtime_error("This build has no GLFW window backend, only the headless one.");
+#else
+			return std::make_unique<GlfwWindow>(title, width, height);
+#endif
+		case WindowBackend::HEADLESS:
+			return std::make_unique<HeadlessWindow>(width, height);
 		}
-	}
-
-	//-------------------------------------------------------------------
-
-	void Window::CursorPosCallback(GLFWwindow* window, double x, double y)
-	{
-		const auto userDataPointer = glfwGetWindowUserPointer(window);
-
-		if (userDataPointer == nullptr)
-			throw GetUserPointerNullException();
-
-		const auto app = static_cast<Applications::IApplication*>(userDataPointer);
 
-		app->GetInputManager().SetCursorPosition(static_cast<float>(x), static_cast<float>(y));
+		throw std::runtime_error("Unhandled window backend.");
 	}
 
 	//-------------------------------------------------------------------
 
-	void Window::MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+	glm::ivec2 Window::GetDesktopSize(const WindowBackend backend)
 	{
-		const auto userDataPointer = glfwGetWindowUserPointer(window);
+		if (backend == WindowBackend::HEADLESS)
+			return glm::ivec2(HeadlessWindow::DESKTOP_WIDTH, HeadlessWindow::DESKTOP_HEIGHT);
 
-		if (userDataPointer == nullptr)
-			throw GetUserPointerNullException();
+#ifdef DISABLE_GLFW_WINDOW
+		throw std::runtime_error("This build has no GLFW window backend, only the headless one.");
+#else
+		// Safe to call repeatedly, the window created afterwards keeps GLFW initialized
+		if (glfwInit() != GLFW_TRUE)
+			throw std::runtime_error("Failed to initialize GLFW.");
 
-		const auto app = static_cast<Applications::IApplication*>(userDataPointer);
-		const auto ourButton = static_cast<Input::MouseButtons>(button);
+		const auto monitor = glfwGetPrimaryMonitor();
+		const auto videoMode = monitor != nullptr ? glfwGetVideoMode(monitor) : nullptr;
 
-		switch (action)
-		{
-		case GLFW_PRESS:
-		case GLFW_REPEAT:
-		{
-			app->GetInputManager().PressButton(ourButton);
-			break;
-		}
-		case GLFW_RELEASE:
-		{
-			app->GetInputManager().ReleaseButton(ourButton);
-		}
-		default:
-			break;
-		}
+		if (videoMode == nullptr)
+			throw std::runtime_error("Failed to query the primary monitor video mode.");
+
+		return glm::ivec2(videoMode->width, videoMode->height);
+#endif
 	}
 
 	//-------------------------------------------------------------------
 
-	void Window::ScrollCallback(GLFWwindow* window, double x, double y)
+	void Window::SetIsDebugContextEnabled(const bool value)
 	{
-		const auto userDataPointer = glfwGetWindowUserPointer(window);
-
-		if (userDataPointer == nullptr)
-			throw GetUserPointerNullException();
-
-		const auto app = static_cast<Applications::IApplication*>(userDataPointer);
-
-		app->GetInputManager().Scroll(static_cast<float>(y));
+		isDebugContextEnabled = value;
 	}
 
 	//-------------------------------------------------------------------
 
-	std::exception Window::GetUserPointerNullException()
+	bool Window::GetIsDebugContextEnabled()
 	{
-		return std::exception("GLFW user data pointer cannot be null.");
+		return isDebugContextEnabled;
 	}
-
-	//-------------------------------------------------------------------
-
 }
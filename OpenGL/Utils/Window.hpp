@@ -3,6 +3,7 @@
 //-------------------------------------------------------------------
 
 #include <exception>
+#include <memory>
 #include <glm/glm.hpp>
 
 //-------------------------------------------------------------------
@@ -12,39 +13,48 @@ namespace Applications
 	class IApplication;
 }
 
-struct GLFWwindow;
-
 namespace Utils
 {
-	class Window
+	enum class WindowBackend
 	{
-		GLFWwindow* window;
+		GLFW,
+		HEADLESS
+	};
 
-		static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
-		static void KeyCallback(GLFWwindow* window, int key, int scanCode, int action, int mods);
-		static void CursorPosCallback(GLFWwindow* window, double x, double y);
-		static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
-		static void ScrollCallback(GLFWwindow* window, double x, double y);
+	class Window
+	{
+	protected:
+		Window() = default;
 
-		static std::exception GetUserPointerNullException();
-	
 	public:
-		Window(const char* title, int width, int height);
+		virtual ~Window() = default;
 		Window(const Window& other) = delete;
 		Window& operator=(const Window& other) = delete;
 		Window(Window&& other) = delete;
 		Window& operator=(Window&& other) = delete;
-		~Window();
 
-		void InitOpenGL() const;
-		void SwapBuffers() const;
-		void PollEvents();
-		void ActivateInputFor(Applications::IApplication* app) const;
+		static std::unique_ptr<Window> Create(WindowBackend backend, const char* title, int width, int height);
+
+		// Size of the primary display, or of the virtual one when running headless.
+		[[nodiscard]] static glm::ivec2 GetDesktopSize(WindowBackend backend);
+
+		// Requests a debug context from windows created afterwards, drivers then report
+		// errors and performance warnings through Graphics::GLDebug at some cost in speed.
+		static void SetIsDebugContextEnabled(bool value);
+		[[nodiscard]] static bool GetIsDebugContextEnabled();
+
+		virtual void MakeContextCurrent() const = 0;
+		virtual void ReleaseContext() const = 0;
+		virtual void SwapBuffers() const = 0;
+		virtual void SetSwapInterval(int interval) const = 0;
+		virtual void PollEvents() = 0;
+		virtual void ActivateInputFor(Applications::IApplication* app) const = 0;
 
-		[[nodiscard]] bool GetShouldClose() const;
-		void SetShouldClose(bool value) const;
+		[[nodiscard]] virtual bool GetShouldClose() const = 0;
+		virtual void SetShouldClose(bool value) const = 0;
 
-		[[nodiscard]] float GetElapsedTime() const;
-		[[nodiscard]] glm::vec2 GetSize() const;
+		[[nodiscard]] virtual double GetElapsedTime() const = 0;
+		[[nodiscard]] virtual glm::vec2 GetSize() const = 0;
+		[[nodiscard]] virtual glm::ivec2 GetFramebufferSize() const = 0;
 	};
 }